@@ -40,9 +40,16 @@ G3D::Vector3 ApproximationEdge::GetPoint (size_t i) const
     return m_points[i];
 }
 
+size_t ApproximationEdge::GetMemorySize () const
+{
+    return Edge::GetMemorySize () + 
+	sizeof (ApproximationEdge) - sizeof (Edge) +
+	m_points.capacity () * sizeof (G3D::Vector3);
+}
+
 boost::shared_ptr<Edge> ApproximationEdge::createDuplicate (
     const OOBox& originalDomain,
-    const G3D::Vector3& newBegin, VertexSet* vertexSet) const
+    const G3D::Vector3& newBegin, VertexHashSet* vertexSet) const
 {
     G3D::Vector3int16 translation = originalDomain.GetTranslation (
 	GetBeginVector (), newBegin);
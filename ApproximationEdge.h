@@ -25,6 +25,7 @@ public:
 	ElementStatus::Enum duplicateStatus = ElementStatus::ORIGINAL);
     virtual size_t GetPointCount () const;
     virtual G3D::Vector3 GetPoint (size_t i) const;
+    virtual size_t GetMemorySize () const;
     void SetPoint (size_t i, const G3D::Vector3& p)
     {
 	m_points[i] = p;
@@ -34,7 +35,7 @@ protected:
     ApproximationEdge (const ApproximationEdge& approximationEdge);
     virtual boost::shared_ptr<Edge> createDuplicate (
 	const OOBox& originalDomain,
-	const G3D::Vector3& newBegin, VertexSet* vertexSet) const;
+	const G3D::Vector3& newBegin, VertexHashSet* vertexSet) const;
 
 
 protected:
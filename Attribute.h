@@ -70,7 +70,7 @@ public:
     {
         return INTEGER;
     }
-    operator int()
+    operator int() const
     {
 	return m_value;
     }
@@ -112,7 +112,7 @@ public:
         return REAL;
     }
 
-    operator double ()
+    operator double () const
     {
 	return m_value;
     }
@@ -158,7 +158,7 @@ public:
      * Get the color of the attribute
      * @return color value of the attribute
      */
-    operator Color::Enum ()
+    operator Color::Enum () const
     {
 	return m_color;
     }
@@ -209,7 +209,7 @@ public:
         return INTEGER_ARRAY;
     }
 
-    operator const vector<int> ()
+    operator const vector<int> () const
     {
 	return *m_values;
     }
@@ -228,6 +228,7 @@ private:
 class RealArrayAttribute : public Attribute
 {
 public:
+    typedef const vector<double> value_type;
     /**
      * Constructs an attribute that stores an array of reals
      * @param values pointer to an array of reals.
@@ -248,6 +249,11 @@ public:
         return REAL_ARRAY;
     }
 
+    operator const vector<double> () const
+    {
+	return *m_values;
+    }
+
 private:
     boost::shared_ptr< vector<double> > m_values;
 };
@@ -312,6 +318,8 @@ private:
 
     static AttributeArrayAttribute* newArray (vector<size_t>* dimensions,
 					      size_t currentDimensionIndex);
+    friend class FoamSnapshot;
+
 private:
     /**
      * Pointer to a vector of attributes which are either values or vectors
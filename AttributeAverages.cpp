@@ -89,6 +89,15 @@ void AttributeAverages::AverageRelease ()
     CALL_IF_NOT_NULL(m_t1KDE,AverageRelease) ();
 }
 
+void AttributeAverages::GetMemoryUsage (MemoryUsage* usage) const
+{
+    m_scalarAverage->GetMemoryUsage (usage);
+    m_forceAverage->GetMemoryUsage (usage);
+    CALL_IF_NOT_NULL(m_velocityAverage,GetMemoryUsage) (usage);
+    CALL_IF_NOT_NULL(m_deformationAverage,GetMemoryUsage) (usage);
+    CALL_IF_NOT_NULL(m_t1KDE,GetMemoryUsage) (usage);
+}
+
 
 
 void AttributeAverages::AverageStep (int direction, size_t timeWindow)
@@ -16,6 +16,7 @@ class Average;
 class DerivedData;
 class Foam;
 class ForceAverage;
+class MemoryUsage;
 class Settings;
 class Simulation;
 class SimulationGroup;
@@ -55,6 +56,10 @@ public:
 	G3D::Vector2 rotationCenter = G3D::Vector2::zero (), 
 	float angleDegrees = 0) const;
     virtual void AverageRelease ();
+    /**
+     * Adds the textures or regular grids used by all averages in the view
+     */
+    void GetMemoryUsage (MemoryUsage* usage) const;
 
 
 protected:
@@ -105,6 +105,10 @@ public:
      * @return name of the attribute
      */
     const char* GetAttributeName (size_t index) const;
+    const NameInfoMap& GetNameInfo () const
+    {
+	return m_nameInfo;
+    }
     string ToString () const;
 
 private:
@@ -0,0 +1,105 @@
+/**
+ * @file   AttributeValues.cpp
+ * @author Dan R. Lipsa
+ *
+ * Definitions for the AttributeValues class.
+ */
+
+#include "Attribute.h"
+#include "AttributeValues.h"
+#include "Debug.h"
+#include "Utils.h"
+
+
+// Members: AttributeValues
+// ======================================================================
+
+const AttributeValues::Type AttributeValues::NONE = Attribute::COUNT;
+
+AttributeValues::Slot::Slot () :
+    m_type (NONE)
+{
+    m_value.m_real = 0;
+}
+
+AttributeValues::Slot& AttributeValues::slot (size_t i, Type type)
+{
+    resizeAllowIndex (&m_slots, i);
+    Slot& s = m_slots[i];
+    s.m_type = type;
+    return s;
+}
+
+void AttributeValues::SetInteger (size_t i, int value)
+{
+    slot (i, Attribute::INTEGER).m_value.m_integer = value;
+}
+
+void AttributeValues::SetReal (size_t i, double value)
+{
+    slot (i, Attribute::REAL).m_value.m_real = value;
+}
+
+void AttributeValues::SetColor (size_t i, Color::Enum value)
+{
+    slot (i, Attribute::COLOR).m_value.m_color = value;
+}
+
+void AttributeValues::SetArray (
+    size_t i, const boost::shared_ptr<Attribute>& array)
+{
+    slot (i, array->GetType ()).m_array = array;
+}
+
+void AttributeValues::Set (size_t i, Attribute* attribute)
+{
+    auto_ptr<Attribute> a (attribute);
+    switch (a->GetType ())
+    {
+    case Attribute::INTEGER:
+	SetInteger (i, static_cast<const IntegerAttribute&> (*a));
+	break;
+    case Attribute::REAL:
+	SetReal (i, static_cast<const RealAttribute&> (*a));
+	break;
+    case Attribute::COLOR:
+	SetColor (i, static_cast<const ColorAttribute&> (*a));
+	break;
+    case Attribute::INTEGER_ARRAY:
+    case Attribute::REAL_ARRAY:
+    case Attribute::ATTRIBUTE_ARRAY:
+	SetArray (i, boost::shared_ptr<Attribute> (a.release ()));
+	break;
+    default:
+	ThrowException ("Invalid attribute type: ", a->GetType ());
+    }
+}
+
+void AttributeValues::Resize (size_t size)
+{
+    m_slots.resize (size);
+}
+
+ostream& AttributeValues::Print (ostream& ostr, size_t i) const
+{
+    switch (GetType (i))
+    {
+    case Attribute::INTEGER:
+	return ostr << GetInteger (i);
+    case Attribute::REAL:
+	return ostr << GetReal (i);
+    case Attribute::COLOR:
+	return ostr << GetColor (i);
+    default:
+	return GetArray (i)->Print (ostr);
+    }
+}
+
+size_t AttributeValues::GetMemorySize () const
+{
+    size_t size = m_slots.capacity () * sizeof (Slot);
+    BOOST_FOREACH (const Slot& s, m_slots)
+	if (s.m_array)
+	    size += sizeof (*s.m_array);
+    return size;
+}
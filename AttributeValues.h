@@ -0,0 +1,120 @@
+/**
+ * @file AttributeValues.h
+ * @author Dan R. Lipsa
+ * @brief Values of the attributes of a vertex, edge, face or body.
+ * @ingroup data model
+ */
+#ifndef __ATTRIBUTE_VALUES_H__
+#define __ATTRIBUTE_VALUES_H__
+
+#include "ParsingEnums.h"
+class Attribute;
+
+/**
+ * @brief Values of the attributes of a vertex, edge, face or body.
+ *
+ * Integer, real and color attributes are stored by value, next to
+ * their type, in one array indexed by the attribute index, so reading
+ * them does not need a virtual call or following a pointer. Arrays
+ * are stored as Attribute objects and they are shared with copies of
+ * the element, as before.
+ */
+class AttributeValues
+{
+public:
+    /**
+     * Type of each attribute, COUNT if the attribute is not set
+     */
+    typedef unsigned char Type;
+
+public:
+    bool IsEmpty () const
+    {
+	return m_slots.empty ();
+    }
+    size_t size () const
+    {
+	return m_slots.size ();
+    }
+    bool Has (size_t i) const
+    {
+	return i < m_slots.size () && m_slots[i].m_type != NONE;
+    }
+    /**
+     * @return the Attribute::Type of attribute i
+     */
+    Type GetType (size_t i) const
+    {
+	return m_slots[i].m_type;
+    }
+
+    int GetInteger (size_t i) const
+    {
+	return m_slots[i].m_value.m_integer;
+    }
+    double GetReal (size_t i) const
+    {
+	return m_slots[i].m_value.m_real;
+    }
+    Color::Enum GetColor (size_t i) const
+    {
+	return m_slots[i].m_value.m_color;
+    }
+    /**
+     * @return INTEGER_ARRAY, REAL_ARRAY or ATTRIBUTE_ARRAY attribute i
+     */
+    const boost::shared_ptr<Attribute>& GetArray (size_t i) const
+    {
+	return m_slots[i].m_array;
+    }
+
+    void SetInteger (size_t i, int value);
+    void SetReal (size_t i, double value);
+    void SetColor (size_t i, Color::Enum value);
+    void SetArray (size_t i, const boost::shared_ptr<Attribute>& array);
+    /**
+     * Stores the value of an attribute.
+     * @param attribute of any type, deleted if its value is copied
+     */
+    void Set (size_t i, Attribute* attribute);
+    void Resize (size_t size);
+
+    ostream& Print (ostream& ostr, size_t i) const;
+    /**
+     * @return bytes allocated for the values. For arrays only the
+     *         Attribute object is included.
+     */
+    size_t GetMemorySize () const;
+
+private:
+    static const Type NONE;
+
+    union Value
+    {
+	int m_integer;
+	double m_real;
+	Color::Enum m_color;
+    };
+
+    struct Slot
+    {
+	Slot ();
+
+	Type m_type;
+	Value m_value;
+	boost::shared_ptr<Attribute> m_array;
+    };
+
+private:
+    Slot& slot (size_t i, Type type);
+
+private:
+    vector<Slot> m_slots;
+};
+
+
+#endif //__ATTRIBUTE_VALUES_H__
+
+// Local Variables:
+// mode: c++
+// End:
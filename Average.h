@@ -15,6 +15,7 @@
 
 class DerivedData;
 class Foam;
+class MemoryUsage;
 class Settings;
 class Simulation;
 class SimulationGroup;
@@ -46,6 +47,13 @@ public:
     G3D::Vector3 GetTranslation () const;
 
     virtual ViewNumber::Enum GetViewNumber () const;
+    /**
+     * Adds the textures or regular grids used by this average
+     */
+    virtual void GetMemoryUsage (MemoryUsage* usage) const
+    {
+	(void)usage;
+    }
 
 
 protected:
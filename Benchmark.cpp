@@ -0,0 +1,202 @@
+/**
+ * @file   Benchmark.cpp
+ * @author Dan R. Lipsa
+ *
+ * Definitions for the Benchmark and BenchmarkPhase classes.
+ */
+
+#include "Benchmark.h"
+
+
+// Private Functions
+// ======================================================================
+
+namespace
+{
+string jsonString (const string& s)
+{
+    ostringstream ostr;
+    ostr << '"';
+    BOOST_FOREACH (char c, s)
+    {
+	if (c == '"' || c == '\\')
+	    ostr << '\\' << c;
+	else if (static_cast<unsigned char> (c) < 0x20)
+	    ostr << "\\u" << hex << setw (4) << setfill ('0') << int (c)
+		 << dec << setfill (' ');
+	else
+	    ostr << c;
+    }
+    ostr << '"';
+    return ostr.str ();
+}
+}
+
+
+// Members: Benchmark
+// ======================================================================
+
+Benchmark::Benchmark () :
+    m_enabled (false),
+    m_memoryReported (false)
+{
+}
+
+Benchmark& Benchmark::Get ()
+{
+    static Benchmark benchmark;
+    return benchmark;
+}
+
+void Benchmark::SetEnabled (bool enabled)
+{
+    m_enabled = enabled;
+    if (enabled)
+	m_timer.start ();
+}
+
+void Benchmark::Add (const char* name, Type type,
+		     double wallMs, double cpuMs, qint64 bytes,
+		     long peakRssKb, long rssDeltaKb)
+{
+    QMutexLocker locker (&m_mutex);
+    pair<map<string, size_t>::iterator, bool> inserted = 
+	m_phaseIndex.insert (make_pair (string (name), m_phases.size ()));
+    if (inserted.second)
+    {
+	Phase phase = {name, type, 0, 0, 0, 0, 0, 0};
+	m_phases.push_back (phase);
+    }
+    Phase& p = m_phases[inserted.first->second];
+    ++p.m_calls;
+    p.m_wallMs += wallMs;
+    p.m_cpuMs += cpuMs;
+    p.m_bytes += bytes;
+    p.m_peakRssKb = max (p.m_peakRssKb, peakRssKb);
+    p.m_rssDeltaKb += rssDeltaKb;
+}
+
+void Benchmark::AddSimulation (const string& name, size_t timeSteps)
+{
+    QMutexLocker locker (&m_mutex);
+    m_simulations.push_back (pair<string, size_t> (name, timeSteps));
+}
+
+string Benchmark::ToJson () const
+{
+    QMutexLocker locker (&m_mutex);
+    ostringstream ostr;
+    ostr << fixed << setprecision (3);
+    ostr << "{\"wall_ms\": " << double (m_timer.elapsed ())
+	 << ", \"cpu_ms\": " << GetCpuMs (SERIAL)
+	 << ", \"peak_rss_kb\": " << GetPeakRssKb ()
+	 << ", \"simulations\": [";
+    for (size_t i = 0; i < m_simulations.size (); ++i)
+	ostr << (i == 0 ? "" : ", ")
+	     << "{\"name\": " << jsonString (m_simulations[i].first)
+	     << ", \"time_steps\": " << m_simulations[i].second << "}";
+    ostr << "], \"phases\": [";
+    for (size_t i = 0; i < m_phases.size (); ++i)
+    {
+	const Phase& p = m_phases[i];
+	double mbPerS = (p.m_wallMs == 0) ? 0 :
+	    p.m_bytes / (1024.0 * 1024.0) / (p.m_wallMs / 1000.0);
+	ostr << (i == 0 ? "" : ", ")
+	     << "{\"name\": " << jsonString (p.m_name)
+	     << ", \"per_time_step\": "
+	     << (p.m_type == PER_TIME_STEP ? "true" : "false")
+	     << ", \"calls\": " << p.m_calls
+	     << ", \"wall_ms\": " << p.m_wallMs
+	     << ", \"cpu_ms\": " << p.m_cpuMs
+	     << ", \"bytes\": " << p.m_bytes
+	     << ", \"mb_per_s\": " << mbPerS
+	     << ", \"peak_rss_kb\": " << p.m_peakRssKb
+	     << ", \"rss_delta_kb\": " << p.m_rssDeltaKb << "}";
+    }
+    ostr << "]}";
+    return ostr.str ();
+}
+
+ostream& Benchmark::PrintRss (ostream& ostr) const
+{
+    QMutexLocker locker (&m_mutex);
+    BOOST_FOREACH (const Phase& p, m_phases)
+	ostr << p.m_name << ": peak " << p.m_peakRssKb << " KB, change "
+	     << showpos << p.m_rssDeltaKb << noshowpos << " KB" << endl;
+    return ostr << "peak: " << GetPeakRssKb () << " KB" << endl;
+}
+
+double Benchmark::GetCpuMs (Type type)
+{
+#if defined (CLOCK_THREAD_CPUTIME_ID)
+    if (type == PER_TIME_STEP)
+    {
+	struct timespec t;
+	clock_gettime (CLOCK_THREAD_CPUTIME_ID, &t);
+	return t.tv_sec * 1000.0 + t.tv_nsec / 1000000.0;
+    }
+#else
+    (void)type;
+#endif
+    return clock () * 1000.0 / CLOCKS_PER_SEC;
+}
+
+long Benchmark::GetPeakRssKb ()
+{
+#ifdef _MSC_VER
+    return 0;
+#else //_MSC_VER
+    struct rusage usage;
+    if (getrusage (RUSAGE_SELF, &usage) != 0)
+	return 0;
+#ifdef __APPLE__
+    // bytes on Mac OS X, KB on Linux
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+#endif //_MSC_VER
+}
+
+long Benchmark::GetRssKb ()
+{
+#ifdef __linux__
+    // size and resident set size in pages
+    ifstream statm ("/proc/self/statm");
+    long size, resident;
+    if (statm >> size >> resident)
+	return resident * (sysconf (_SC_PAGESIZE) / 1024);
+#endif //__linux__
+    return 0;
+}
+
+
+// Members: BenchmarkPhase
+// ======================================================================
+
+BenchmarkPhase::BenchmarkPhase (
+    const char* name, Benchmark::Type type, qint64 bytes) :
+    m_name (name),
+    m_type (type),
+    m_bytes (bytes),
+    m_recording (Benchmark::Get ().IsRecording ()),
+    m_cpuMs (0),
+    m_rssKb (0)
+{
+    if (! m_recording)
+	return;
+    m_cpuMs = Benchmark::GetCpuMs (type);
+    m_rssKb = Benchmark::GetRssKb ();
+    m_timer.start ();
+}
+
+BenchmarkPhase::~BenchmarkPhase ()
+{
+    if (! m_recording)
+	return;
+    double wallMs = m_timer.nsecsElapsed () / 1000000.0;
+    Benchmark::Get ().Add (m_name, m_type, wallMs,
+			   Benchmark::GetCpuMs (m_type) - m_cpuMs, m_bytes,
+			   Benchmark::GetPeakRssKb (),
+			   Benchmark::GetRssKb () - m_rssKb);
+}
@@ -0,0 +1,141 @@
+/**
+ * @file   Benchmark.h
+ * @author Dan R. Lipsa
+ * @brief Collects timings for the phases of loading a simulation.
+ * @ingroup utils
+ */
+
+#ifndef __BENCHMARK_H__
+#define __BENCHMARK_H__
+
+/**
+ * @brief Collects timings for the phases of loading a simulation.
+ *
+ * For each phase it records the number of calls, the wall-clock and
+ * CPU time, the bytes processed, the peak resident set size of the
+ * process at the end of the phase and the change in resident set
+ * size. A SERIAL phase runs once on the main thread and its CPU time
+ * includes all threads. A PER_TIME_STEP phase runs once for each time
+ * step, possibly in parallel, its times and its change in resident
+ * set size are summed over all calls, its peak resident set size is
+ * the maximum over all calls and its CPU time is the time of the
+ * calling thread. The change in resident set size of a phase that
+ * runs in parallel with others includes their allocations too, the
+ * peak is the high-water mark reached by the end of the phase. Phases
+ * are recorded only if timings are reported as JSON (@see
+ * SetEnabled) or if the memory used is reported (@see
+ * SetMemoryReported), otherwise a phase costs a test.
+ */
+class Benchmark
+{
+public:
+    enum Type
+    {
+	SERIAL,
+	PER_TIME_STEP
+    };
+
+public:
+    static Benchmark& Get ();
+    bool IsEnabled () const
+    {
+	return m_enabled;
+    }
+    void SetEnabled (bool enabled);
+    void SetMemoryReported (bool memoryReported)
+    {
+	m_memoryReported = memoryReported;
+    }
+    bool IsRecording () const
+    {
+	return m_enabled || m_memoryReported;
+    }
+    void Add (const char* name, Type type,
+	      double wallMs, double cpuMs, qint64 bytes,
+	      long peakRssKb, long rssDeltaKb);
+    void AddSimulation (const string& name, size_t timeSteps);
+    /**
+     * @return the timings as one line of JSON
+     */
+    string ToJson () const;
+    /**
+     * Prints the peak resident set size and the change in resident
+     * set size of each phase, in the order the phases were first
+     * seen, and the peak resident set size of the process.
+     */
+    ostream& PrintRss (ostream& ostr) const;
+    /**
+     * @return CPU time in ms used by the process (SERIAL) or by the
+     *         calling thread (PER_TIME_STEP)
+     */
+    static double GetCpuMs (Type type);
+    /**
+     * @return the peak resident set size of the process in KB
+     */
+    static long GetPeakRssKb ();
+    /**
+     * @return the resident set size of the process in KB, or 0 where
+     *         it is not available (Linux only)
+     */
+    static long GetRssKb ();
+
+private:
+    struct Phase
+    {
+	string m_name;
+	Type m_type;
+	size_t m_calls;
+	double m_wallMs;
+	double m_cpuMs;
+	qint64 m_bytes;
+	long m_peakRssKb;
+	long m_rssDeltaKb;
+    };
+
+private:
+    Benchmark ();
+
+private:
+    bool m_enabled;
+    bool m_memoryReported;
+    vector<Phase> m_phases;
+    /**
+     * Index in m_phases for each phase name
+     */
+    map<string, size_t> m_phaseIndex;
+    vector< pair<string, size_t> > m_simulations;
+    QElapsedTimer m_timer;
+    mutable QMutex m_mutex;
+};
+
+/**
+ * @brief Measures a phase from construction to destruction.
+ */
+class BenchmarkPhase
+{
+public:
+    BenchmarkPhase (const char* name,
+		    Benchmark::Type type = Benchmark::SERIAL,
+		    qint64 bytes = 0);
+    ~BenchmarkPhase ();
+    void SetBytes (qint64 bytes)
+    {
+	m_bytes = bytes;
+    }
+
+private:
+    const char* m_name;
+    Benchmark::Type m_type;
+    qint64 m_bytes;
+    bool m_recording;
+    QElapsedTimer m_timer;
+    double m_cpuMs;
+    long m_rssKb;
+};
+
+
+#endif //__BENCHMARK_H__
+
+// Local Variables:
+// mode: c++
+// End:
@@ -9,6 +9,7 @@
 #include "AttributeInfo.h"
 #include "Body.h"
 #include "Edge.h"
+#include "ElementArena.h"
 #include "Foam.h"
 #include "DataProperties.h"
 #include "Debug.h"
@@ -55,7 +56,7 @@ public:
             reversed = true;
         }
         i--;
-        return boost::make_shared<OrientedFace> (m_faces[i], reversed);
+        return MakeElement<OrientedFace> (m_faces[i], reversed);
     }
 private:
     /**
@@ -107,7 +108,10 @@ Body::Body(
     m_pressureDeduced (false),
     m_targetVolumeDeduced (false),
     m_actualVolumeDeduced (false),
-    m_object (false)
+    m_object (false),
+    m_geometryReleased (false),
+    m_releasedIs2D (false),
+    m_releasedSidesPerBody (0)
 {
     m_orientedFaces.resize (faceIndexes.size ());
     transform (faceIndexes.begin(), faceIndexes.end(), m_orientedFaces.begin(), 
@@ -124,10 +128,13 @@ Body::Body (boost::shared_ptr<Face> face, size_t id) :
     m_pressureDeduced (false),
     m_targetVolumeDeduced (false),
     m_actualVolumeDeduced (false),
-    m_object (true)
+    m_object (true),
+    m_geometryReleased (false),
+    m_releasedIs2D (false),
+    m_releasedSidesPerBody (0)
 {
     m_orientedFaces.resize (1);
-    m_orientedFaces[0].reset (new OrientedFace (face, false));
+    m_orientedFaces[0] = MakeElement<OrientedFace> (face, false);
 }
 
 void Body::calculatePhysicalVertices (
@@ -403,7 +410,8 @@ float Body::GetDeformationEigenScalar () const
 
 size_t Body::GetSidesPerBody () const
 {
-
+    if (m_geometryReleased)
+	return m_releasedSidesPerBody;
     if (Is2D ())
 	return GetOrientedFace (0).GetFace ()->GetEdgesPerFace (Is2D ());
     else
@@ -431,6 +439,14 @@ float Body::calculateArea () const
     return area;
 }
 
+size_t Body::GetMemorySize () const
+{
+    return sizeof (Body) + 
+	m_orientedFaces.capacity () * sizeof (boost::shared_ptr<OrientedFace>) +
+	m_orientedFaces.size () * sizeof (OrientedFace) +
+	m_neighbors.capacity () * sizeof (Neighbor);
+}
+
 float Body::CalculateVolume () const
 {
     float volume = 0;
@@ -464,6 +480,19 @@ float Body::GetBubbleDiameter () const
         GetScalarValue (BodyScalar::TARGET_VOLUME), Is2D ());
 }
 
+void Body::ReleaseGeometry ()
+{
+    if (m_geometryReleased)
+	return;
+    m_releasedIs2D = Is2D ();
+    m_releasedSidesPerBody = GetSidesPerBody ();
+    // neighbors point to bodies in the same time step, so they have
+    // to go for the time step to be freed
+    OrientedFaces ().swap (m_orientedFaces);
+    vector<Neighbor> ().swap (m_neighbors);
+    m_geometryReleased = true;
+}
+
 void Body::CalculateDeformationSimple ()
 {
     if (! HasScalarValue (BodyScalar::TARGET_VOLUME))
@@ -99,7 +99,8 @@ public:
     
     bool Is2D () const
     {
-        return m_orientedFaces.size () <= 1;
+	return m_geometryReleased ?
+	    m_releasedIs2D : m_orientedFaces.size () <= 1;
     }
     
     size_t GetFaceCount () const
@@ -258,6 +259,22 @@ public:
     float CalculateVolume () const;
     static float GetBubbleDiameter (float volume, bool is2D);
     float GetBubbleDiameter () const;
+    /**
+     * Drops the faces and the neighbors of the body. The center, the
+     * scalar values and the deformation are kept so that the body can
+     * still be used for statistics and bubble paths.
+     * @see Foam::ReleaseGeometry
+     */
+    void ReleaseGeometry ();
+    bool IsGeometryReleased () const
+    {
+	return m_geometryReleased;
+    }
+    /**
+     * @return bytes used by this body and its oriented faces, without
+     *         attributes
+     */
+    size_t GetMemorySize () const;
 
 
 private:
@@ -281,7 +298,7 @@ private:
 	vector< boost::shared_ptr<Vertex> >* destPhysical);
     void calculateNeighbors2D (const OOBox& originalDomain);
     void calculateNeighbors3D (const OOBox& originalDomain);
-
+    friend class FoamSnapshot;
 
 private:
     /**
@@ -306,6 +323,13 @@ private:
     bool m_targetVolumeDeduced;
     bool m_actualVolumeDeduced;
     bool m_object;
+    /**
+     * Values that need the faces or the neighbors, saved when the
+     * geometry is released.
+     */
+    bool m_geometryReleased;
+    bool m_releasedIs2D;
+    size_t m_releasedSidesPerBody;
 };
 
 /**
@@ -32,6 +32,9 @@ BodyAlongTime::BodyAlongTime (size_t timeSteps) :
 void BodyAlongTime::SetBody (
     size_t timeStep, const boost::shared_ptr<Body>& body)
 {
+    // time steps can be appended to a simulation
+    if (timeStep >= m_bodyAlongTime.size ())
+	m_bodyAlongTime.resize (timeStep + 1);
     m_bodyAlongTime[timeStep] = body;
     if (timeStep < m_timeBegin)
 	m_timeBegin = timeStep;
@@ -40,14 +43,16 @@ void BodyAlongTime::SetBody (
 }
 
 
-void BodyAlongTime::CalculateBodyWraps (const Simulation& simulation)
+void BodyAlongTime::CalculateBodyWraps (
+    const Simulation& simulation, size_t timeBegin)
 {
     if (simulation.IsTorus ())
     {
-	for (size_t time = m_timeBegin; time < (m_timeEnd - 1); time++)
+	for (size_t time = max (m_timeBegin, timeBegin); 
+	     time + 1 < m_timeEnd; time++)
 	{
 	    const OOBox& originalDomain = 
-		simulation.GetFoam (time+1).GetTorusDomain ();
+		simulation.GetFoamSummary (time+1).GetTorusDomain ();
 	    G3D::Vector3int16 translation;
 	    const G3D::Vector3& begin = m_bodyAlongTime[time]->GetCenter ();
 	    const G3D::Vector3& end = m_bodyAlongTime[time + 1]->GetCenter ();
@@ -60,6 +65,14 @@ void BodyAlongTime::CalculateBodyWraps (const Simulation& simulation)
     }
 }
 
+size_t BodyAlongTime::GetMemorySize () const
+{
+    return sizeof (BodyAlongTime) +
+	m_bodyAlongTime.capacity () * sizeof (boost::shared_ptr<Body>) +
+	m_wraps.capacity () * sizeof (size_t) +
+	m_translations.capacity () * sizeof (G3D::Vector3int16);
+}
+
 string BodyAlongTime::ToString () const
 {
     ostringstream ostr;
@@ -149,3 +162,14 @@ void BodiesAlongTime::AssertDeadBubblesStayDead () const
 	 it != m_bodyMap.end(); ++it)
 	it->second->AssertDeadBubblesStayDead ();
 }
+
+size_t BodiesAlongTime::GetMemorySize () const
+{
+    // a node in a red-black tree has three links and a color
+    size_t size = m_bodyMap.size () * 
+	(sizeof (BodyMap::value_type) + 4 * sizeof (void*));
+    for (BodyMap::const_iterator it = m_bodyMap.begin ();
+	 it != m_bodyMap.end(); ++it)
+	size += it->second->GetMemorySize ();
+    return size;
+}
@@ -45,9 +45,12 @@ public:
     /**
      * Calculates when from one time step to another a body is wrapped around
      * the original domain. A body wraps around when it moves a distance longer
-     * than 1/2 of min all sides of the original domain
+     * than 1/2 of min all sides of the original domain.
+     * Only moves that start at timeBegin or later are processed, the
+     * wraps before are already calculated.
      */
-    void CalculateBodyWraps (const Simulation& simulation);
+    void CalculateBodyWraps (const Simulation& simulation, 
+			     size_t timeBegin = 0);
 
     StripIterator GetStripIterator (const Simulation& simulation) const
     {
@@ -69,6 +72,11 @@ public:
     }
     string ToString () const;    
     void AssertDeadBubblesStayDead () const;
+    /**
+     * @return bytes used for the path. Bodies are owned by the Foam
+     *         objects, so only the pointers are included.
+     */
+    size_t GetMemorySize () const;
 
 public:
     friend ostream& operator<< (
@@ -137,6 +145,7 @@ public:
 
     string ToString () const;
     void AssertDeadBubblesStayDead () const;
+    size_t GetMemorySize () const;
 
 private:
     BodyAlongTime& getBodyAlongTime (size_t id) const;
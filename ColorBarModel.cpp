@@ -8,6 +8,7 @@
 
 #include "ColorBarModel.h"
 #include "Debug.h"
+#include "Foam.h"
 #include "Settings.h"
 #include "Utils.h"
 
@@ -346,6 +347,17 @@ void ColorBarModel::SetLog10 (bool log10)
     m_log10 = log10;
 }
 
+void ColorBarModel::SetClampQuantiles (
+    const Foam& foam, BodyScalar::Enum property, 
+    double lowFraction, double highFraction)
+{
+    double low = foam.CalculateQuantile (property, lowFraction);
+    double high = foam.CalculateQuantile (property, highFraction);
+    SetClampInterval (
+	QwtDoubleInterval (max (low, m_interval.minValue ()),
+			   min (high, m_interval.maxValue ())));
+}
+
 bool ColorBarModel::IsClampedMin () const
 {
     return m_clampInterval.minValue () > m_interval.minValue ();
@@ -11,6 +11,7 @@
 #define __MODEL_H__
 
 #include "Enums.h"
+class Foam;
 
 /**
  * @brief Mapping between scalar values and colors together with appropriate
@@ -92,6 +93,12 @@ public:
 	m_clampInterval.setMaxValue (m_interval.minValue ());
 	SetupPalette (GetPalette ());
     }    
+    /**
+     * Clamps to the quantiles lowFraction and highFraction of property
+     * over the bodies of foam, inside the interval of the color map.
+     */
+    void SetClampQuantiles (const Foam& foam, BodyScalar::Enum property,
+			    double lowFraction, double highFraction);
     void SetupPalette (Palette palette);
     QColor GetHighlightColor (HighlightNumber::Enum i) const;
     void SetHighlightColor (HighlightNumber::Enum i, const QColor& color)
@@ -38,6 +38,49 @@ struct LessThanNoCase : binary_function<const char*, const char*, bool>
     }
 };
 
+/**
+ * @brief Tests two C strings for equality ignoring the case
+ */
+struct EqualNoCase : binary_function<const char*, const char*, bool>
+{
+    bool operator()(const char* s1, const char* s2) const
+    {
+        return strcasecmp(s1, s2) == 0;
+    }
+    bool operator () (const string& s1, const string& s2) const
+    {
+	return operator () (s1.c_str (), s2.c_str ());
+    }
+    bool operator () (const char* s1, const string& s2) const
+    {
+	return operator () (s1, s2.c_str ());
+    }
+    bool operator () (const string& s1, const char* s2) const
+    {
+	return operator () (s1.c_str (), s2);
+    }
+};
+
+/**
+ * @brief Hashes a C string ignoring the case (FNV-1a on the upper case
+ * characters). Strings equal according to EqualNoCase have the same hash.
+ */
+struct HashNoCase : unary_function<const char*, size_t>
+{
+    size_t operator () (const char* s) const
+    {
+	unsigned int hash = 2166136261u;
+	for (; *s != 0; ++s)
+	    hash = (hash ^ toupper (static_cast<unsigned char> (*s))) *
+		16777619u;
+	return hash;
+    }
+    size_t operator () (const string& s) const
+    {
+	return operator () (s.c_str ());
+    }
+};
+
 /**
  * @brief Compares two Vector3int16
  */
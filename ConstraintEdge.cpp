@@ -7,6 +7,7 @@
 #include "Attribute.h"
 #include "ConstraintEdge.h"
 #include "Debug.h"
+#include "ElementArena.h"
 #include "ExpressionTree.h"
 #include "OOBox.h"
 #include "ParsingData.h"
@@ -42,19 +43,16 @@ float evaluateLineEquation (
 struct ConstraintLineParams
 {
     ConstraintLineParams (
-	ParsingData* parsingData,
-	const boost::shared_ptr<ExpressionTree>& expressionTree,
+	const ExpressionProgram& program,
 	G3D::Vector3 normal, G3D::Vector3 point) :
 
-	m_parsingData (parsingData),
-	m_expressionTree (expressionTree),
+	m_program (program),
 	m_normal (normal),
 	m_point (point)
     {
 	//cdbg << "normal=" << m_normal << " point=" << m_point << endl;
     }
-    ParsingData* m_parsingData;
-    boost::shared_ptr<ExpressionTree> m_expressionTree;
+    const ExpressionProgram& m_program;
     G3D::Vector3 m_normal;
     G3D::Vector3 m_point;
 };
@@ -100,9 +98,7 @@ int constraintLineEvaluator (const gsl_vector* gslX, void* p, gsl_vector* f)
     boost::array<double, 2> x;
     x[0] = gsl_vector_get(gslX, 0);
     x[1] = gsl_vector_get(gslX, 1);
-    params->m_parsingData->SetVariable ("x", x[0]);
-    params->m_parsingData->SetVariable ("y", x[1]);
-    gsl_vector_set (f, 0, params->m_expressionTree->Value ());
+    gsl_vector_set (f, 0, params->m_program.Value (x[0], x[1]));
 
 
     //size_t axis = (abs(params->m_normal.x) > abs(params->m_normal.y)) ? 0 : 1;
@@ -236,7 +232,7 @@ ConstraintEdge::ConstraintEdge (
 
 boost::shared_ptr<Edge> ConstraintEdge::createDuplicate (
     const OOBox& originalDomain,
-    const G3D::Vector3& newBegin, VertexSet* vertexSet) const
+    const G3D::Vector3& newBegin, VertexHashSet* vertexSet) const
 {
     G3D::Vector3int16 translation = originalDomain.GetTranslation (
 	GetBeginVector (), newBegin);
@@ -249,7 +245,7 @@ boost::shared_ptr<Edge> ConstraintEdge::createDuplicate (
 
 boost::shared_ptr<Edge> ConstraintEdge::Clone () const
 {
-    return boost::shared_ptr<Edge> (new ConstraintEdge(*this));
+    return MakeElement<ConstraintEdge> (*this);
 }
 
 size_t ConstraintEdge::storePointsToFix (
@@ -417,10 +413,9 @@ G3D::Vector3 ConstraintEdge::calculatePointMulti (
     G3D::Vector3 end = GetEndVector ();
     G3D::Vector3 current = begin + (end - begin) * i / (GetPointCount () - 1);
     size_t constraintIndex = GetBegin ().GetConstraintIndex (0);
-    boost::shared_ptr<ExpressionTree> constraint = 
-	m_parsingData->GetConstraint (constraintIndex);
-    ConstraintLineParams clp (m_parsingData, constraint,
-			      end - begin, current);
+    ConstraintLineParams clp (
+	m_parsingData->GetConstraintProgram (constraintIndex),
+	end - begin, current);
     gsl_multiroot_function function;
     function.f = &constraintLineEvaluator;
     function.n = 2;
@@ -40,7 +40,7 @@ protected:
     boost::shared_ptr<Edge> Clone () const;
     virtual boost::shared_ptr<Edge> createDuplicate (
 	const OOBox& originalDomain,
-	const G3D::Vector3& newBegin, VertexSet* vertexSet) const;
+	const G3D::Vector3& newBegin, VertexHashSet* vertexSet) const;
 
 private:
     enum Side
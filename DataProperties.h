@@ -45,13 +45,13 @@ public:
     }
     void SetDimension (size_t dimension);
 
-    bool operator== (const DataProperties& other)
+    bool operator== (const DataProperties& other) const
     {
 	return m_dimension == other.m_dimension &&
 	    m_quadratic == other.m_quadratic;
     }
 
-    bool operator!= (const DataProperties& other)
+    bool operator!= (const DataProperties& other) const
     {
 	return ! operator== (other);
     }
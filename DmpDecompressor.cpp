@@ -0,0 +1,184 @@
+/**
+ * @file   DmpDecompressor.cpp
+ * @author Dan R. Lipsa
+ *
+ * Definitions for the DmpDecompressor class.
+ */
+
+#include "DmpDecompressor.h"
+#include "Debug.h"
+
+
+// Private Functions and constants
+// ======================================================================
+
+namespace
+{
+const size_t BUFFER_SIZE = 128 * 1024;
+
+bool endsWith (const string& s, const char* suffix)
+{
+    size_t n = strlen (suffix);
+    return s.size () >= n && s.compare (s.size () - n, n, suffix) == 0;
+}
+}
+
+
+// Methods
+// ======================================================================
+
+DmpDecompressor::DmpDecompressor (const string& path, Format format, int fd) :
+    m_path (path),
+    m_format (format),
+    m_fd (fd)
+{
+}
+
+DmpDecompressor::~DmpDecompressor ()
+{
+    wait ();
+    closePipe ();
+}
+
+DmpDecompressor::Format DmpDecompressor::GetFormat (const string& path)
+{
+    if (endsWith (path, ".gz"))
+	return GZIP;
+    else if (endsWith (path, ".zst"))
+	return ZSTD;
+    else
+	return NONE;
+}
+
+void DmpDecompressor::run ()
+{
+#ifdef _MSC_VER
+    m_error = "compressed DMP files are not supported";
+#else //_MSC_VER
+    // if the scanner stops early we get EPIPE instead of a SIGPIPE
+    // that would terminate the program
+    sigset_t sigpipe;
+    sigemptyset (&sigpipe);
+    sigaddset (&sigpipe, SIGPIPE);
+    pthread_sigmask (SIG_BLOCK, &sigpipe, 0);
+    switch (m_format)
+    {
+    case GZIP:
+	gzipDecompress ();
+	break;
+    case ZSTD:
+	zstdDecompress ();
+	break;
+    default:
+	m_error = "unknown compression format";
+	break;
+    }
+    closePipe ();
+    sigset_t pending;
+    int signal;
+    if (sigpending (&pending) == 0 && sigismember (&pending, SIGPIPE))
+	sigwait (&sigpipe, &signal);
+#endif //_MSC_VER
+}
+
+void DmpDecompressor::gzipDecompress ()
+{
+    gzFile file = gzopen (m_path.c_str (), "rb");
+    if (file == 0)
+    {
+	m_error = "cannot open " + m_path;
+	return;
+    }
+    gzbuffer (file, BUFFER_SIZE);
+    vector<char> buffer (BUFFER_SIZE);
+    int size;
+    while ((size = gzread (file, &buffer[0], buffer.size ())) > 0)
+	if (! write (&buffer[0], size))
+	    break;
+    if (size < 0)
+    {
+	int errnum;
+	m_error = string ("gzip: ") + gzerror (file, &errnum);
+    }
+    gzclose (file);
+}
+
+void DmpDecompressor::zstdDecompress ()
+{
+#ifndef _MSC_VER
+    FILE* file = fopen (m_path.c_str (), "rb");
+    if (file == 0)
+    {
+	m_error = "cannot open " + m_path;
+	return;
+    }
+    ZSTD_DStream* stream = ZSTD_createDStream ();
+    ZSTD_initDStream (stream);
+    vector<char> inBuffer (ZSTD_DStreamInSize ());
+    vector<char> outBuffer (ZSTD_DStreamOutSize ());
+    // 0 at the end of a frame, a hint for the next input size otherwise
+    size_t ret = 0;
+    size_t read;
+    bool written = true;
+    while (written &&
+	   (read = fread (&inBuffer[0], 1, inBuffer.size (), file)) > 0)
+    {
+	ZSTD_inBuffer in = {&inBuffer[0], read, 0};
+	while (in.pos < in.size)
+	{
+	    ZSTD_outBuffer out = {&outBuffer[0], outBuffer.size (), 0};
+	    ret = ZSTD_decompressStream (stream, &out, &in);
+	    if (ZSTD_isError (ret))
+	    {
+		m_error = string ("zstd: ") + ZSTD_getErrorName (ret);
+		written = false;
+		break;
+	    }
+	    if (! write (&outBuffer[0], out.pos))
+	    {
+		written = false;
+		break;
+	    }
+	}
+    }
+    if (m_error.empty () && ferror (file))
+	m_error = "cannot read " + m_path;
+    else if (written && ret != 0)
+	m_error = "zstd: truncated file " + m_path;
+    ZSTD_freeDStream (stream);
+    fclose (file);
+#endif //_MSC_VER
+}
+
+bool DmpDecompressor::write (const char* buffer, size_t size)
+{
+#ifndef _MSC_VER
+    while (size > 0)
+    {
+	ssize_t written = ::write (m_fd, buffer, size);
+	if (written == -1)
+	{
+	    if (errno == EINTR)
+		continue;
+	    // EPIPE means the scanner does not need the rest of the file
+	    if (errno != EPIPE)
+		m_error = string ("write: ") + strerror (errno);
+	    return false;
+	}
+	buffer += written;
+	size -= written;
+    }
+#endif //_MSC_VER
+    return true;
+}
+
+void DmpDecompressor::closePipe ()
+{
+#ifndef _MSC_VER
+    if (m_fd != -1)
+    {
+	close (m_fd);
+	m_fd = -1;
+    }
+#endif //_MSC_VER
+}
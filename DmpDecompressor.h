@@ -0,0 +1,75 @@
+/**
+ * @file DmpDecompressor.h
+ * @author Dan R. Lipsa
+ * @brief Decompresses a DMP file into a pipe read by the scanner.
+ * @ingroup parser
+ */
+#ifndef __DMP_DECOMPRESSOR_H__
+#define __DMP_DECOMPRESSOR_H__
+
+/**
+ * @brief Decompresses a DMP file into a pipe read by the scanner.
+ *
+ * The decompression runs in its own thread so that it overlaps with
+ * scanning and parsing. We use a dedicated thread rather than the
+ * global thread pool because DMP files are parsed from pool threads
+ * which would wait on each other.
+ * The compression format is chosen based on the extension of the file:
+ * .gz for gzip and .zst for zstd.
+ */
+class DmpDecompressor : public QThread
+{
+public:
+    enum Format
+    {
+	NONE,
+	GZIP,
+	ZSTD
+    };
+
+public:
+    /**
+     * @param path compressed file
+     * @param format compression format of the file
+     * @param fd write end of a pipe. The decompressor owns it and
+     *        closes it when the whole file was written.
+     */
+    DmpDecompressor (const string& path, Format format, int fd);
+    ~DmpDecompressor ();
+    /**
+     * @return empty if the file was decompressed successfully, a
+     *         description of the error otherwise. Call it after the
+     *         thread finished.
+     */
+    const string& GetError () const
+    {
+	return m_error;
+    }
+    static Format GetFormat (const string& path);
+
+protected:
+    virtual void run ();
+
+private:
+    void gzipDecompress ();
+    void zstdDecompress ();
+    /**
+     * @return false if the scanner closed its end of the pipe or
+     *         there was a write error.
+     */
+    bool write (const char* buffer, size_t size);
+    void closePipe ();
+
+private:
+    string m_path;
+    Format m_format;
+    int m_fd;
+    string m_error;
+};
+
+
+#endif //__DMP_DECOMPRESSOR_H__
+
+// Local Variables:
+// mode: c++
+// End:
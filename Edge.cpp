@@ -10,6 +10,7 @@
 #include "Body.h"
 #include "Debug.h"
 #include "Edge.h"
+#include "ElementArena.h"
 #include "EvolverData_yacc.h"
 #include "Foam.h"
 #include "DataProperties.h"
@@ -51,7 +52,7 @@ Edge::Edge (const Edge& o) :
 
 boost::shared_ptr<Edge> Edge::Clone () const
 {
-    return boost::shared_ptr<Edge> (new Edge(*this));
+    return MakeElement<Edge> (*this);
 }
 
 G3D::Vector3 Edge::GetTranslatedBegin (const G3D::Vector3& newEnd) const
@@ -160,24 +161,20 @@ string Edge::ToString (const AttributesInfo* ai) const
 boost::shared_ptr<Edge> Edge::GetDuplicate (
     const OOBox& periods,
     const G3D::Vector3& newBegin,
-    VertexSet* vertexSet, EdgeSet* edgeSet) const
+    VertexHashSet* vertexSet, EdgeHashSet* edgeSet) const
 {
-    boost::shared_ptr<Edge> searchDummy = 
-	boost::make_shared<Edge>(
-	    boost::make_shared<Vertex> (
-		newBegin, GetBegin ().GetId ()), GetId ());
-    EdgeSet::iterator it = edgeSet->find (searchDummy);
-    if (it != edgeSet->end ())
-	return *it;
-    boost::shared_ptr<Edge> duplicate = createDuplicate (
-	periods, newBegin, vertexSet);
-    edgeSet->insert (duplicate);
+    boost::shared_ptr<Edge> duplicate = edgeSet->Find (
+	GetId (), GetBegin ().GetId (), newBegin);
+    if (duplicate)
+	return duplicate;
+    duplicate = createDuplicate (periods, newBegin, vertexSet);
+    edgeSet->Insert (duplicate);
     return duplicate;
 }
 
 boost::shared_ptr<Edge> Edge::createDuplicate (
     const OOBox& periods,
-    const G3D::Vector3& newBegin, VertexSet* vertexSet) const
+    const G3D::Vector3& newBegin, VertexHashSet* vertexSet) const
 {
     G3D::Vector3int16 translation = periods.GetTranslation (
 	GetBeginVector (), newBegin);
@@ -220,6 +217,13 @@ G3D::Vector3 Edge::GetPoint (size_t i) const
 	return GetEndVector ();
 }
 
+size_t Edge::GetMemorySize () const
+{
+    // a node in a red-black tree has three links and a color
+    return sizeof (Edge) + m_adjacentOrientedFaces.size () *
+	(sizeof (AdjacentOrientedFace) + 4 * sizeof (void*));
+}
+
 size_t Edge::GetConstraintIndex (size_t i) const
 {
     return GetAttribute<IntegerArrayAttribute, 
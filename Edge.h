@@ -9,6 +9,7 @@
 
 #include "Element.h"
 #include "AdjacentOrientedFace.h"
+#include "ElementHashSet.h"
 class AttributesInfo;
 class Foam;
 class OOBox;
@@ -34,6 +35,10 @@ public:
 	  size_t id, Type type = EDGE,
 	  ElementStatus::Enum duplicateStatus = ElementStatus::ORIGINAL);
     Edge (const boost::shared_ptr<Vertex>& begin, size_t id, Type type = EDGE);
+    /**
+     * Use Clone to copy an edge of unknown type
+     */
+    Edge (const Edge& edge);
     virtual ~Edge ()
     {
     }
@@ -139,13 +144,17 @@ public:
     boost::shared_ptr<Edge> GetDuplicate (
 	const OOBox& periods,
 	const G3D::Vector3& newBegin,
-	VertexSet* vertexSet, EdgeSet* edgeSet) const;    
+	VertexHashSet* vertexSet, EdgeHashSet* edgeSet) const;    
 
     virtual size_t GetPointCount () const
     {
 	return 2;
     }
     virtual G3D::Vector3 GetPoint (size_t i) const;
+    /**
+     * @return bytes used by this edge, without its attributes
+     */
+    virtual size_t GetMemorySize () const;
     QColor GetColor (const QColor& defaultColor) const;
     Type GetType () const
     {
@@ -166,10 +175,9 @@ public:
 
 
 protected:
-    Edge (const Edge& edge);
     virtual boost::shared_ptr<Edge> createDuplicate (
 	const OOBox& originalDomain,
-	const G3D::Vector3& newBegin, VertexSet* vertexSet) const;
+	const G3D::Vector3& newBegin, VertexHashSet* vertexSet) const;
 
 private:
     /**
@@ -180,7 +188,7 @@ private:
     {
 	m_begin = begin;
     }
-
+    friend class FoamSnapshot;
 
 private:
     /**
@@ -15,7 +15,9 @@ const char* EditColorMap::HIGHLIGHT_LABEL_TEXT = "Hightlight";
 
 EditColorMap::EditColorMap (
     QWidget* parent) :
-    QDialog (parent)
+    QDialog (parent),
+    m_foam (0),
+    m_property (BodyScalar::PRESSURE)
 {
     setupUi (this);
     m_labelHighlight[0] = labelHighlight0;
@@ -52,9 +54,13 @@ void EditColorMap::fillCombo (PaletteDiverging::Enum paletteDiverging)
 
 void EditColorMap::SetData (
     const QwtIntervalData& intervalData, double maxValue,
-    const ColorBarModel& colorBarModel, bool gridEnabled)
+    const ColorBarModel& colorBarModel, bool gridEnabled,
+    const Foam* foam, BodyScalar::Enum property)
 {
     m_colorMap = colorBarModel;
+    m_foam = foam;
+    m_property = property;
+    widgetHistogram->SetClampPercentilesEnabled (foam != 0);
     setCombos (m_colorMap.GetPalette ());
     widgetHistogram->SetDataAllBinsSelected (
 	intervalData, maxValue, 
@@ -62,14 +68,19 @@ void EditColorMap::SetData (
     widgetHistogram->SetColorTransferFunction (
 	m_colorMap.GetInterval (), m_colorMap.GetQwtColorMap ());
     widgetHistogram->SetGridEnabled (gridEnabled);
+    setItemsSelection ();
+    setHighlightColors ();
+ }
+
+void EditColorMap::setItemsSelection ()
+{
     QwtDoubleInterval interval = m_colorMap.GetInterval ();
     QwtDoubleInterval clampValues = m_colorMap.GetClampInterval ();
     if (clampValues.minValue () > interval.minValue ())
 	widgetHistogram->SetItemsSelectionLow (false, clampValues.minValue ());
     if (clampValues.maxValue () < interval.maxValue ())
 	widgetHistogram->SetItemsSelectionHigh (false, clampValues.maxValue ());
-    setHighlightColors ();
- }
+}
 
 void EditColorMap::setHighlightColors ()
 {
@@ -172,3 +183,11 @@ void EditColorMap::ClampClear ()
     widgetHistogram->SetColorTransferFunction (
 	m_colorMap.GetInterval (), m_colorMap.GetQwtColorMap ());
 }
+
+void EditColorMap::ClampPercentiles ()
+{
+    m_colorMap.SetClampQuantiles (*m_foam, m_property, 0.05, 0.95);
+    widgetHistogram->SetColorTransferFunction (
+	m_colorMap.GetInterval (), m_colorMap.GetQwtColorMap ());
+    setItemsSelection ();
+}
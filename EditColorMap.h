@@ -11,6 +11,7 @@
 
 #include "ui_EditColorMap.h"
 #include "ColorBarModel.h"
+class Foam;
 
 /**
  * @brief Dialog to choose and clamp a color map.
@@ -20,8 +21,14 @@ class EditColorMap :
 {
 public:
     EditColorMap (QWidget* parent);
+    /**
+     * @param foam the current time step, used to clamp to percentiles
+     *        of property, or 0 if the color map is not for a BodyScalar
+     */
     void SetData (const QwtIntervalData& histogram, double maxValue,
-		  const ColorBarModel& colorBarModel, bool gridEnabled = true);
+		  const ColorBarModel& colorBarModel, bool gridEnabled = true,
+		  const Foam* foam = 0, 
+		  BodyScalar::Enum property = BodyScalar::PRESSURE);
     
     const ColorBarModel& GetColorMap () const
     {
@@ -34,6 +41,7 @@ public Q_SLOTS:
     void SetClampMax (double value);
     void SetClampMin (double value);
     void ClampClear ();
+    void ClampPercentiles ();
     void ToggledColorCodedHistogram (bool checked);
     void ToggledLog10Values (bool checked);
     void CurrentIndexChangedType (int i);
@@ -44,6 +52,7 @@ public Q_SLOTS:
 private:
     void clickedHighlight (HighlightNumber::Enum highlightNumber);
     void setHighlightColors ();
+    void setItemsSelection ();
     void setCombos (Palette palette);
     void fillCombo (PaletteSequential::Enum paletteSequential);
     void fillCombo (PaletteDiverging::Enum paletteDiverging);
@@ -55,6 +64,8 @@ private:
 private:
     Q_OBJECT
     ColorBarModel m_colorMap;
+    const Foam* m_foam;
+    BodyScalar::Enum m_property;
     boost::array<QLabel*, HighlightNumber::COUNT> m_labelHighlight;
 };
 
@@ -12,6 +12,62 @@
 #include "Utils.h"
 #include "NameSemanticValue.h"
 
+// Private Functions
+// ======================================================================
+
+namespace
+{
+/**
+ * Functions that read and write attributes of type T, chosen by the
+ * type of the last parameter
+ */
+int getValue (const AttributeValues& values, size_t i, IntegerAttribute*)
+{
+    return values.GetInteger (i);
+}
+
+double getValue (const AttributeValues& values, size_t i, RealAttribute*)
+{
+    return values.GetReal (i);
+}
+
+Color::Enum getValue (const AttributeValues& values, size_t i, ColorAttribute*)
+{
+    return values.GetColor (i);
+}
+
+const vector<int> getValue (
+    const AttributeValues& values, size_t i, IntegerArrayAttribute*)
+{
+    return *boost::static_pointer_cast<IntegerArrayAttribute> (
+	values.GetArray (i));
+}
+
+void setValue (AttributeValues* values, size_t i, double value, 
+	       RealAttribute*)
+{
+    values->SetReal (i, value);
+}
+
+void setValue (AttributeValues* values, size_t i, Color::Enum value, 
+	       ColorAttribute*)
+{
+    values->SetColor (i, value);
+}
+
+void setValue (AttributeValues* values, size_t i, const vector<int> value,
+	       IntegerArrayAttribute*)
+{
+    if (values->Has (i))
+	boost::static_pointer_cast<IntegerArrayAttribute> (
+	    values->GetArray (i))->set (value);
+    else
+	values->SetArray (
+	    i, boost::shared_ptr<Attribute> (new IntegerArrayAttribute (value)));
+}
+} // namespace
+
+
 // Private Classes
 // ======================================================================
 
@@ -83,19 +139,16 @@ Element::Element(size_t id, ElementStatus::Enum duplicateStatus) :
 }
 
 Element::Element (const Element& other) :
+    m_attributes (other.m_attributes),
     m_id (other.m_id),
     m_duplicateStatus (other.m_duplicateStatus)
 {
-    m_attributes.resize (other.m_attributes.size ());
-    m_attributes = other.m_attributes;
 }
 
 
 void Element::SetAttribute (size_t i, Attribute* attribute)
 {
-    resizeAllowIndex (&m_attributes, i);
-    boost::shared_ptr<Attribute> p(attribute);
-    m_attributes[i] = p;
+    m_attributes.Set (i, attribute);
 }
 
 void Element::storeAttribute (
@@ -128,7 +181,7 @@ ostream& Element::PrintAttributes (ostream& ostr,
 	    {
 		if (infos != 0)
 		    ostr << infos->GetAttributeName (i) << ": ";
-		ostr << m_attributes[i] << " ";
+		m_attributes.Print (ostr, i) << " ";
 	    }
     return ostr;
 }
@@ -147,32 +200,23 @@ TValue Element::GetAttribute (size_t i) const
     RuntimeAssert (HasAttribute (i),
 		   "Attribute does not exist at index ", i, 
 		   " for element ", GetId ());
-    return *boost::static_pointer_cast<T> (m_attributes[i]);
+    return getValue (m_attributes, i, static_cast<T*> (0));
 }
 
 template<typename T, typename TValue>
 void Element::SetAttribute (size_t i, TValue value)
 {
-    resizeAllowIndex (&m_attributes, i);
-    boost::shared_ptr<T> attribute = 
-	boost::static_pointer_cast<T> (m_attributes[i]);
-    if (attribute == 0)
-    {
-	attribute = boost::shared_ptr<T> (new T (value));
-	m_attributes[i] = attribute;
-    }
-    else
-	attribute->set (value);
+    setValue (&m_attributes, i, value, static_cast<T*> (0));
 }
 
 bool Element::HasAttribute (size_t i) const
 {
-    return i < m_attributes.size () &&	m_attributes[i] != 0;
+    return m_attributes.Has (i);
 }
 
 bool Element::HasAttributes () const
 {
-    return ! m_attributes.empty ();
+    return ! m_attributes.IsEmpty ();
 }
 
 // Template instantiations
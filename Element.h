@@ -8,6 +8,7 @@
 #ifndef __ELEMENT_H__
 #define __ELEMENT_H__
 
+#include "AttributeValues.h"
 #include "Enums.h"
 class Attribute;
 class AttributesInfo;
@@ -79,23 +80,30 @@ public:
     {
 	m_duplicateStatus = duplicateStatus;
     }
+    /**
+     * @return bytes used by the attribute values, in addition to
+     *         the size of the element
+     */
+    size_t GetAttributesMemorySize () const
+    {
+	return m_attributes.GetMemorySize ();
+    }
     /**
      * Pretty print attributes of an element
      */
     ostream& PrintAttributes (ostream& ostr,
 			      const AttributesInfo* infos = 0) const;
+    friend class FoamSnapshot;
+
 private:
     void storeAttribute (
 	const NameSemanticValue& nv, const AttributesInfo& infos);
 
-protected:
-    typedef vector< boost::shared_ptr<Attribute> > Attributes;
-
 protected:
     /**
-     * Vector of attributes
+     * Values of attributes, indexed by attribute index
      */
-    Attributes m_attributes;
+    AttributeValues m_attributes;
     /**
      * The original index for this element
      */
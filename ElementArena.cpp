@@ -0,0 +1,187 @@
+/**
+ * @file   ElementArena.cpp
+ * @author Dan R. Lipsa
+ *
+ * Definitions for the ElementArena class.
+ */
+
+#include "Debug.h"
+#include "ElementArena.h"
+
+
+// Private Functions and constants
+// ======================================================================
+
+namespace
+{
+const size_t BLOCK_SIZE = 256 * 1024;
+/**
+ * Alignment of every allocation, enough for any element
+ */
+const size_t ALIGNMENT = 16;
+
+/**
+ * Number of arenas that exist. If there is none, elements are created
+ * without looking for a current arena.
+ */
+QAtomicInt arenaCount;
+
+/**
+ * Scope current in a thread. QThreadStorage deletes the value it
+ * replaces, so the scope pointer is kept in a holder.
+ */
+struct CurrentScope
+{
+    CurrentScope () :
+	m_scope (0)
+    {
+    }
+    ElementArena::Scope* m_scope;
+};
+QThreadStorage<CurrentScope*> currentScope;
+
+size_t alignSize (size_t size)
+{
+    return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+}
+} // namespace
+
+
+// Members: ElementArena
+// ======================================================================
+
+ElementArena::ElementArena () :
+    m_next (0),
+    m_end (0),
+    m_reservedSize (0),
+    m_usedSize (0)
+{
+    arenaCount.ref ();
+}
+
+ElementArena::~ElementArena ()
+{
+    BOOST_FOREACH (char* block, m_blocks)
+	delete[] block;
+    arenaCount.deref ();
+}
+
+void* ElementArena::Allocate (size_t size)
+{
+    Scope* scope = getCurrentScope ();
+    RuntimeAssert (scope != 0 && scope->m_arena == this,
+		   "Allocation from an arena that is not current");
+    return scope->allocate (alignSize (size));
+}
+
+void ElementArena::takeBlock (size_t size, char** next, char** end)
+{
+    QMutexLocker locker (&m_mutex);
+    if (size <= size_t (m_end - m_next))
+    {
+	*next = m_next;
+	*end = m_end;
+	m_next = m_end = 0;
+    }
+    else
+    {
+	// operator new[] returns memory aligned for any type
+	size_t blockSize = max (size, BLOCK_SIZE);
+	m_blocks.push_back (new char[blockSize]);
+	*next = m_blocks.back ();
+	*end = *next + blockSize;
+	m_reservedSize += blockSize;
+    }
+}
+
+void ElementArena::returnBlock (char* next, char* end, size_t usedSize)
+{
+    QMutexLocker locker (&m_mutex);
+    m_usedSize += usedSize;
+    if (end - next > m_end - m_next)
+    {
+	m_next = next;
+	m_end = end;
+    }
+}
+
+size_t ElementArena::GetReservedSize () const
+{
+    QMutexLocker locker (&m_mutex);
+    return m_reservedSize;
+}
+
+size_t ElementArena::GetUsedSize () const
+{
+    QMutexLocker locker (&m_mutex);
+    return m_usedSize;
+}
+
+ElementArena* ElementArena::GetCurrent ()
+{
+    if (arenaCount == 0)
+	return 0;
+    Scope* scope = getCurrentScope ();
+    return scope == 0 ? 0 : scope->m_arena;
+}
+
+ElementArena::Scope* ElementArena::getCurrentScope ()
+{
+    return currentScope.hasLocalData () ? 
+	currentScope.localData ()->m_scope : 0;
+}
+
+void ElementArena::setCurrentScope (Scope* scope)
+{
+    if (! currentScope.hasLocalData ())
+	currentScope.setLocalData (new CurrentScope ());
+    currentScope.localData ()->m_scope = scope;
+}
+
+
+// Members: ElementArena::Scope
+// ======================================================================
+
+ElementArena::Scope::Scope (ElementArena* arena) :
+    m_arena (arena),
+    m_previous (getCurrentScope ()),
+    m_next (0),
+    m_end (0),
+    m_usedSize (0)
+{
+    if (m_previous != 0 && m_previous->m_arena == m_arena)
+    {
+	// a nested scope continues the block of the enclosing one
+	swap (m_next, m_previous->m_next);
+	swap (m_end, m_previous->m_end);
+    }
+    setCurrentScope (this);
+}
+
+ElementArena::Scope::~Scope ()
+{
+    setCurrentScope (m_previous);
+    if (m_arena == 0)
+	return;
+    if (m_previous != 0 && m_previous->m_arena == m_arena)
+    {
+	m_previous->m_next = m_next;
+	m_previous->m_end = m_end;
+	m_previous->m_usedSize += m_usedSize;
+    }
+    else
+	m_arena->returnBlock (m_next, m_end, m_usedSize);
+}
+
+void* ElementArena::Scope::allocate (size_t size)
+{
+    if (size > size_t (m_end - m_next))
+    {
+	// the rest of the current block is lost
+	m_arena->takeBlock (size, &m_next, &m_end);
+    }
+    void* p = m_next;
+    m_next += size;
+    m_usedSize += size;
+    return p;
+}
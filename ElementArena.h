@@ -0,0 +1,257 @@
+/**
+ * @file ElementArena.h
+ * @author Dan R. Lipsa
+ * @brief Memory shared by the elements of one Foam
+ * @ingroup data model
+ */
+#ifndef __ELEMENT_ARENA_H__
+#define __ELEMENT_ARENA_H__
+
+/**
+ * @brief Memory shared by the elements of one Foam
+ *
+ * Memory is allocated from large blocks, one after the other, and it
+ * is not returned when an element is destroyed. All blocks are
+ * deleted together when the arena is destroyed. The arena is owned by
+ * its Foam which destroys it after all the elements allocated from it.
+ *
+ * Elements are allocated from the arena that is current in the
+ * calling thread (@see Scope), or from the heap if there is none
+ * (@see MakeElement). Each scope allocates from its own block so the
+ * arena is locked only when a block is handed out.
+ */
+class ElementArena
+{
+public:
+    /**
+     * Makes an arena current in the calling thread while it is in
+     * scope.
+     */
+    class Scope
+    {
+    public:
+	Scope (ElementArena* arena);
+	~Scope ();
+
+    private:
+	friend class ElementArena;
+	void* allocate (size_t size);
+
+    private:
+	ElementArena* m_arena;
+	Scope* m_previous;
+	/**
+	 * Free memory in the block used by this scope
+	 */
+	char* m_next;
+	char* m_end;
+	size_t m_usedSize;
+    };
+
+public:
+    ElementArena ();
+    ~ElementArena ();
+    /**
+     * Allocates from the scope of this arena current in the calling
+     * thread.
+     */
+    void* Allocate (size_t size);
+    /**
+     * @return the size of the blocks allocated from the heap
+     */
+    size_t GetReservedSize () const;
+    /**
+     * @return the size allocated for elements by the scopes that ended
+     */
+    size_t GetUsedSize () const;
+    /**
+     * @return the arena current in the calling thread or 0.
+     */
+    static ElementArena* GetCurrent ();
+
+private:
+    friend class Scope;
+    void takeBlock (size_t size, char** next, char** end);
+    void returnBlock (char* next, char* end, size_t usedSize);
+    static Scope* getCurrentScope ();
+    static void setCurrentScope (Scope* scope);
+
+private:
+    /**
+     * Elements of one Foam are usually created by one thread but
+     * nothing prevents a Foam method from using several.
+     */
+    mutable QMutex m_mutex;
+    vector<char*> m_blocks;
+    /**
+     * Free memory left by a scope that ended, used by the next one
+     */
+    char* m_next;
+    char* m_end;
+    size_t m_reservedSize;
+    size_t m_usedSize;
+};
+
+
+/**
+ * @brief Allocator used with boost::allocate_shared to create an element
+ *        and its reference count in an arena.
+ *
+ * The allocator is stored with the reference count, so it keeps only
+ * a pointer to the arena. The Foam that owns the arena outlives its
+ * elements.
+ */
+template<typename T>
+class ElementAllocator
+{
+public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    template<typename U> struct rebind
+    {
+	typedef ElementAllocator<U> other;
+    };
+
+public:
+    ElementAllocator (ElementArena* arena) :
+	m_arena (arena)
+    {
+    }
+    template<typename U>
+    ElementAllocator (const ElementAllocator<U>& other) :
+	m_arena (other.GetArena ())
+    {
+    }
+    ElementArena* GetArena () const
+    {
+	return m_arena;
+    }
+
+    pointer allocate (size_type n, const void* = 0)
+    {
+	return static_cast<pointer> (m_arena->Allocate (n * sizeof (T)));
+    }
+    void deallocate (pointer, size_type)
+    {
+	// memory allocated from an arena is freed with the arena
+    }
+    void construct (pointer p, const T& value)
+    {
+	new (p) T (value);
+    }
+    void destroy (pointer p)
+    {
+	p->~T ();
+    }
+    pointer address (reference r) const
+    {
+	return &r;
+    }
+    const_pointer address (const_reference r) const
+    {
+	return &r;
+    }
+    size_type max_size () const
+    {
+	return numeric_limits<size_type>::max () / sizeof (T);
+    }
+
+private:
+    ElementArena* m_arena;
+};
+
+template<typename T, typename U>
+bool operator== (const ElementAllocator<T>& first,
+		 const ElementAllocator<U>& second)
+{
+    return first.GetArena () == second.GetArena ();
+}
+
+template<typename T, typename U>
+bool operator!= (const ElementAllocator<T>& first,
+		 const ElementAllocator<U>& second)
+{
+    return ! (first == second);
+}
+
+
+/**
+ * @{
+ * @name Element creation
+ * Creates an element in the arena current in the calling thread, or
+ * with boost::make_shared if there is none.
+ */
+template<typename T, typename A1>
+boost::shared_ptr<T> MakeElement (const A1& a1)
+{
+    ElementArena* arena = ElementArena::GetCurrent ();
+    return arena ?
+	boost::allocate_shared<T> (ElementAllocator<T> (arena), a1) :
+	boost::make_shared<T> (a1);
+}
+
+template<typename T, typename A1, typename A2>
+boost::shared_ptr<T> MakeElement (const A1& a1, const A2& a2)
+{
+    ElementArena* arena = ElementArena::GetCurrent ();
+    return arena ?
+	boost::allocate_shared<T> (ElementAllocator<T> (arena), a1, a2) :
+	boost::make_shared<T> (a1, a2);
+}
+
+template<typename T, typename A1, typename A2, typename A3>
+boost::shared_ptr<T> MakeElement (const A1& a1, const A2& a2, const A3& a3)
+{
+    ElementArena* arena = ElementArena::GetCurrent ();
+    return arena ?
+	boost::allocate_shared<T> (ElementAllocator<T> (arena), a1, a2, a3) :
+	boost::make_shared<T> (a1, a2, a3);
+}
+
+template<typename T, typename A1, typename A2, typename A3, typename A4>
+boost::shared_ptr<T> MakeElement (const A1& a1, const A2& a2, const A3& a3,
+				  const A4& a4)
+{
+    ElementArena* arena = ElementArena::GetCurrent ();
+    return arena ?
+	boost::allocate_shared<T> (
+	    ElementAllocator<T> (arena), a1, a2, a3, a4) :
+	boost::make_shared<T> (a1, a2, a3, a4);
+}
+
+template<typename T, typename A1, typename A2, typename A3, typename A4,
+	 typename A5>
+boost::shared_ptr<T> MakeElement (const A1& a1, const A2& a2, const A3& a3,
+				  const A4& a4, const A5& a5)
+{
+    ElementArena* arena = ElementArena::GetCurrent ();
+    return arena ?
+	boost::allocate_shared<T> (
+	    ElementAllocator<T> (arena), a1, a2, a3, a4, a5) :
+	boost::make_shared<T> (a1, a2, a3, a4, a5);
+}
+
+template<typename T, typename A1, typename A2, typename A3, typename A4,
+	 typename A5, typename A6>
+boost::shared_ptr<T> MakeElement (const A1& a1, const A2& a2, const A3& a3,
+				  const A4& a4, const A5& a5, const A6& a6)
+{
+    ElementArena* arena = ElementArena::GetCurrent ();
+    return arena ?
+	boost::allocate_shared<T> (
+	    ElementAllocator<T> (arena), a1, a2, a3, a4, a5, a6) :
+	boost::make_shared<T> (a1, a2, a3, a4, a5, a6);
+}
+/**@}*/
+
+
+#endif //__ELEMENT_ARENA_H__
+
+// Local Variables:
+// mode: c++
+// End:
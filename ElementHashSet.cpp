@@ -0,0 +1,84 @@
+/**
+ * @file   ElementHashSet.cpp
+ * @author Dan R. Lipsa
+ *
+ * Definitions for the ElementHashSet class.
+ */
+
+#include "Edge.h"
+#include "ElementHashSet.h"
+#include "Face.h"
+#include "OrientedEdge.h"
+#include "Vertex.h"
+
+
+// Private Functions
+// ======================================================================
+
+namespace
+{
+const Vertex& beginVertex (const Vertex& vertex)
+{
+    return vertex;
+}
+
+const Vertex& beginVertex (const Edge& edge)
+{
+    return edge.GetBegin ();
+}
+
+const Vertex& beginVertex (const Face& face)
+{
+    return face.GetOrientedEdge (0).GetBegin ();
+}
+
+/**
+ * Equivalent positions for Vertex::operator<
+ */
+bool fuzzyEq (const G3D::Vector3& first, const G3D::Vector3& second)
+{
+    return G3D::fuzzyEq (first.x, second.x) &&
+	G3D::fuzzyEq (first.y, second.y) &&
+	G3D::fuzzyEq (first.z, second.z);
+}
+} // namespace
+
+
+// Methods
+// ======================================================================
+
+template<typename T>
+bool ElementHashSet<T>::Insert (const boost::shared_ptr<T>& element)
+{
+    const Vertex& begin = beginVertex (*element);
+    if (Find (element->GetId (), begin.GetId (), begin.GetVector ()))
+	return false;
+    m_elements.insert (typename Elements::value_type (
+			   element->GetId (), element));
+    return true;
+}
+
+template<typename T>
+boost::shared_ptr<T> ElementHashSet<T>::Find (
+    size_t id, size_t beginId, const G3D::Vector3& begin) const
+{
+    pair<typename Elements::const_iterator,
+	typename Elements::const_iterator> range = m_elements.equal_range (id);
+    for (; range.first != range.second; ++range.first)
+    {
+	const Vertex& v = beginVertex (*range.first->second);
+	if (v.GetId () == beginId && fuzzyEq (v.GetVector (), begin))
+	    return range.first->second;
+    }
+    return boost::shared_ptr<T> ();
+}
+
+
+// Template instantiations
+// ======================================================================
+
+/** @cond */
+template class ElementHashSet<Vertex>;
+template class ElementHashSet<Edge>;
+template class ElementHashSet<Face>;
+/** @endcond */
@@ -0,0 +1,72 @@
+/**
+ * @file ElementHashSet.h
+ * @author Dan R. Lipsa
+ * @brief Vertices, edges or faces found by ID and position.
+ * @ingroup data model
+ */
+#ifndef __ELEMENT_HASH_SET_H__
+#define __ELEMENT_HASH_SET_H__
+
+class Edge;
+class Face;
+class Vertex;
+
+/**
+ * @brief Vertices, edges or faces found by ID and position.
+ *
+ * Used to find whether the duplicate of an element, translated
+ * to another domain of a torus model, was already created. An
+ * element and its duplicates have the same ID, so a hash on the ID
+ * leads to a few elements which are compared by the position and ID
+ * of their first vertex, component by component, with the fuzzy
+ * comparison used by VertexSet, EdgeSet and FaceSet.
+ */
+template<typename T>
+class ElementHashSet
+{
+public:
+    ElementHashSet ()
+    {
+    }
+    template<typename Iterator>
+    ElementHashSet (Iterator begin, Iterator end)
+    {
+	for (; begin != end; ++begin)
+	    Insert (*begin);
+    }
+    /**
+     * @return false if an element with the same ID and position
+     *         is already in the set
+     */
+    bool Insert (const boost::shared_ptr<T>& element);
+    /**
+     * @param id of the element
+     * @param beginId ID of the first vertex of the element, the ID of
+     *        the vertex itself for vertices
+     * @param begin position of the first vertex of the element
+     * @return the element or a null pointer if there is none
+     */
+    boost::shared_ptr<T> Find (
+	size_t id, size_t beginId, const G3D::Vector3& begin) const;
+    size_t size () const
+    {
+	return m_elements.size ();
+    }
+
+private:
+    typedef boost::unordered_multimap<size_t, boost::shared_ptr<T> > Elements;
+
+private:
+    Elements m_elements;
+};
+
+typedef ElementHashSet<Vertex> VertexHashSet;
+typedef ElementHashSet<Edge> EdgeHashSet;
+typedef ElementHashSet<Face> FaceHashSet;
+
+
+#endif //__ELEMENT_HASH_SET_H__
+
+// Local Variables:
+// mode: c++
+// End:
@@ -571,3 +571,26 @@ const char* AverageType::ToString (AverageType::Enum type)
     };
     return name[type];
 }
+
+// Methods MemoryCategory
+// ======================================================================
+const char* MemoryCategory::ToString (MemoryCategory::Enum category)
+{
+    const char* name[] = 
+    {
+        "vertices",
+        "edges",
+        "faces",
+        "bodies",
+        "attributes",
+        "parsing_data",
+        "stored_time_steps",
+        "bodies_along_time",
+        "t1s",
+        "histograms",
+        "regular_grids",
+        "textures"
+    };
+    RuntimeAssert (category < COUNT, "Invalid MemoryCategory: ", category);
+    return name[category];
+}
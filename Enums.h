@@ -755,6 +755,31 @@ struct AverageType
     static const char* ToString (AverageType::Enum type);
 };
 
+/**
+ * @brief Data structures for which memory usage is reported
+ * (@see MemoryUsage)
+ */
+struct MemoryCategory
+{
+    enum Enum
+    {
+        VERTICES,
+        EDGES,
+        FACES,
+        BODIES,
+        ATTRIBUTES,
+        PARSING_DATA,
+        STORED_TIME_STEPS,
+        BODIES_ALONG_TIME,
+        T1S,
+        HISTOGRAMS,
+        REGULAR_GRIDS,
+        TEXTURES,
+        COUNT
+    };
+    static const char* ToString (MemoryCategory::Enum category);
+};
+
 
 #endif //__ENUMS_H__
 
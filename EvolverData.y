@@ -232,6 +232,12 @@ class Attribute;
 %token <m_id> OR "||"
  /* method instance value */
 %token <m_id> '.'
+ /* first token read by the parser, @see ParsingDriver::ParseText */
+%token HEADER_START
+%token VERTICES_START
+%token EDGES_START
+%token FACES_START
+%token BODIES_START
 
  // operator precedence
 %right '='
@@ -329,6 +335,13 @@ bodies
     foam->Preprocess ();
     //foam->GetParsingData ().PrintTimeCheckpoint ("After bodies:");
 }
+/* the header and pieces of element sections parsed separately,
+ * @see SectionParser */
+| HEADER_START nlstar header
+| VERTICES_START nlstar vertex_list
+| EDGES_START nlstar edge_list
+| FACES_START nlstar face_list
+| BODIES_START nlstar body_list
 
 header
 : /* empty */
@@ -1317,25 +1330,37 @@ constraints
 }
 
 
+/* attributes that are not loaded are skipped (0 is ignored by PushBack) */
 user_attribute
 : ATTRIBUTE_ID INTEGER_VALUE
 {
-    $$ = new NameSemanticValue ($1, $2);
+    $$ = foam->GetParsingData ().IsAttributeLoaded ($1) ?
+	new NameSemanticValue ($1, $2) : 0;
 }
 | ATTRIBUTE_ID REAL_VALUE
 {
-    $$ =
-	new NameSemanticValue ($1, $2);
+    $$ = foam->GetParsingData ().IsAttributeLoaded ($1) ?
+	new NameSemanticValue ($1, $2) : 0;
 }
 | ATTRIBUTE_ID '{' comma_integer_list '}'
 {
-    $$ =
-	new NameSemanticValue ($1, $3);
+    if (foam->GetParsingData ().IsAttributeLoaded ($1))
+	$$ = new NameSemanticValue ($1, $3);
+    else
+    {
+	delete $3;
+	$$ = 0;
+    }
 }
 | ATTRIBUTE_ID '{' comma_real_list '}'
 {
-    $$ =
-	new NameSemanticValue ($1, $3);
+    if (foam->GetParsingData ().IsAttributeLoaded ($1))
+	$$ = new NameSemanticValue ($1, $3);
+    else
+    {
+	delete $3;
+	$$ = 0;
+    }
 }
 
 edges
@@ -54,6 +54,11 @@ string ExpressionTreeNumber::ToString ()
     return ostr.str ();
 }
 
+void ExpressionTreeNumber::Compile (ExpressionProgram* program) const
+{
+    program->AddNumber (m_value);
+}
+
 // ExpressionTreeVariable
 // ======================================================================
 ExpressionTreeVariable::ExpressionTreeVariable (
@@ -99,6 +104,11 @@ bool ExpressionTreeVariable::IsCoordinate () const
     return m_name == "x" || m_name == "y" || m_name == "z";
 }
 
+void ExpressionTreeVariable::Compile (ExpressionProgram* program) const
+{
+    program->AddVariable (m_name.c_str (), m_parsingData);
+}
+
 // ExpressionTreeArrayElement
 // ======================================================================
 ExpressionTreeArrayElement::ExpressionTreeArrayElement (
@@ -135,6 +145,12 @@ string ExpressionTreeArrayElement::ToString ()
     return ostr.str ();
 }
 
+void ExpressionTreeArrayElement::Compile (ExpressionProgram* program) const
+{
+    // arrays do not change after parsing, see GetSimplifiedTree
+    program->AddNumber (m_parsingData.GetArrayValue (m_name, m_index));
+}
+
 
 // ExpressionTreeUnaryFunction
 // ======================================================================
@@ -183,6 +199,12 @@ string ExpressionTreeUnaryFunction::ToString ()
     return ostr.str ();
 }
 
+void ExpressionTreeUnaryFunction::Compile (ExpressionProgram* program) const
+{
+    m_param->Compile (program);
+    program->AddUnaryFunction (m_name.c_str (), m_parsingData);
+}
+
 // ExpressionTreeBinaryFunction
 // ======================================================================
 ExpressionTreeBinaryFunction::ExpressionTreeBinaryFunction (
@@ -252,6 +274,13 @@ string ExpressionTreeBinaryFunction::ToString ()
     return ostr.str ();
 }
 
+void ExpressionTreeBinaryFunction::Compile (ExpressionProgram* program) const
+{
+    m_first->Compile (program);
+    m_second->Compile (program);
+    program->AddBinaryFunction (m_name.c_str (), m_parsingData);
+}
+
 
 // ExpressionTreeConditional
 // ======================================================================
@@ -305,3 +334,193 @@ string ExpressionTreeConditional::ToString ()
 	 << m_third->ToParenthesisString ();
     return ostr.str ();
 }
+
+void ExpressionTreeConditional::Compile (ExpressionProgram* program) const
+{
+    m_first->Compile (program);
+    size_t jumpToThird = program->AddJump (ExpressionProgram::JUMP_IF_ZERO);
+    m_second->Compile (program);
+    size_t jumpToEnd = program->AddJump (ExpressionProgram::JUMP);
+    program->SetJumpTarget (jumpToThird);
+    m_third->Compile (program);
+    program->SetJumpTarget (jumpToEnd);
+}
+
+
+// ExpressionProgram
+// ======================================================================
+ExpressionProgram::ExpressionProgram (const ExpressionTree& tree) :
+    // a node needs at most one more stack slot than its height
+    m_stack (tree.Height () + 1)
+{
+    tree.Compile (this);
+}
+
+double ExpressionProgram::Value (double x, double y) const
+{
+    // top points after the last value on the stack
+    double* top = &m_stack[0];
+    for (size_t pc = 0; pc < m_code.size (); ++pc)
+    {
+	const Instruction& instruction = m_code[pc];
+	switch (instruction.m_opCode)
+	{
+	case NUMBER:
+	    *top++ = instruction.m_number;
+	    break;
+	case COORDINATE_X:
+	    *top++ = x;
+	    break;
+	case COORDINATE_Y:
+	    *top++ = y;
+	    break;
+	case VARIABLE:
+	    *top++ = *instruction.m_variable;
+	    break;
+	case PLUS:
+	    --top;
+	    top[-1] = top[-1] + top[0];
+	    break;
+	case MINUS:
+	    --top;
+	    top[-1] = top[-1] - top[0];
+	    break;
+	case TIMES:
+	    --top;
+	    top[-1] = top[-1] * top[0];
+	    break;
+	case DIVIDES:
+	    --top;
+	    top[-1] = top[-1] / top[0];
+	    break;
+	case GREATER:
+	    --top;
+	    top[-1] = top[-1] > top[0];
+	    break;
+	case GREATER_EQUAL:
+	    --top;
+	    top[-1] = top[-1] >= top[0];
+	    break;
+	case LESS:
+	    --top;
+	    top[-1] = top[-1] < top[0];
+	    break;
+	case LESS_EQUAL:
+	    --top;
+	    top[-1] = top[-1] <= top[0];
+	    break;
+	case LOGICAL_AND:
+	    --top;
+	    top[-1] = top[-1] && top[0];
+	    break;
+	case NEGATE:
+	    top[-1] = - top[-1];
+	    break;
+	case UNARY_FUNCTION:
+	    top[-1] = (*instruction.m_unaryFunction) (top[-1]);
+	    break;
+	case BINARY_FUNCTION:
+	    --top;
+	    top[-1] = (*instruction.m_binaryFunction) (top[-1], top[0]);
+	    break;
+	case JUMP_IF_ZERO:
+	    if (*--top == 0)
+		pc = instruction.m_target - 1;
+	    break;
+	case JUMP:
+	    pc = instruction.m_target - 1;
+	    break;
+	}
+    }
+    return top[-1];
+}
+
+void ExpressionProgram::AddNumber (double value)
+{
+    add (NUMBER);
+    m_code.back ().m_number = value;
+}
+
+void ExpressionProgram::AddVariable (
+    const char* name, const ParsingData& parsingData)
+{
+    if (strcasecmp (name, "x") == 0)
+	add (COORDINATE_X);
+    else if (strcasecmp (name, "y") == 0)
+	add (COORDINATE_Y);
+    else
+    {
+	ParsingData::VariableIt it = parsingData.GetVariableIt (name);
+	RuntimeAssert (it != parsingData.GetVariableItEnd (),
+		       "Undeclared variable: ", name);
+	add (VARIABLE);
+	m_code.back ().m_variable = &it->second;
+    }
+}
+
+void ExpressionProgram::AddUnaryFunction (
+    const char* name, const ParsingData& parsingData)
+{
+    if (strcmp (name, "-") == 0)
+	add (NEGATE);
+    else
+    {
+	ParsingData::UnaryFunctionIt it = parsingData.GetUnaryFunctionIt (name);
+	RuntimeAssert (it != parsingData.GetUnaryFunctionItEnd (),
+		       "Undefined unary function: ", name);
+	add (UNARY_FUNCTION);
+	m_code.back ().m_unaryFunction = &it->second;
+    }
+}
+
+void ExpressionProgram::AddBinaryFunction (
+    const char* name, const ParsingData& parsingData)
+{
+    // the same operations as the functions in ParsingData
+    struct
+    {
+	const char* m_name;
+	OpCode m_opCode;
+    } OPERATORS[] = {
+	{"+", PLUS},
+	{"-", MINUS},
+	{"*", TIMES},
+	{"/", DIVIDES},
+	{"=", MINUS},
+	{">", GREATER},
+	{">=", GREATER_EQUAL},
+	{"<", LESS},
+	{"<=", LESS_EQUAL},
+	{"&&", LOGICAL_AND}
+    };
+    for (size_t i = 0; i < sizeof (OPERATORS) / sizeof (OPERATORS[0]); ++i)
+	if (strcmp (name, OPERATORS[i].m_name) == 0)
+	{
+	    add (OPERATORS[i].m_opCode);
+	    return;
+	}
+    ParsingData::BinaryFunctionIt it = parsingData.GetBinaryFunctionIt (name);
+    RuntimeAssert (it != parsingData.GetBinaryFunctionItEnd (),
+		   "Undefined binary function: ", name);
+    add (BINARY_FUNCTION);
+    m_code.back ().m_binaryFunction = &it->second;
+}
+
+size_t ExpressionProgram::AddJump (OpCode opCode)
+{
+    add (opCode);
+    return m_code.size () - 1;
+}
+
+void ExpressionProgram::SetJumpTarget (size_t jump)
+{
+    m_code[jump].m_target = m_code.size ();
+}
+
+void ExpressionProgram::add (OpCode opCode)
+{
+    Instruction instruction;
+    instruction.m_opCode = opCode;
+    instruction.m_target = 0;
+    m_code.push_back (instruction);
+}
@@ -8,6 +8,7 @@
 #define __EXPRESSION_TREE_H__
 
 #include "ParsingData.h"
+class ExpressionProgram;
 
 /**
  * @brief Types of nodes in an expression tree
@@ -65,6 +66,11 @@ public:
     {
 	return false;
     }
+    /**
+     * Appends the instructions that calculate the value of the tree
+     * to a program. Names are resolved at this point.
+     */
+    virtual void Compile (ExpressionProgram* program) const = 0;
 
     string ToParenthesisString ();
     bool IsProperBinaryFunction () const;
@@ -97,6 +103,7 @@ public:
 	return ExpressionTreeType::NUMBER;
     }
     virtual string ToString ();
+    virtual void Compile (ExpressionProgram* program) const;
 private:
     /**
      * Value of the nubmber node
@@ -127,6 +134,7 @@ public:
 	return ExpressionTreeType::VARIABLE;
     }
     virtual string ToString ();
+    virtual void Compile (ExpressionProgram* program) const;
     bool IsCoordinate () const;
 private:
     /**
@@ -156,6 +164,7 @@ public:
 	return ExpressionTreeType::ARRAY_ELEMENT;
     }
     virtual string ToString ();
+    virtual void Compile (ExpressionProgram* program) const;
 private:
     /**
      * Variable name
@@ -200,6 +209,7 @@ public:
 	return ExpressionTreeType::UNARY_FUNCTION;
     }
     virtual string ToString ();
+    virtual void Compile (ExpressionProgram* program) const;
     virtual bool HasConditional ()
     {
 	return m_param->HasConditional ();
@@ -247,6 +257,7 @@ public:
 	return ExpressionTreeType::BINARY_FUNCTION;
     }
     virtual string ToString ();
+    virtual void Compile (ExpressionProgram* program) const;
     virtual bool HasConditional ()
     {
 	return m_first->HasConditional () || m_second->HasConditional ();
@@ -294,6 +305,7 @@ public:
 	return ExpressionTreeType::CONDITIONAL;
     }
     virtual string ToString ();
+    virtual void Compile (ExpressionProgram* program) const;
     virtual bool HasConditional ()
     {
 	return true;
@@ -305,6 +317,87 @@ private:
 };
 
 
+/**
+ * @brief Flat form of an ExpressionTree, evaluated without virtual calls
+ * or name lookups.
+ *
+ * The program is a list of instructions for a stack machine. Variables
+ * are resolved to the address of their value and array elements to
+ * their value when the program is compiled. The coordinates x and y are
+ * the parameters of Value. A program gives the same results as the
+ * tree it was compiled from with x and y set as variables. Value is not
+ * thread safe, as it uses a stack stored in the program.
+ */
+class ExpressionProgram
+{
+public:
+    enum OpCode
+    {
+	NUMBER,
+	COORDINATE_X,
+	COORDINATE_Y,
+	VARIABLE,
+	PLUS,
+	MINUS,
+	TIMES,
+	DIVIDES,
+	GREATER,
+	GREATER_EQUAL,
+	LESS,
+	LESS_EQUAL,
+	LOGICAL_AND,
+	NEGATE,
+	UNARY_FUNCTION,
+	BINARY_FUNCTION,
+	JUMP_IF_ZERO,
+	JUMP
+    };
+
+public:
+    ExpressionProgram (const ExpressionTree& tree);
+    double Value (double x, double y) const;
+
+    /**
+     * @{
+     * @name Used by ExpressionTree::Compile
+     */
+    void AddNumber (double value);
+    void AddVariable (const char* name, const ParsingData& parsingData);
+    void AddUnaryFunction (const char* name, const ParsingData& parsingData);
+    void AddBinaryFunction (const char* name, const ParsingData& parsingData);
+    /**
+     * @return the jump that needs a target
+     */
+    size_t AddJump (OpCode opCode);
+    /**
+     * The next instruction added is the target of the jump.
+     */
+    void SetJumpTarget (size_t jump);
+    // @}
+
+private:
+    struct Instruction
+    {
+	OpCode m_opCode;
+	union
+	{
+	    double m_number;
+	    const double* m_variable;
+	    const ParsingData::UnaryFunction* m_unaryFunction;
+	    const ParsingData::BinaryFunction* m_binaryFunction;
+	    size_t m_target;
+	};
+    };
+
+private:
+    void add (OpCode opCode);
+
+private:
+    vector<Instruction> m_code;
+    mutable vector<double> m_stack;
+};
+
+
 inline ostream& operator<< (ostream& ostr, ExpressionTree& t)
 {
     return ostr << t.ToString ();
@@ -12,6 +12,7 @@
 #include "DataProperties.h"
 #include "Debug.h"
 #include "Edge.h"
+#include "ElementArena.h"
 #include "Utils.h"
 #include "Face.h"
 #include "OrientedEdge.h"
@@ -58,7 +59,7 @@ public:
             reversed = true;
         }
         i--;
-        return boost::make_shared<OrientedEdge> (m_edges[i], reversed);
+        return MakeElement<OrientedEdge> (m_edges[i], reversed);
     }
 private:
     /**
@@ -74,7 +75,8 @@ Face::Face (const boost::shared_ptr<Edge>& edge, size_t id) :
     m_perimeter (0),
     m_area (0)
 {
-    m_orientedEdges.push_back (boost::make_shared<OrientedEdge> (edge, false));
+    m_orientedEdges.push_back (
+	MakeElement<OrientedEdge> (edge, false));
 }
 
 Face::Face (const Face& original) :
@@ -87,7 +89,8 @@ Face::Face (const Face& original) :
 {
     m_orientedFace.reset ();
     BOOST_FOREACH (boost::shared_ptr<OrientedEdge> oe, original.m_orientedEdges)
-	m_orientedEdges.push_back (boost::make_shared<OrientedEdge> (*oe));
+	m_orientedEdges.push_back (
+	    MakeElement<OrientedEdge> (*oe));
 }
 
 Face::Face (const vector<int>& edgeIndexes,
@@ -117,7 +120,7 @@ Face::Face (const vector<boost::shared_ptr<Edge> >& edges, size_t id) :
     m_adjacentBodies.reserve (2);
     m_orientedEdges.resize (edges.size ());
     for (size_t i = 0; i < edges.size (); ++i)
-	m_orientedEdges[i].reset (new OrientedEdge (edges[i], false));
+	m_orientedEdges[i] = MakeElement<OrientedEdge> (edges[i], false);
     CalculateCentroidAndArea ();
 }
 
@@ -356,30 +359,25 @@ void Face::GetEdgeSet (EdgeSet* edgeSet) const
 
 boost::shared_ptr<Face> Face::GetDuplicate (
     const OOBox& periods, const G3D::Vector3int16& translation,
-    VertexSet* vertexSet, EdgeSet* edgeSet, FaceSet* faceSet) const
+    VertexHashSet* vertexSet, EdgeHashSet* edgeSet, FaceHashSet* faceSet) const
 {
     const Vertex& begin = GetOrientedEdge (0).GetBegin ();
     const G3D::Vector3& newBegin = 
 	periods.TorusTranslate (begin.GetVector (), translation);
-    boost::shared_ptr<Face> searchDummy =
-	boost::make_shared<Face> (
-	    boost::make_shared<Edge> (
-		boost::make_shared<Vertex> (
-		    newBegin, begin.GetId ()), 0), GetId ());
-    FaceSet::iterator it = faceSet->find (searchDummy);
-    if (it != faceSet->end ())
-	return *it;
-    boost::shared_ptr<Face> duplicate = this->createDuplicate (
-	periods, newBegin, vertexSet, edgeSet);
-    faceSet->insert (duplicate);
+    boost::shared_ptr<Face> duplicate = faceSet->Find (
+	GetId (), begin.GetId (), newBegin);
+    if (duplicate)
+	return duplicate;
+    duplicate = this->createDuplicate (periods, newBegin, vertexSet, edgeSet);
+    faceSet->Insert (duplicate);
     return duplicate;
 }
 
 boost::shared_ptr<Face> Face::createDuplicate (
     const OOBox& periods, const G3D::Vector3& newBegin,
-    VertexSet* vertexSet, EdgeSet* edgeSet) const
+    VertexHashSet* vertexSet, EdgeHashSet* edgeSet) const
 {
-    boost::shared_ptr<Face> faceDuplicate = boost::make_shared<Face> (*this);
+    boost::shared_ptr<Face> faceDuplicate = MakeElement<Face> (*this);
     faceDuplicate->SetDuplicateStatus (ElementStatus::DUPLICATE);
     G3D::Vector3 begin = newBegin;
     BOOST_FOREACH (boost::shared_ptr<OrientedEdge> oe,
@@ -409,7 +407,7 @@ void Face::UpdateAdjacentFaceStandalone (boost::shared_ptr<Face> face)
 	 * for the list of faces part of each edge because AdjacentOrientedFace
 	 * stores a weak_ptr to the OrientedFace
 	 */
-	m_orientedFace.reset (new OrientedFace (face, false));
+	m_orientedFace = MakeElement<OrientedFace> (face, false);
 	for (size_t i = 0; i < size (); i++)
 	{
 	    boost::shared_ptr<OrientedEdge> oe = GetOrientedEdgePtr (i);
@@ -420,7 +418,8 @@ void Face::UpdateAdjacentFaceStandalone (boost::shared_ptr<Face> face)
 
 void Face::AddEdge (boost::shared_ptr<Edge> edge)
 {
-    boost::shared_ptr<OrientedEdge> oe (new OrientedEdge (edge, false));
+    boost::shared_ptr<OrientedEdge> oe = 
+	MakeElement<OrientedEdge> (edge, false);
     m_orientedEdges.push_back (oe);
 }
 
@@ -450,6 +449,17 @@ bool Face::HasConstraints () const
     return HasAttribute (FaceAttributeIndex::CONSTRAINTS);
 }
 
+size_t Face::GetMemorySize () const
+{
+    size_t size = sizeof (Face) + 
+	m_orientedEdges.capacity () * sizeof (boost::shared_ptr<OrientedEdge>) +
+	m_orientedEdges.size () * sizeof (OrientedEdge) +
+	m_adjacentBodies.capacity () * sizeof (AdjacentBody);
+    if (m_orientedFace)
+	size += sizeof (OrientedFace);
+    return size;
+}
+
 size_t Face::GetConstraintIndex (size_t i) const
 {
     return GetAttribute<IntegerArrayAttribute, 
@@ -10,6 +10,7 @@
 
 #include "Element.h"
 #include "Comparisons.h"
+#include "ElementHashSet.h"
 #include "AdjacentBody.h"
 
 class AttributesInfo;
@@ -97,7 +98,8 @@ public:
     }
     boost::shared_ptr<Face> GetDuplicate (
 	const OOBox& periods, const G3D::Vector3int16& translation,
-	VertexSet* vertexSet, EdgeSet* edgeSet, FaceSet* faceSet) const;
+	VertexHashSet* vertexSet, EdgeHashSet* edgeSet,
+	FaceHashSet* faceSet) const;
     const OrientedEdge& GetOrientedEdge (size_t i) const
     {
 	return *m_orientedEdges[i];
@@ -137,11 +139,16 @@ public:
     size_t GetEdgesPerFace (bool is2D) const;
     size_t GetConstraintIndex (size_t i = 0) const;
     bool HasConstraints () const;
+    /**
+     * @return bytes used by this face and its oriented edges, without
+     *         attributes
+     */
+    size_t GetMemorySize () const;
     
 private:
     boost::shared_ptr<Face> createDuplicate (
 	const OOBox& periods, const G3D::Vector3& newBegin,
-	VertexSet* vertexSet, EdgeSet* edgeSet) const;
+	VertexHashSet* vertexSet, EdgeHashSet* edgeSet) const;
     double getMaxEdgeLength ();
     /**
      * Calculate a orthogonal system, where XY is on the face and Z is normal
@@ -150,6 +157,7 @@ private:
     void calculateAxes (
 	G3D::Vector3* x, G3D::Vector3* y, G3D::Vector3* z) const;
     size_t largestEdgeIndex () const;
+    friend class FoamSnapshot;
 
 private:
     /**
@@ -7,19 +7,24 @@
 #include "Attribute.h"
 #include "AttributeInfo.h"
 #include "AttributeCreator.h"
+#include "Benchmark.h"
 #include "Body.h"
 #include "BodySelector.h"
 #include "ConstraintEdge.h"
 #include "Debug.h"
 #include "Edge.h"
+#include "ElementArena.h"
 #include "ExpressionTree.h"
 #include "Face.h"
 #include "Foam.h"
+#include "FoamArrays.h"
+#include "MemoryUsage.h"
 #include "Utils.h"
 #include "OrientedEdge.h"
 #include "OrientedFace.h"
 #include "ParsingData.h"
 #include "ProcessBodyTorus.h"
+#include "SectionParser.h"
 #include "VectorOperation.h"
 #include "Vertex.h"
 #include "Simulation.h"
@@ -49,6 +54,20 @@ void copyStandalone (const vector< boost::shared_ptr<Element> >& source,
 }
 
 
+/**
+ * Runs f on each body in parallel. Used when a time step has more
+ * bodies than there are time steps to process in parallel. f may
+ * write only to the body it is called with and may read other bodies
+ * and the faces, edges and vertices only if no f call writes
+ * them. Unwrapping relinks shared faces, so only its first phase
+ * runs this way (@see ProcessBodyTorus).
+ */
+template <typename F>
+void forEachBody (Foam::Bodies& bodies, F f)
+{
+    QtConcurrent::blockingMap (bodies.begin (), bodies.end (), f);
+}
+
 G3D::Vector3* Vector3Address (G3D::Vector3& v)
 {
     return &v;
@@ -89,13 +108,21 @@ Foam::Foam (bool useOriginal,
 		       useOriginal, dmpObjectInfo, forcesNames)),
     m_histogramScalar (
 	BodyScalar::COUNT, HistogramStatistics (HISTOGRAM_INTERVALS)),
-    m_properties (dataProperties),
+    m_properties (paramsOp == OWN_DATA_PROPERTIES ? 
+		  &m_ownProperties : &dataProperties),
     m_parametersOperation (paramsOp),
-    m_pressureSubtraction (0)
+    m_pressureSubtraction (0),
+    m_geometryReleased (false)
 {
     m_parsingData->SetVariable ("pi", M_PI);
 }
 
+Foam::~Foam ()
+{
+    if (m_arena)
+	ReleaseGeometry ();
+}
+
 template <typename Accumulator>
 void Foam::AccumulateProperty (Accumulator* acc, 
 			       BodyScalar::Enum property) const
@@ -117,17 +144,28 @@ void Foam::Accumulate (Accumulator* acc, GetBodyScalar getBodyScalar) const
     }
 }
 
-double Foam::CalculateMedian (BodyScalar::Enum property)
+double Foam::CalculateMedian (BodyScalar::Enum property) const
+{
+    return CalculateQuantile (property, 0.5);
+}
+
+double Foam::CalculateQuantile (
+    BodyScalar::Enum property, double fraction) const
 {
-    MedianStatistics median;
-    AccumulateProperty (&median, property);
-    return acc::median (median);
+    ValueCollector values;
+    AccumulateProperty (&values, property);
+    return values.Quantile (fraction);
 }
 
 
 void Foam::SetBody (size_t i, vector<int>& faces,
                     vector<NameSemanticValue*>& attributes, bool useOriginal)
 {
+    if (GetParsingData ().GetSectionRecords () != 0)
+    {
+	GetParsingData ().GetSectionRecords ()->AddBody (i, faces, attributes);
+	return;
+    }
     resizeAllowIndex (&m_bodies, i);
     boost::shared_ptr<Body> body = boost::make_shared<Body> (
 	faces, GetParsingData ().GetFaces (), i);
@@ -159,6 +197,57 @@ void Foam::ReleaseParsingData ()
     m_parsingData.reset ();
 }
 
+void Foam::ReleaseGeometry ()
+{
+    if (m_geometryReleased)
+	return;
+    for_each (m_bodies.begin (), m_bodies.end (),
+	      boost::bind (&Body::ReleaseGeometry, _1));
+    for_each (m_objects.begin (), m_objects.end (),
+	      boost::bind (&Body::ReleaseGeometry, _1));
+    Edges ().swap (m_standaloneEdges);
+    vector< boost::shared_ptr<Edges> > ().swap (m_constraintEdges);
+    Faces ().swap (m_standaloneFaces);
+    m_constraintFaces.clear ();
+    // no element allocated from the arena is left
+    m_parsingData.reset ();
+    m_arena.reset ();
+    m_geometryReleased = true;
+}
+
+void Foam::RestoreGeometry (Foam* loaded)
+{
+    RuntimeAssert (loaded->m_bodies.size () == m_bodies.size (),
+		   "Different number of bodies after reloading", 
+		   GetDmpName ());
+    for (size_t i = 0; i < m_bodies.size (); ++i)
+    {
+	const Body& released = *m_bodies[i];
+	Body& body = *loaded->m_bodies[i];
+	RuntimeAssert (released.GetId () == body.GetId (),
+		       "Different body after reloading", GetDmpName (), 
+		       "body", body.GetId ());
+	body.SetVelocity (released.GetVelocity ());
+	if (released.HasScalarValue (BodyScalar::PRESSURE))
+	    body.SetPressureValue (
+		released.GetScalarValue (BodyScalar::PRESSURE));
+    }
+    m_bodies.swap (loaded->m_bodies);
+    m_objects.swap (loaded->m_objects);
+    m_forces.swap (loaded->m_forces);
+    m_standaloneEdges.swap (loaded->m_standaloneEdges);
+    m_constraintEdges.swap (loaded->m_constraintEdges);
+    m_standaloneFaces.swap (loaded->m_standaloneFaces);
+    m_constraintFaces.swap (loaded->m_constraintFaces);
+    m_arena.swap (loaded->m_arena);
+    m_geometryReleased = false;
+}
+
+void Foam::CreateArena ()
+{
+    m_arena.reset (new ElementArena ());
+}
+
 void Foam::updateAdjacent ()
 {
     for_each (m_bodies.begin (), m_bodies.end (),
@@ -176,8 +265,7 @@ void Foam::updateAdjacent ()
 void Foam::CalculateBoundingBox ()
 {
     G3D::Vector3 low, high;
-    for_each (m_bodies.begin (), m_bodies.end (),
-	      boost::bind (&Body::CalculateBoundingBox, _1));
+    forEachBody (m_bodies, boost::bind (&Body::CalculateBoundingBox, _1));
 
     // using the BB for bodies to calculate BB for the foam does not
     // work when there are no bodies
@@ -219,35 +307,46 @@ void Foam::calculateBoundingBoxTorus (G3D::Vector3* low, G3D::Vector3* high)
 
 void Foam::calculateBodyCenters ()
 {
-    for_each (m_bodies.begin (), m_bodies.end (), 
-	      boost::bind(&Body::CalculateCenter, _1));
+    forEachBody (m_bodies, boost::bind (&Body::CalculateCenter, _1));
 }
 
 
-void Foam::unwrap (VertexSet* vertexSet, EdgeSet* edgeSet, FaceSet* faceSet)
+void Foam::unwrap (
+    VertexHashSet* vertexSet, EdgeHashSet* edgeSet, FaceHashSet* faceSet)
 {
     BOOST_FOREACH (boost::shared_ptr<Vertex> v, GetParsingData ().GetVertices ())
     {
-	vertexSet->insert (v);
+	vertexSet->Insert (v);
     }
     BOOST_FOREACH (boost::shared_ptr<Edge> e, GetParsingData ().GetEdges ())
     {
 	unwrap (e, vertexSet);
-	edgeSet->insert (e);
+	edgeSet->Insert (e);
     }
     BOOST_FOREACH (boost::shared_ptr<Face> f, GetParsingData ().GetFaces ())
     {
 	unwrap (f, vertexSet, edgeSet);
 	f->SetNormal ();
-	faceSet->insert (f);
+	faceSet->Insert (f);
     }
+    // the translations of the faces of each body are found in
+    // parallel as this only reads the faces. A body links the faces
+    // it shares with other bodies to their duplicates, and the
+    // duplicate used depends on the order, so this is done serially,
+    // in body order.
+    vector< boost::shared_ptr<ProcessBodyTorus> > bodies;
     BOOST_FOREACH (boost::shared_ptr<Body> b, GetBodies ())
-    {
-	unwrap (b, vertexSet, edgeSet, faceSet);
-    }
+	bodies.push_back (boost::shared_ptr<ProcessBodyTorus> (
+			      new ProcessBodyTorus (*this, b)));
+    QtConcurrent::blockingMap (
+	bodies.begin (), bodies.end (), 
+	boost::bind (&ProcessBodyTorus::CalculateTranslations, _1));
+    BOOST_FOREACH (boost::shared_ptr<ProcessBodyTorus> b, bodies)
+	b->LinkDuplicates (vertexSet, edgeSet, faceSet);
 }
 
-void Foam::unwrap (boost::shared_ptr<Edge> edge, VertexSet* vertexSet) const
+void Foam::unwrap (
+    boost::shared_ptr<Edge> edge, VertexHashSet* vertexSet) const
 {
     if (edge->GetEndTranslation () != Vector3int16Zero)
 	edge->SetEnd (
@@ -256,7 +355,7 @@ void Foam::unwrap (boost::shared_ptr<Edge> edge, VertexSet* vertexSet) const
 }
 
 void Foam::unwrap (boost::shared_ptr<Face> face,
-		   VertexSet* vertexSet, EdgeSet* edgeSet) const
+		   VertexHashSet* vertexSet, EdgeHashSet* edgeSet) const
 {
     Face::OrientedEdges& orientedEdges = face->GetOrientedEdges ();
     G3D::Vector3 begin = (*orientedEdges.begin())->GetBeginVector ();
@@ -273,14 +372,6 @@ void Foam::unwrap (boost::shared_ptr<Face> face,
     face->CalculateCentroidAndArea ();
 }
 
-void Foam::unwrap (
-    boost::shared_ptr<Body> body,
-    VertexSet* vertexSet, EdgeSet* edgeSet, FaceSet* faceSet) const
-{
-    ProcessBodyTorus(*this, body).Unwrap (vertexSet, edgeSet, faceSet);
-}
-
-
 
 
 void Foam::copyStandaloneElements ()
@@ -291,9 +382,11 @@ void Foam::copyStandaloneElements ()
 
 void Foam::Preprocess ()
 {    
-    VertexSet vertexSet;
-    EdgeSet edgeSet;
-    FaceSet faceSet;
+    BenchmarkPhase benchmarkPhase ("Foam::Preprocess", 
+				   Benchmark::PER_TIME_STEP);
+    VertexHashSet vertexSet;
+    EdgeHashSet edgeSet;
+    FaceHashSet faceSet;
     const DmpObjectInfo& dmpObjectInfo = GetParsingData ().GetDmpObjectInfo ();
     if (dmpObjectInfo.RotationUsed ())
 	SetDmpObjectPosition (dmpObjectInfo);
@@ -304,8 +397,9 @@ void Foam::Preprocess ()
 	unwrap (&vertexSet, &edgeSet, &faceSet);
     else
     {
-	GetFaceSet (&faceSet);
-	BOOST_FOREACH (const boost::shared_ptr<Face>& f, faceSet)
+	FaceSet faces;
+	GetFaceSet (&faces);
+	BOOST_FOREACH (const boost::shared_ptr<Face>& f, faces)
 	    f->SetNormal ();
     }
     calculateBodyCenters ();
@@ -319,9 +413,10 @@ void Foam::Preprocess ()
 
 void Foam::CalculateBodyNeighborsAndGrowthRate ()
 {
-    for_each (m_bodies.begin (), m_bodies.end (),
-	      boost::bind (&Body::CalculateNeighborsAndGrowthRate, _1, 
-			   GetTorusDomain (), Is2D ()));
+    // reads the centers and pressures of the neighbors, which do not change
+    forEachBody (m_bodies, 
+		 boost::bind (&Body::CalculateNeighborsAndGrowthRate, _1, 
+			      GetTorusDomain (), Is2D ()));
 }
 
 bool Foam::HasFreeFace () const
@@ -372,8 +467,8 @@ void Foam::StoreConstraintFaces ()
 
 void Foam::CalculateDeformationSimple ()
 {
-    for_each (m_bodies.begin (), m_bodies.end (),
-	      boost::bind (&Body::CalculateDeformationSimple, _1));
+    forEachBody (m_bodies, 
+		 boost::bind (&Body::CalculateDeformationSimple, _1));
 }
 
 
@@ -382,9 +477,9 @@ void Foam::CalculateDeformationTensor ()
     //MeasureTime t;
     // this prevents a unique body to be set as an object.
     if (m_bodies.size () > 1)
-	for_each (m_bodies.begin (), m_bodies.end (),
-		  boost::bind (&Body::CalculateDeformationTensor, _1, 
-			       GetTorusDomain ()));
+	forEachBody (m_bodies, 
+		     boost::bind (&Body::CalculateDeformationTensor, _1, 
+				  GetTorusDomain ()));
     //t.EndInterval ("eigen");
 }
 
@@ -419,9 +514,11 @@ void Foam::addConstraintEdges ()
     if (! Is2D ())
 	return;
     Bodies bodies = GetBodies ();
-    VertexSet vertexSet = GetVertexSet ();
-    EdgeSet edgeSet = GetEdgeSet ();
-    size_t lastEdgeId = GetLastEdgeId (edgeSet);
+    VertexSet vertices = GetVertexSet ();
+    EdgeSet edges = GetEdgeSet ();
+    size_t lastEdgeId = GetLastEdgeId (edges);
+    VertexHashSet vertexSet (vertices.begin (), vertices.end ());
+    EdgeHashSet edgeSet (edges.begin (), edges.end ());
     size_t dmpObjectConstraintIndex = GetParsingData ().
 	GetDmpObjectInfo ().m_constraintIndex;
     for (size_t i = 0; i < bodies.size (); ++i)
@@ -455,7 +552,8 @@ void Foam::addConstraintEdges ()
 
 boost::shared_ptr<ConstraintEdge> Foam::calculateConstraintEdge (
     boost::shared_ptr<Vertex> begin, boost::shared_ptr<Vertex> end,
-    size_t id, size_t bodyIndex, VertexSet* vertexSet, EdgeSet* edgeSet)
+    size_t id, size_t bodyIndex,
+    VertexHashSet* vertexSet, EdgeHashSet* edgeSet)
 {
     size_t constraintIndex = begin->GetConstraintIndex (0);
     // deal with the case when one of the vertices of the edge has 
@@ -480,9 +578,9 @@ boost::shared_ptr<ConstraintEdge> Foam::calculateConstraintEdge (
     }
     else
     {
-	return boost::shared_ptr<ConstraintEdge> (
-	    new ConstraintEdge (&GetParsingData (), begin, end, 
-				id, &m_constraintPointsToFix, bodyIndex));
+	return MakeElement<ConstraintEdge> (
+	    &GetParsingData (), begin, end,
+	    id, &m_constraintPointsToFix, bodyIndex);
     }
 }
 
@@ -490,11 +588,9 @@ boost::shared_ptr<ConstraintEdge> Foam::calculateConstraintEdge (
 bool Foam::isVectorOnConstraint (const G3D::Vector3& v, 
 				 size_t constraintIndex) const
 {
-    m_parsingData->SetVariable ("x", v.x);
-    m_parsingData->SetVariable ("y", v.y);
-    boost::shared_ptr<ExpressionTree> constraint = 
-	m_parsingData->GetConstraint (constraintIndex);
-    return G3D::fuzzyEq (constraint->Value (), 0);
+    const ExpressionProgram& constraint = 
+	m_parsingData->GetConstraintProgram (constraintIndex);
+    return G3D::fuzzyEq (constraint.Value (v.x, v.y), 0);
 }
 
 G3D::Vector3int16 Foam::getVectorOnConstraintTranslation (
@@ -629,12 +725,15 @@ void Foam::AddAttributeInfo (
     DefineAttribute::Enum type, const char* name,
     boost::shared_ptr<AttributeCreator> creator)
 {
-    m_attributesInfoElements.GetInfo (type).AddAttributeInfo (name, creator);
-    m_parsingData->AddAttribute (name);
+    AttributesInfo& infos = m_attributesInfoElements.GetInfo (type);
+    size_t index = m_parsingData->IsLoadAttribute (name) ?
+	infos.AddAttributeInfoLoad (name, creator) :
+	infos.AddAttributeInfo (name, creator);
+    m_parsingData->AddAttribute (name, index != INVALID_INDEX);
 }
 
 void Foam::bodiesInsideOriginalDomain (
-    VertexSet* vertexSet, EdgeSet* edgeSet, FaceSet* faceSet)
+    VertexHashSet* vertexSet, EdgeHashSet* edgeSet, FaceHashSet* faceSet)
 {
     for_each (m_bodies.begin (), m_bodies.end (),
 	      boost::bind (&Foam::bodyInsideOriginalDomain, this,
@@ -643,7 +742,7 @@ void Foam::bodiesInsideOriginalDomain (
 
 bool Foam::bodyInsideOriginalDomain (
     const boost::shared_ptr<Body>& body,
-    VertexSet* vertexSet, EdgeSet* edgeSet, FaceSet* faceSet)
+    VertexHashSet* vertexSet, EdgeHashSet* edgeSet, FaceHashSet* faceSet)
 {
     try
     {
@@ -665,7 +764,7 @@ bool Foam::bodyInsideOriginalDomain (
 
 void Foam::bodyTranslate (
     const boost::shared_ptr<Body>& body,const G3D::Vector3int16& translate,
-    VertexSet* vertexSet, EdgeSet* edgeSet, FaceSet* faceSet)
+    VertexHashSet* vertexSet, EdgeHashSet* edgeSet, FaceHashSet* faceSet)
 {
     BOOST_FOREACH (boost::shared_ptr<OrientedFace> of, body->GetOrientedFaces ())
     {
@@ -680,7 +779,7 @@ void Foam::bodyTranslate (
 
 Foam::Bodies::iterator Foam::BodyInsideOriginalDomainStep (
     Foam::Bodies::iterator begin,
-    VertexSet* vertexSet, EdgeSet* edgeSet, FaceSet* faceSet)
+    VertexHashSet* vertexSet, EdgeHashSet* edgeSet, FaceHashSet* faceSet)
 {
     Bodies::iterator it = begin;
     while (it != m_bodies.end () &&
@@ -771,13 +870,20 @@ void Foam::calculateMinMaxStatistics (BodyScalar::Enum property)
 void Foam::CalculateHistogramStatistics (BodyScalar::Enum property,
 					 double min, double max)
 {
+    ValueCollector values;
+    AccumulateProperty (&values, property);
+    CalculateHistogramStatistics (property, min, max, values);
+}
+
+void Foam::CalculateHistogramStatistics (
+    BodyScalar::Enum property, double min, double max, 
+    const ValueCollector& values)
+{
+    // start over if the histogram is calculated again
+    m_histogramScalar[property] = HistogramStatistics (HISTOGRAM_INTERVALS);
     m_histogramScalar[property](min);
     m_histogramScalar[property](max);
-    BOOST_FOREACH (const boost::shared_ptr<Body>& body, m_bodies)
-    {
-	if (body->HasScalarValue (property))
-	    m_histogramScalar[property] (body->GetScalarValue (property));
-    }
+    values.Accumulate (&m_histogramScalar[property]);
 }
 
 bool Foam::ExistsBodyWithValueIn (
@@ -886,10 +992,12 @@ void Foam::CreateObjectBody (size_t constraint)
     {
 	SortConstraintEdges (constraint);
 	size_t lastFaceId = GetLastFaceId ();
-	boost::shared_ptr<Face> face (
-	    new Face (GetConstraintEdges (constraint), ++lastFaceId));
-	VertexSet vertexSet = GetVertexSet ();
-	EdgeSet edgeSet = GetEdgeSet ();
+	boost::shared_ptr<Face> face = MakeElement<Face> (
+	    GetConstraintEdges (constraint), ++lastFaceId);
+	VertexSet vertices = GetVertexSet ();
+	EdgeSet edges = GetEdgeSet ();
+	VertexHashSet vertexSet (vertices.begin (), vertices.end ());
+	EdgeHashSet edgeSet (edges.begin (), edges.end ());
 	unwrap (face, &vertexSet, &edgeSet);
 	size_t lastBodyId = GetLastBodyId ();
 	boost::shared_ptr<Body> body (new Body (face,  lastBodyId + 1));
@@ -901,26 +1009,34 @@ void Foam::CreateObjectBody (size_t constraint)
 
 bool Foam::Is2D () const
 {
-    return m_properties.Is2D ();
+    return m_properties->Is2D ();
 }
 
 Dimension::Enum Foam::GetDimension () const
 {
-    return m_properties.GetDimension ();
+    return m_properties->GetDimension ();
 }
 
 
 bool Foam::IsQuadratic () const
 {
-    return m_properties.IsQuadratic ();
+    return m_properties->IsQuadratic ();
+}
+
+void Foam::SetDataProperties (DataProperties* dataProperties)
+{
+    RuntimeAssert (*dataProperties == GetDataProperties (),
+		   "Different data properties for", GetDmpName ());
+    m_properties = dataProperties;
+    m_parametersOperation = TEST_DATA_PROPERTIES;
 }
 
 void Foam::SetDimension (size_t spaceDimension)
 {
-    if (m_parametersOperation == SET_DATA_PROPERTIES)
-	m_properties.SetDimension (spaceDimension);
+    if (m_parametersOperation != TEST_DATA_PROPERTIES)
+	m_properties->SetDimension (spaceDimension);
     else
-	if (m_properties.GetDimension () != 
+	if (m_properties->GetDimension () != 
             Dimension::Enum (spaceDimension))
 	    ThrowException (
 		"Space dimension has to be the same for all time steps");
@@ -928,10 +1044,10 @@ void Foam::SetDimension (size_t spaceDimension)
 
 void Foam::SetQuadratic (bool quadratic)
 {
-    if (m_parametersOperation == SET_DATA_PROPERTIES)
-	m_properties.SetQuadratic (quadratic);
+    if (m_parametersOperation != TEST_DATA_PROPERTIES)
+	m_properties->SetQuadratic (quadratic);
     else
-	if (m_properties.IsQuadratic () != quadratic)
+	if (m_properties->IsQuadratic () != quadratic)
 	    ThrowException ("Edges have to be the same "
 			    "(quadratic or not) for all time steps");
 }
@@ -949,37 +1065,6 @@ void Foam::SetTorusDomain (const G3D::Vector3& x, const G3D::Vector3& y)
     SetTorusDomain (x, y, thirdLength * third);
 }
 
-void Foam::getTetraPoints (
-    vtkSmartPointer<vtkPoints>* tetraPoints,
-    vector<boost::shared_ptr<Vertex> >* sortedPoints,
-    size_t* maxId,
-    size_t* numberOfCells) const
-{
-    VertexSet vertexSet = GetVertexSet ();
-    *maxId = (*(--vertexSet.end ()))->GetId ();
-    *numberOfCells = 0;
-    vtkIdType bodyIndex = 0;
-    BOOST_FOREACH (const boost::shared_ptr<Body>& body, GetBodies ())
-    {
-	numberOfCells += body->GetOrientedFaces ().size ();
-	vertexSet.insert (
-	    boost::shared_ptr<Vertex> (new Vertex (body->GetCenter (), 
-						   *maxId + bodyIndex + 1)));
-	++bodyIndex;
-    }
-    sortedPoints->resize(vertexSet.size ());
-    copy (vertexSet.begin (), vertexSet.end (), sortedPoints->begin ());
-
-
-    *tetraPoints = vtkPoints::New ();
-    (*tetraPoints)->SetNumberOfPoints (sortedPoints->size ());
-    for (size_t i = 0; i < sortedPoints->size (); ++i)
-    {
-	G3D::Vector3 p = (*sortedPoints)[i]->GetVector ();
-	(*tetraPoints)->InsertPoint (i, p.x, p.y, p.z);
-    }
-}
-
 vtkSmartPointer<vtkUnstructuredGrid> Foam::addCellAttribute (
     vtkSmartPointer<vtkUnstructuredGrid> aTetraGrid,
     size_t attribute) const
@@ -1052,50 +1137,38 @@ void Foam::addRedundantAttribute (
 
 void Foam::createTetraCells (
     vtkSmartPointer<vtkUnstructuredGrid> aTetraGrid, 
-    const vector<boost::shared_ptr<Vertex> >& sortedPoints,
-    size_t maxPointId) const
+    const FoamArrays& arrays) const
 {
-    // create the cells
-    vtkIdType bodyIndex = 0;
-    BOOST_FOREACH (const boost::shared_ptr<Body>& body, GetBodies ())
+    // a tetrahedron for each face of a body and the center of the body
+    vtkIdType pointIds[4];
+    for (size_t body = 0; body < arrays.GetBodyCount (); ++body)
     {
-	boost::shared_ptr<Vertex> center (
-	    new Vertex (body->GetCenter (), maxPointId + bodyIndex + 1));
-	size_t centerIndex = FindVertex (sortedPoints, center);
-	BOOST_FOREACH (const boost::shared_ptr<OrientedFace>& of, 
-		       body->GetOrientedFaces ())
+	const int* faces = arrays.GetBodyFaces (body);
+	pointIds[3] = arrays.GetBodyCenter (body);
+	for (size_t j = 0; j < arrays.GetBodyFaceCount (body); ++j)
 	{
-	    VTK_CREATE(vtkTetra, aTetra);
 	    for (size_t i = 0; i < 3; i++)
-	    {
-		boost::shared_ptr<Vertex> point = of->GetBeginVertex (i);
-		size_t pi = FindVertex (sortedPoints, point);
-		aTetra->GetPointIds ()->SetId (i, pi);
-	    }
-	    aTetra->GetPointIds()->SetId(3, centerIndex);
-	    aTetraGrid->InsertNextCell(aTetra->GetCellType(), 
-				       aTetra->GetPointIds());
+		pointIds[i] = arrays.GetBeginVertex (faces[j], i);
+	    aTetraGrid->InsertNextCell (VTK_TETRA, 4, pointIds);
 	}
-	++bodyIndex;
     }
 }
 
 
 vtkSmartPointer<vtkUnstructuredGrid> Foam::getTetraGrid () const
 {
-    // create the points    
-    vtkSmartPointer<vtkPoints> tetraPoints;
-    vector<boost::shared_ptr<Vertex> > sortedPoints;
-    size_t maxPointId, numberOfCells;
-    getTetraPoints (&tetraPoints, &sortedPoints, &maxPointId, &numberOfCells);
+    FoamArrays arrays (*this);
+    size_t numberOfCells = 0;
+    for (size_t body = 0; body < arrays.GetBodyCount (); ++body)
+	numberOfCells += arrays.GetBodyFaceCount (body);
 
     // create the unstructured grid
     VTK_CREATE (vtkUnstructuredGrid, aTetraGrid);
     aTetraGrid->Allocate(numberOfCells, numberOfCells);
-    aTetraGrid->SetPoints(tetraPoints);
+    aTetraGrid->SetPoints(arrays.GetPoints ());
     
     // create the cells
-    createTetraCells (aTetraGrid, sortedPoints, maxPointId);
+    createTetraCells (aTetraGrid, arrays);
     // set the cell attributes
     for (size_t i = 0; i < BodyAttribute::COUNT; ++i)
 	if (! BodyAttribute::IsRedundant (i))
@@ -1108,7 +1181,7 @@ void Foam::SaveRegularGrid (size_t resolution,
 {
     string message = string ("Resampling ") + GetDmpName () + " ...\n";
     cdbg << message;
-    if (! QFile (getVtiPath ().c_str ()).exists ())
+    if (! IsRegularGridSaved ())
     {
 	vtkSmartPointer<vtkImageData> data = toRegularGrid (
             resolution, simulationBB);
@@ -1119,6 +1192,11 @@ void Foam::SaveRegularGrid (size_t resolution,
     }
 }
 
+bool Foam::IsRegularGridSaved () const
+{
+    return QFile (getVtiPath ().c_str ()).exists ();
+}
+
 vtkSmartPointer<vtkImageData> Foam::GetRegularGrid (size_t bodyAttribute) const
 {
     RuntimeAssert (bodyAttribute < BodyAttribute::COUNT, 
@@ -1221,6 +1299,35 @@ string Foam::GetInfo () const
     return ostr.str ();
 }
 
+void Foam::GetMemoryUsage (MemoryUsage* usage) const
+{
+    BOOST_FOREACH (const boost::shared_ptr<Vertex>& v, GetVertexSet ())
+    {
+	usage->Add (MemoryCategory::VERTICES, v->GetMemorySize ());
+	usage->Add (MemoryCategory::ATTRIBUTES, v->GetAttributesMemorySize ());
+    }
+    BOOST_FOREACH (const boost::shared_ptr<Edge>& e, GetEdgeSet ())
+    {
+	usage->Add (MemoryCategory::EDGES, e->GetMemorySize ());
+	usage->Add (MemoryCategory::ATTRIBUTES, e->GetAttributesMemorySize ());
+    }
+    BOOST_FOREACH (const boost::shared_ptr<Face>& f, GetFaceSet ())
+    {
+	usage->Add (MemoryCategory::FACES, f->GetMemorySize ());
+	usage->Add (MemoryCategory::ATTRIBUTES, f->GetAttributesMemorySize ());
+    }
+    BOOST_FOREACH (const boost::shared_ptr<Body>& b, m_bodies)
+    {
+	usage->Add (MemoryCategory::BODIES, b->GetMemorySize ());
+	usage->Add (MemoryCategory::ATTRIBUTES, b->GetAttributesMemorySize ());
+    }
+    if (m_parsingData)
+	usage->Add (MemoryCategory::PARSING_DATA,
+		    m_parsingData->GetMemorySize ());
+    BOOST_FOREACH (const HistogramStatistics& h, m_histogramScalar)
+	usage->Add (MemoryCategory::HISTOGRAMS, h.GetMemorySize ());
+}
+
 
 // Static and Friends Methods
 // ======================================================================
@@ -1254,6 +1361,8 @@ template void Foam::AccumulateProperty<MinMaxStatistics> (
     MinMaxStatistics* acc, BodyScalar::Enum property) const;
 template void Foam::AccumulateProperty<MeanStatistics> (
     MeanStatistics* acc, BodyScalar::Enum property) const;
+template void Foam::AccumulateProperty<ValueCollector> (
+    ValueCollector* acc, BodyScalar::Enum property) const;
 
 template void Foam::Accumulate<
     MinMaxStatistics, 
@@ -9,6 +9,8 @@
 
 #include "AttributeInfo.h"
 #include "Comparisons.h"
+#include "DataProperties.h"
+#include "ElementHashSet.h"
 #include "ParsingEnums.h"
 #include "Enums.h"
 #include "ForceOneObject.h"
@@ -22,9 +24,11 @@ class Body;
 class BodySelector;
 class ConstraintEdge;
 class Edge;
+class ElementArena;
 class Face;
+class FoamArrays;
+class MemoryUsage;
 class OrientedFace;
-class DataProperties;
 class NameSemanticValue;
 class ParsingData;
 
@@ -45,7 +49,13 @@ public:
     enum ParametersOperation 
     {
 	SET_DATA_PROPERTIES,
-	TEST_DATA_PROPERTIES
+	TEST_DATA_PROPERTIES,
+	/**
+	 * The foam sets its own data properties, so that files can be
+	 * parsed before the properties of the simulation are
+	 * known. @see SetDataProperties
+	 */
+	OWN_DATA_PROPERTIES
     };
 
 
@@ -57,6 +67,11 @@ public:
 	  const DmpObjectInfo& dmpObjectInfo,
 	  const vector<ForceNamesOneObject>& forcesNames,
 	  DataProperties& foamParameters, ParametersOperation paramsOp);
+    /**
+     * Bodies can outlive the Foam (@see BodyAlongTime) so their
+     * geometry is released before the arena is destroyed.
+     */
+    ~Foam ();
     void GetVertexSet (VertexSet* vertexSet) const;
     VertexSet GetVertexSet () const
     {
@@ -154,6 +169,42 @@ public:
      * Deletes the parsing data
      */
     void ReleaseParsingData ();
+    /**
+     * Deletes the vertices, edges and faces of the foam. Bodies are
+     * kept, without their geometry, together with the bounding box,
+     * the torus domain and the statistics for this time step.
+     * @see Simulation::SetResidentTimeSteps
+     */
+    void ReleaseGeometry ();
+    bool IsGeometryReleased () const
+    {
+	return m_geometryReleased;
+    }
+    /**
+     * Takes the geometry from a foam read again from the same DMP file
+     * and preprocessed the same way. Body values computed
+     * using other time steps (velocity and adjusted pressure) are kept.
+     */
+    void RestoreGeometry (Foam* loaded);
+    /**
+     * Vertices, edges, faces and their oriented versions created
+     * while the arena is current (@see ElementArena::Scope) are
+     * allocated from it and freed together. Bodies are allocated from
+     * the heap as they are kept after the geometry is released.
+     */
+    void CreateArena ();
+    ElementArena* GetArena () const
+    {
+	return m_arena.get ();
+    }
+    /**
+     * Constraint points are fixed using the previous time step
+     * (@see FixConstraintPoints)
+     */
+    bool HasConstraintPointsToFix () const
+    {
+	return ! m_constraintPointsToFix.empty ();
+    }
     /**
      * Stores information about an attribute.
      * @param type the type of attribute (@see DefineAttribute)
@@ -220,7 +271,8 @@ public:
      */
     Foam::Bodies::iterator BodyInsideOriginalDomainStep (
 	Foam::Bodies::iterator begin,
-	VertexSet* vertexSet, EdgeSet* edgeSet, FaceSet* faceSet);
+	VertexHashSet* vertexSet, EdgeHashSet* edgeSet,
+	FaceHashSet* faceSet);
     template <typename Accumulator>
     void AccumulateProperty (
 	Accumulator* acc, BodyScalar::Enum property) const;
@@ -231,7 +283,20 @@ public:
 
     void CalculateHistogramStatistics (BodyScalar::Enum property,
 				       double min, double max);
-    double CalculateMedian (BodyScalar::Enum property);
+    /**
+     * Same as above for the values of property already read from the
+     * bodies, in the order of the bodies.
+     */
+    void CalculateHistogramStatistics (
+	BodyScalar::Enum property, double min, double max,
+	const ValueCollector& values);
+    double CalculateMedian (BodyScalar::Enum property) const;
+    /**
+     * Exact quantile of property over the bodies of this time step.
+     * @param fraction in [0, 1], 0.5 is the median
+     */
+    double CalculateQuantile (BodyScalar::Enum property, 
+			      double fraction) const;
 
     const HistogramStatistics& GetHistogramScalar (BodyScalar::Enum property) const
     {
@@ -279,7 +344,7 @@ public:
     void FixConstraintPoints (const Foam* prevFoam);
     void StoreAttribute (Body* body, BodyScalar::Enum property, double r);
     /**
-     * @pre {adjustPressureAlignMedians executed}
+     * @pre {pressure medians aligned by Simulation::Preprocess}
      */
     void CalculateBodyNeighborsAndGrowthRate ();
     void StoreObjects ();
@@ -294,8 +359,13 @@ public:
     bool HasFreeFace () const;
     const DataProperties& GetDataProperties () const
     {
-	return m_properties;
+	return *m_properties;
     }
+    /**
+     * Shares the data properties of the simulation, after they were
+     * tested to be the same as the foam's own data properties.
+     */
+    void SetDataProperties (DataProperties* dataProperties);
     void SetDimension (size_t spaceDimension);
     void SetQuadratic (bool quadratic);
     vtkSmartPointer<vtkImageData> GetRegularGrid (size_t bodyAttribute) const;
@@ -309,6 +379,7 @@ public:
     string GetDmpName () const;
     void SaveRegularGrid (size_t regularGridResolution, 
                           const G3D::AABox& simulationBB) const;
+    bool IsRegularGridSaved () const;
     void StoreConstraintFaces ();
     vtkSmartPointer<vtkPolyData> GetConstraintFacesPolyData (
 	size_t constraintIndex) const;
@@ -321,11 +392,17 @@ public:
         return m_pressureSubtraction;
     }
     string GetInfo () const;
+    /**
+     * Adds the bytes used by the elements, attributes, parsing data
+     * and histograms of this time step.
+     */
+    void GetMemoryUsage (MemoryUsage* usage) const;
 
     /**
      * Pretty print the Foam object
      */
     friend ostream& operator<< (ostream& ostr, const Foam& d);
+    friend class FoamSnapshot;
 
 private:
     vtkSmartPointer<vtkUnstructuredGrid> getTetraGrid () const;
@@ -342,15 +419,9 @@ private:
     {
         return m_vtiPath;
     }
-    void getTetraPoints (
-	vtkSmartPointer<vtkPoints>* tetraPoints,
-	vector<boost::shared_ptr<Vertex> >* sortedPoints,
-	size_t* maxId,
-	size_t* gridSize) const;
     void createTetraCells (
 	vtkSmartPointer<vtkUnstructuredGrid> aTetraGrid,
-	const vector<boost::shared_ptr<Vertex> >& sortedPoints,
-	size_t maxId) const;
+	const FoamArrays& arrays) const;
     void setForceOneObject (
 	const ForceNamesOneObject& names, ForceOneObject* forces);
     void copyStandaloneElements ();
@@ -370,9 +441,11 @@ private:
     void updateAdjacent ();
     bool bodyInsideOriginalDomain (
 	const boost::shared_ptr<Body>& body,
-	VertexSet* vertexSet, EdgeSet* edgeSet, FaceSet* faceSet);
+	VertexHashSet* vertexSet, EdgeHashSet* edgeSet,
+	FaceHashSet* faceSet);
     void bodiesInsideOriginalDomain (
-	VertexSet* vertexSet, EdgeSet* edgeSet, FaceSet* faceSet);
+	VertexHashSet* vertexSet, EdgeHashSet* edgeSet,
+	FaceHashSet* faceSet);
 
     /**
      * Calculates the AABOX for the the foam and the 8 corners of the 
@@ -381,23 +454,24 @@ private:
     void calculateBoundingBoxTorus (G3D::Vector3* low, G3D::Vector3* high);
     void calculateMinMaxStatistics (BodyScalar::Enum property);
 
-    void unwrap (VertexSet* vertexSet, EdgeSet* edgeSet, FaceSet* faceSet);
-    void unwrap (boost::shared_ptr<Edge> edge, VertexSet* vertexSet) const;
+    void unwrap (VertexHashSet* vertexSet, EdgeHashSet* edgeSet,
+		 FaceHashSet* faceSet);
+    void unwrap (boost::shared_ptr<Edge> edge,
+		 VertexHashSet* vertexSet) const;
     void unwrap (boost::shared_ptr<Face> face, 
-		 VertexSet* vertexSet, EdgeSet* edgeSet) const;
-    void unwrap (boost::shared_ptr<Body> body,
-		 VertexSet* vertexSet, EdgeSet* edgeSet, 
-		 FaceSet* faceSet) const;
+		 VertexHashSet* vertexSet, EdgeHashSet* edgeSet) const;
     void bodyTranslate (
 	const boost::shared_ptr<Body>& body,
 	const G3D::Vector3int16& translate,
-	VertexSet* vertexSet, EdgeSet* edgeSet, FaceSet* faceSet);
+	VertexHashSet* vertexSet, EdgeHashSet* edgeSet,
+	FaceHashSet* faceSet);
     void setMissingPressureZero ();
     void setMissingVolume ();
     void addConstraintEdges ();
     boost::shared_ptr<ConstraintEdge> calculateConstraintEdge (
 	boost::shared_ptr<Vertex> begin, boost::shared_ptr<Vertex> end,
-	size_t id, size_t bodyIndex, VertexSet* vertexSet, EdgeSet* edgeSet);
+	size_t id, size_t bodyIndex,
+	VertexHashSet* vertexSet, EdgeHashSet* edgeSet);
     bool isVectorOnConstraint (const G3D::Vector3& v, 
 			       size_t constraintIndex) const;
     G3D::Vector3int16 getVectorOnConstraintTranslation (
@@ -409,6 +483,11 @@ public:
     static const double Z_COORDINATE_2D = 0.0;
 
 private:
+    /**
+     * Null if elements are allocated from the heap. It is declared
+     * first so that it is destroyed after the elements.
+     */
+    boost::shared_ptr<ElementArena> m_arena;
     /**
      * The torus original domain. 
      * Can be different for each time step, as in shear_160
@@ -455,11 +534,13 @@ private:
      * AdjacentBody, PointIndex for constraint points that need fixing.
      */
     vector< pair<size_t, size_t> > m_constraintPointsToFix;
-    DataProperties& m_properties;    
+    DataProperties* m_properties;    
+    DataProperties m_ownProperties;
     ParametersOperation m_parametersOperation;
     AttributesInfoElements m_attributesInfoElements;
     string m_vtiPath;
     float m_pressureSubtraction;
+    bool m_geometryReleased;
 };
 
 /**
@@ -0,0 +1,144 @@
+/**
+ * @file   FoamArrays.cpp
+ * @author Dan R. Lipsa
+ *
+ * Definitions for the FoamArrays class.
+ */
+
+#include "Body.h"
+#include "Debug.h"
+#include "Edge.h"
+#include "Face.h"
+#include "Foam.h"
+#include "FoamArrays.h"
+#include "OrientedEdge.h"
+#include "OrientedFace.h"
+#include "QuadraticEdge.h"
+#include "Utils.h"
+#include "Vertex.h"
+
+
+// Private Functions
+// ======================================================================
+
+namespace
+{
+/**
+ * @return the 1-based index, negative if reversed
+ */
+int signedIndex (size_t index, bool reversed)
+{
+    int i = index + 1;
+    return reversed ? -i : i;
+}
+} // namespace
+
+
+// Methods
+// ======================================================================
+
+FoamArrays::FoamArrays (const Foam& foam) :
+    m_points (vtkSmartPointer<vtkFloatArray>::New ()),
+    m_faceOffsets (1, 0),
+    m_bodyOffsets (1, 0)
+{
+    const Foam::Bodies& bodies = foam.GetBodies ();
+    BOOST_FOREACH (const boost::shared_ptr<Body>& body, bodies)
+    {
+	BOOST_FOREACH (const boost::shared_ptr<OrientedFace>& of,
+		       body->GetOrientedFaces ())
+	    m_bodyFaces.push_back (
+		signedIndex (addFace (*of->GetFace ()), of->IsReversed ()));
+	m_bodyOffsets.push_back (m_bodyFaces.size ());
+    }
+    BOOST_FOREACH (const boost::shared_ptr<Face>& face,
+		   foam.GetStandaloneFaces ())
+	addFace (*face);
+    BOOST_FOREACH (const boost::shared_ptr<Edge>& edge,
+		   foam.GetStandaloneEdges ())
+	addEdge (*edge);
+
+    m_vertexCount = m_vertices.size ();
+    m_points->SetNumberOfComponents (3);
+    m_points->SetNumberOfTuples (m_vertexCount + bodies.size ());
+    float* p = m_points->GetPointer (0);
+    BOOST_FOREACH (const G3D::Vector3& v, m_vertices)
+    {
+	*p++ = v.x;
+	*p++ = v.y;
+	*p++ = v.z;
+    }
+    BOOST_FOREACH (const boost::shared_ptr<Body>& body, bodies)
+    {
+	G3D::Vector3 center = body->GetCenter ();
+	*p++ = center.x;
+	*p++ = center.y;
+	*p++ = center.z;
+    }
+    // needed only while the arrays are built
+    IndexMap ().swap (m_vertexIndex);
+    IndexMap ().swap (m_edgeIndex);
+    IndexMap ().swap (m_faceIndex);
+    vector<G3D::Vector3> ().swap (m_vertices);
+}
+
+size_t FoamArrays::addVertex (const Vertex* vertex)
+{
+    pair<IndexMap::iterator, bool> p = m_vertexIndex.insert (
+	IndexMap::value_type (vertex, m_vertices.size ()));
+    if (p.second)
+	m_vertices.push_back (vertex->GetVector ());
+    return p.first->second;
+}
+
+size_t FoamArrays::addEdge (const Edge& edge)
+{
+    pair<IndexMap::iterator, bool> p = m_edgeIndex.insert (
+	IndexMap::value_type (&edge, m_edgeBegin.size ()));
+    if (p.second)
+    {
+	m_edgeBegin.push_back (addVertex (edge.GetBeginPtr ().get ()));
+	m_edgeEnd.push_back (addVertex (edge.GetEndPtr ().get ()));
+	m_edgeMiddle.push_back (
+	    edge.GetType () == Edge::QUADRATIC_EDGE ?
+	    addVertex (static_cast<const QuadraticEdge&> (
+			   edge).GetMiddlePtr ().get ()) : INVALID_INDEX);
+    }
+    return p.first->second;
+}
+
+size_t FoamArrays::addFace (const Face& face)
+{
+    pair<IndexMap::iterator, bool> p = m_faceIndex.insert (
+	IndexMap::value_type (&face, GetFaceCount ()));
+    if (p.second)
+    {
+	BOOST_FOREACH (const boost::shared_ptr<OrientedEdge>& oe,
+		       face.GetOrientedEdges ())
+	    m_faceEdges.push_back (
+		signedIndex (addEdge (*oe->GetEdge ()), oe->IsReversed ()));
+	m_faceOffsets.push_back (m_faceEdges.size ());
+    }
+    return p.first->second;
+}
+
+vtkSmartPointer<vtkPoints> FoamArrays::GetPoints () const
+{
+    VTK_CREATE (vtkPoints, points);
+    points->SetData (m_points);
+    return points;
+}
+
+size_t FoamArrays::GetBeginVertex (int orientedFace, size_t i) const
+{
+    bool faceReversed = orientedFace < 0;
+    size_t face = abs (orientedFace) - 1;
+    size_t n = GetFaceEdgeCount (face);
+    RuntimeAssert (i < n, "Edge index ", i,
+		   " greater than the number of edges ", n);
+    int orientedEdge = m_faceEdges[
+	m_faceOffsets[face] + (faceReversed ? n - 1 - i : i)];
+    size_t edge = abs (orientedEdge) - 1;
+    bool edgeReversed = (orientedEdge < 0) != faceReversed;
+    return edgeReversed ? m_edgeEnd[edge] : m_edgeBegin[edge];
+}
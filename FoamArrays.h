@@ -0,0 +1,158 @@
+/**
+ * @file FoamArrays.h
+ * @author Dan R. Lipsa
+ * @brief Struct-of-arrays copy of the element graph of a Foam.
+ * @ingroup data model
+ */
+#ifndef __FOAM_ARRAYS_H__
+#define __FOAM_ARRAYS_H__
+
+class Body;
+class Edge;
+class Face;
+class Foam;
+class Vertex;
+
+/**
+ * @brief Struct-of-arrays copy of the element graph of a Foam.
+ *
+ * Points are stored contiguously as floats, vertices first followed
+ * by the centers of the bodies. Edges are stored as arrays of begin,
+ * end and middle point indexes. Faces and bodies are stored in
+ * compressed sparse row form: the edges of face i are at positions
+ * [offset[i], offset[i + 1]) in an array of edge indexes, the faces of
+ * a body are stored the same way. As in the DMP file, an oriented
+ * edge or face is stored as a 1-based index, negative if it is
+ * reversed.
+ *
+ * The arrays are built from a Foam that was preprocessed and they do
+ * not follow later changes to it. They are a copy, not the storage of
+ * the Foam: Vertex, Edge and Face still own the geometry, and
+ * preprocessing (Face::CalculateCentroidAndArea,
+ * Body::CalculateVolume) and the display functors still follow
+ * pointers. Only the export of the tetrahedral grid to VTK
+ * (Foam::getTetraGrid) uses them, passing the points without copying
+ * them.
+ */
+class FoamArrays
+{
+public:
+    FoamArrays (const Foam& foam);
+
+    size_t GetVertexCount () const
+    {
+	return m_vertexCount;
+    }
+    /**
+     * @return vertices followed by body centers
+     */
+    size_t GetPointCount () const
+    {
+	return m_points->GetNumberOfTuples ();
+    }
+    /**
+     * @return x, y, z for each point
+     */
+    const float* GetPointData () const
+    {
+	return m_points->GetPointer (0);
+    }
+    G3D::Vector3 GetPoint (size_t i) const
+    {
+	const float* p = GetPointData () + 3 * i;
+	return G3D::Vector3 (p[0], p[1], p[2]);
+    }
+    size_t GetBodyCenter (size_t body) const
+    {
+	return m_vertexCount + body;
+    }
+    /**
+     * @return points that share their memory with this object
+     */
+    vtkSmartPointer<vtkPoints> GetPoints () const;
+
+    size_t GetEdgeCount () const
+    {
+	return m_edgeBegin.size ();
+    }
+    size_t GetEdgeBegin (size_t edge) const
+    {
+	return m_edgeBegin[edge];
+    }
+    size_t GetEdgeEnd (size_t edge) const
+    {
+	return m_edgeEnd[edge];
+    }
+    /**
+     * @return the middle point of a quadratic edge, INVALID_INDEX otherwise
+     */
+    size_t GetEdgeMiddle (size_t edge) const
+    {
+	return m_edgeMiddle[edge];
+    }
+
+    size_t GetFaceCount () const
+    {
+	return m_faceOffsets.size () - 1;
+    }
+    size_t GetFaceEdgeCount (size_t face) const
+    {
+	return m_faceOffsets[face + 1] - m_faceOffsets[face];
+    }
+    /**
+     * @param orientedFace 1-based face index, negative if reversed
+     * @param i index of an edge in the oriented face
+     * @return the point where the i-th oriented edge begins
+     *         (@see OrientedFace::GetBeginVertex)
+     */
+    size_t GetBeginVertex (int orientedFace, size_t i) const;
+
+    size_t GetBodyCount () const
+    {
+	return m_bodyOffsets.size () - 1;
+    }
+    /**
+     * @return the oriented faces of a body
+     */
+    const int* GetBodyFaces (size_t body) const
+    {
+	return &m_bodyFaces[m_bodyOffsets[body]];
+    }
+    size_t GetBodyFaceCount (size_t body) const
+    {
+	return m_bodyOffsets[body + 1] - m_bodyOffsets[body];
+    }
+
+private:
+    typedef boost::unordered_map<const void*, size_t> IndexMap;
+
+private:
+    size_t addVertex (const Vertex* vertex);
+    size_t addEdge (const Edge& edge);
+    size_t addFace (const Face& face);
+
+private:
+    IndexMap m_vertexIndex;
+    IndexMap m_edgeIndex;
+    IndexMap m_faceIndex;
+    /**
+     * Vertices are collected here and copied in m_points
+     */
+    vector<G3D::Vector3> m_vertices;
+    size_t m_vertexCount;
+    vtkSmartPointer<vtkFloatArray> m_points;
+    vector<size_t> m_edgeBegin;
+    vector<size_t> m_edgeEnd;
+    vector<size_t> m_edgeMiddle;
+    vector<size_t> m_faceOffsets;
+    vector<int> m_faceEdges;
+    vector<size_t> m_bodyOffsets;
+    vector<int> m_bodyFaces;
+};
+
+
+#endif //__FOAM_ARRAYS_H__
+
+// Local Variables:
+// mode: c++
+// End:
@@ -0,0 +1,904 @@
+/**
+ * @file   FoamSnapshot.cpp
+ * @author Dan R. Lipsa
+ *
+ * Definitions for the FoamSnapshot class.
+ *
+ * The snapshot is a native-endian binary file that is only meant to
+ * be read back on the machine that wrote it. Elements are stored in
+ * tables and refer to each other through indexes into those tables.
+ * The topology of the tables (ids and indexes) is stored before their
+ * geometry (positions and attributes), so that it can be shared
+ * between time steps kept in memory.
+ */
+
+#include "Attribute.h"
+#include "AttributeInfo.h"
+#include "Body.h"
+#include "Debug.h"
+#include "Edge.h"
+#include "ElementArena.h"
+#include "Face.h"
+#include "Foam.h"
+#include "FoamSnapshot.h"
+#include "OrientedEdge.h"
+#include "OrientedFace.h"
+#include "ParsingData.h"
+#include "QuadraticEdge.h"
+#include "Utils.h"
+#include "Vertex.h"
+
+
+// Private Functions and constants
+// ======================================================================
+
+namespace
+{
+const char SNAPSHOT_MAGIC[] = "FOAMVIS SNAPSHOT";
+/**
+ * Increment every time the layout of the snapshot changes.
+ */
+const size_t SNAPSHOT_VERSION = 3;
+
+template<typename T>
+void write (ostream& ostr, const T& value)
+{
+    ostr.write (reinterpret_cast<const char*> (&value), sizeof (value));
+}
+
+template<typename T>
+T read (istream& istr)
+{
+    T value;
+    istr.read (reinterpret_cast<char*> (&value), sizeof (value));
+    return value;
+}
+
+void writeString (ostream& ostr, const string& s)
+{
+    write (ostr, s.size ());
+    ostr.write (s.data (), s.size ());
+}
+
+string readString (istream& istr)
+{
+    size_t size = read<size_t> (istr);
+    string s (size, ' ');
+    if (size != 0)
+	istr.read (&s[0], size);
+    return s;
+}
+
+template<typename T>
+const T& getChecked (const vector<T>& v, size_t i)
+{
+    RuntimeAssert (i < v.size (), "Invalid snapshot index: ", i);
+    return v[i];
+}
+
+qint64 getModificationTime (const QFileInfo& fi)
+{
+    return fi.lastModified ().toTime_t ();
+}
+
+} // namespace
+
+
+// Methods
+// ======================================================================
+
+FoamSnapshot::FoamSnapshot ()
+{
+}
+
+FoamSnapshot::FoamSnapshot (const string& dmpPath, const string& cacheDir) :
+    m_dmpPath (dmpPath),
+    m_path (cacheDir + "/" + ChangeExtension (NameFromPath (dmpPath), "fvs"))
+{
+}
+
+bool FoamSnapshot::IsSupported (const Foam& foam)
+{
+    return foam.m_constraintEdges.empty () &&
+	foam.m_constraintPointsToFix.empty ();
+}
+
+bool FoamSnapshot::Read (Foam* foam)
+{
+    ifstream istr (m_path.c_str (), ios::binary);
+    if (! istr)
+	return false;
+    try
+    {
+	istr.exceptions (ios::failbit | ios::badbit | ios::eofbit);
+	if (! readHeader (istr, *foam))
+	    return false;
+	readProperties (istr, foam);
+	readAttributesInfo (istr, foam);
+	readParsingData (istr, foam);
+	readTopology (istr, foam);
+	readGeometry (istr);
+	clear ();
+	return true;
+    }
+    catch (const exception& e)
+    {
+	cdbg << "Invalid snapshot " << m_path << ": " << e.what () << endl;
+	clear ();
+	return false;
+    }
+}
+
+void FoamSnapshot::Write (const Foam& foam)
+{
+    string tmpPath = m_path + ".tmp";
+    try
+    {
+	{
+	    ofstream ostr (tmpPath.c_str (), ios::binary | ios::trunc);
+	    if (! ostr)
+		ThrowException ("Cannot open ", tmpPath);
+	    collect (foam);
+	    writeHeader (ostr, foam);
+	    writeProperties (ostr, foam);
+	    writeAttributesInfo (ostr, foam);
+	    writeParsingData (ostr, foam);
+	    writeTopology (ostr, foam);
+	    writeGeometry (ostr);
+	    clear ();
+	    if (! ostr)
+		ThrowException ("Error writing ", tmpPath);
+	}
+	if (rename (tmpPath.c_str (), m_path.c_str ()) != 0)
+	    ThrowException ("Cannot rename ", tmpPath, " to ", m_path);
+    }
+    catch (const exception& e)
+    {
+	cdbg << "Snapshot not saved: " << e.what () << endl;
+	clear ();
+	remove (tmpPath.c_str ());
+    }
+}
+
+void FoamSnapshot::Store (const Foam& foam, StoredFoam* stored)
+{
+    ostringstream topology, geometry;
+    collect (foam);
+    writeTopology (topology, foam);
+    writeProperties (geometry, foam);
+    writeAttributesInfo (geometry, foam);
+    writeParsingData (geometry, foam);
+    writeGeometry (geometry);
+    clear ();
+    stored->m_topology = boost::make_shared<const string> (topology.str ());
+    stored->m_geometry = geometry.str ();
+}
+
+void FoamSnapshot::Restore (const StoredFoam& stored, Foam* foam)
+{
+    istringstream topology (*stored.m_topology);
+    istringstream geometry (stored.m_geometry);
+    topology.exceptions (ios::failbit | ios::badbit | ios::eofbit);
+    geometry.exceptions (ios::failbit | ios::badbit | ios::eofbit);
+    try
+    {
+	readProperties (geometry, foam);
+	readAttributesInfo (geometry, foam);
+	readParsingData (geometry, foam);
+	readTopology (topology, foam);
+	readGeometry (geometry);
+	clear ();
+    }
+    catch (...)
+    {
+	clear ();
+	throw;
+    }
+}
+
+void FoamSnapshot::clear ()
+{
+    m_vertices.clear ();
+    m_edges.clear ();
+    m_faces.clear ();
+    m_orientedFaces.clear ();
+    m_bodies.clear ();
+    m_vertexIndex.clear ();
+    m_edgeIndex.clear ();
+    m_faceIndex.clear ();
+    m_orientedFaceIndex.clear ();
+    m_bodyIndex.clear ();
+}
+
+
+// Header, properties and parsing data
+// ======================================================================
+
+void FoamSnapshot::writeHeader (ostream& ostr, const Foam& foam) const
+{
+    QFileInfo fi (m_dmpPath.c_str ());
+    const ParsingData& parsingData = *foam.m_parsingData;
+    const DmpObjectInfo& objectInfo = parsingData.GetDmpObjectInfo ();
+    ostr.write (SNAPSHOT_MAGIC, sizeof (SNAPSHOT_MAGIC));
+    write (ostr, SNAPSHOT_VERSION);
+    write (ostr, fi.size ());
+    write (ostr, getModificationTime (fi));
+    write (ostr, parsingData.OriginalUsed ());
+    write (ostr, objectInfo.m_constraintIndex);
+    writeString (ostr, objectInfo.m_xName);
+    writeString (ostr, objectInfo.m_yName);
+    writeString (ostr, objectInfo.m_angleName);
+    // the indexes of the attributes depend on the attributes loaded
+    const vector<string>& loadAttributes = parsingData.GetLoadAttributes ();
+    write (ostr, loadAttributes.size ());
+    BOOST_FOREACH (const string& name, loadAttributes)
+	writeString (ostr, name);
+}
+
+bool FoamSnapshot::readHeader (istream& istr, const Foam& foam)
+{
+    QFileInfo fi (m_dmpPath.c_str ());
+    const ParsingData& parsingData = *foam.m_parsingData;
+    const DmpObjectInfo& objectInfo = parsingData.GetDmpObjectInfo ();
+    char magic[sizeof (SNAPSHOT_MAGIC)];
+    istr.read (magic, sizeof (magic));
+    if (! (equal (magic, magic + sizeof (magic), SNAPSHOT_MAGIC) &&
+	   read<size_t> (istr) == SNAPSHOT_VERSION &&
+	   read<qint64> (istr) == fi.size () &&
+	   read<qint64> (istr) == getModificationTime (fi) &&
+	   read<bool> (istr) == parsingData.OriginalUsed () &&
+	   read<size_t> (istr) == objectInfo.m_constraintIndex &&
+	   readString (istr) == objectInfo.m_xName &&
+	   readString (istr) == objectInfo.m_yName &&
+	   readString (istr) == objectInfo.m_angleName))
+	return false;
+    const vector<string>& loadAttributes = parsingData.GetLoadAttributes ();
+    if (read<size_t> (istr) != loadAttributes.size ())
+	return false;
+    BOOST_FOREACH (const string& name, loadAttributes)
+	if (! EqualNoCase () (readString (istr), name))
+	    return false;
+    return true;
+}
+
+void FoamSnapshot::writeProperties (ostream& ostr, const Foam& foam) const
+{
+    write (ostr, static_cast<size_t> (foam.GetDimension ()));
+    write (ostr, foam.IsQuadratic ());
+    for (size_t i = 0; i < 3; ++i)
+	write (ostr, foam.GetTorusDomain ()[i]);
+    write (ostr, foam.GetViewMatrix ());
+    write (ostr, foam.m_dmpObjectPosition);
+}
+
+void FoamSnapshot::readProperties (istream& istr, Foam* foam) const
+{
+    foam->SetDimension (read<size_t> (istr));
+    foam->SetQuadratic (read<bool> (istr));
+    G3D::Vector3 x = read<G3D::Vector3> (istr);
+    G3D::Vector3 y = read<G3D::Vector3> (istr);
+    G3D::Vector3 z = read<G3D::Vector3> (istr);
+    foam->SetTorusDomain (x, y, z);
+    foam->m_viewMatrix.reset (
+	new G3D::Matrix4 (read<G3D::Matrix4> (istr)));
+    foam->m_dmpObjectPosition = read<ObjectPosition> (istr);
+}
+
+void FoamSnapshot::writeAttributesInfo (
+    ostream& ostr, const Foam& foam) const
+{
+    for (size_t type = 0; type < DefineAttribute::COUNT; ++type)
+    {
+	const AttributesInfo::NameInfoMap& nameInfo =
+	    foam.GetAttributesInfoElements ().GetInfo (
+		DefineAttribute::Enum (type)).GetNameInfo ();
+	write (ostr, nameInfo.size ());
+	BOOST_FOREACH (const AttributesInfo::NameInfoMap::value_type& p,
+		       nameInfo)
+	{
+	    writeString (ostr, p.first);
+	    write (ostr, p.second->GetIndex ());
+	}
+    }
+}
+
+void FoamSnapshot::readAttributesInfo (istream& istr, Foam* foam) const
+{
+    for (size_t type = 0; type < DefineAttribute::COUNT; ++type)
+    {
+	size_t size = read<size_t> (istr);
+	vector< pair<size_t, string> > indexName (size);
+	for (size_t i = 0; i < size; ++i)
+	{
+	    indexName[i].second = readString (istr);
+	    indexName[i].first = read<size_t> (istr);
+	}
+	// replay the definitions in the order they got their indexes
+	// (INVALID_INDEX is the largest)
+	sort (indexName.begin (), indexName.end ());
+	AttributesInfo& info = foam->m_attributesInfoElements.GetInfo (
+	    DefineAttribute::Enum (type));
+	for (size_t i = 0; i < size; ++i)
+	{
+	    const char* name = indexName[i].second.c_str ();
+	    if (info.GetNameInfo ().find (name) == info.GetNameInfo ().end ())
+		foam->AddAttributeInfo (
+		    DefineAttribute::Enum (type), name,
+		    boost::shared_ptr<AttributeCreator> ());
+	    RuntimeAssert (
+		info.GetAttributeInfo (name)->GetIndex () ==
+		indexName[i].first,
+		"Attribute index changed for: ", name);
+	}
+    }
+}
+
+void FoamSnapshot::writeParsingData (ostream& ostr, const Foam& foam) const
+{
+    const ParsingData& parsingData = *foam.m_parsingData;
+    write (ostr, parsingData.m_variables.size ());
+    BOOST_FOREACH (const ParsingData::Variables::value_type& p,
+		   parsingData.m_variables)
+    {
+	writeString (ostr, p.first);
+	write (ostr, p.second);
+    }
+    write (ostr, parsingData.m_arrays.size ());
+    BOOST_FOREACH (const ParsingData::Arrays::value_type& p,
+		   parsingData.m_arrays)
+    {
+	writeString (ostr, p.first);
+	writeArray (ostr, *p.second);
+    }
+}
+
+void FoamSnapshot::readParsingData (istream& istr, Foam* foam) const
+{
+    ParsingData& parsingData = foam->GetParsingData ();
+    size_t size = read<size_t> (istr);
+    for (size_t i = 0; i < size; ++i)
+    {
+	string name = readString (istr);
+	parsingData.SetVariable (name, read<double> (istr));
+    }
+    size = read<size_t> (istr);
+    for (size_t i = 0; i < size; ++i)
+    {
+	string name = readString (istr);
+	parsingData.SetArray (name.c_str (), readArray (istr));
+    }
+}
+
+void FoamSnapshot::writeArray (
+    ostream& ostr, const AttributeArrayAttribute& array)
+{
+    write (ostr, array.m_values->size ());
+    BOOST_FOREACH (const boost::shared_ptr<Attribute>& a, *array.m_values)
+    {
+	Attribute::Type type = a ? a->GetType () : Attribute::COUNT;
+	write (ostr, type);
+	switch (type)
+	{
+	case Attribute::REAL:
+	    write (ostr, static_cast<double> (
+		       static_cast<const RealAttribute&> (*a)));
+	    break;
+	case Attribute::ATTRIBUTE_ARRAY:
+	    writeArray (ostr, static_cast<const AttributeArrayAttribute&> (*a));
+	    break;
+	case Attribute::COUNT:
+	    break;
+	default:
+	    ThrowException ("Invalid array element type: ", type);
+	}
+    }
+}
+
+AttributeArrayAttribute* FoamSnapshot::readArray (istream& istr)
+{
+    auto_ptr<AttributeArrayAttribute> array (new AttributeArrayAttribute ());
+    size_t size = read<size_t> (istr);
+    for (size_t i = 0; i < size; ++i)
+    {
+	Attribute::Type type = read<Attribute::Type> (istr);
+	switch (type)
+	{
+	case Attribute::REAL:
+	    array->AddElement (new RealAttribute (read<double> (istr)));
+	    break;
+	case Attribute::ATTRIBUTE_ARRAY:
+	    array->AddElement (readArray (istr));
+	    break;
+	case Attribute::COUNT:
+	    array->m_values->push_back (boost::shared_ptr<Attribute> ());
+	    break;
+	default:
+	    ThrowException ("Invalid array element type: ", type);
+	}
+    }
+    return array.release ();
+}
+
+void FoamSnapshot::writeAttributes (ostream& ostr, const Element& element)
+{
+    const AttributeValues& values = element.m_attributes;
+    write (ostr, values.size ());
+    for (size_t i = 0; i < values.size (); ++i)
+    {
+	Attribute::Type type = static_cast<Attribute::Type> (
+	    values.GetType (i));
+	write (ostr, type);
+	switch (type)
+	{
+	case Attribute::INTEGER:
+	    write (ostr, values.GetInteger (i));
+	    break;
+	case Attribute::REAL:
+	    write (ostr, values.GetReal (i));
+	    break;
+	case Attribute::COLOR:
+	    write (ostr, values.GetColor (i));
+	    break;
+	case Attribute::INTEGER_ARRAY:
+	{
+	    const vector<int> v = 
+		static_cast<const IntegerArrayAttribute&> (*values.GetArray (i));
+	    write (ostr, v.size ());
+	    ostr.write (reinterpret_cast<const char*> (&v[0]),
+			v.size () * sizeof (int));
+	    break;
+	}
+	case Attribute::REAL_ARRAY:
+	{
+	    const vector<double> v = 
+		static_cast<const RealArrayAttribute&> (*values.GetArray (i));
+	    write (ostr, v.size ());
+	    ostr.write (reinterpret_cast<const char*> (&v[0]),
+			v.size () * sizeof (double));
+	    break;
+	}
+	case Attribute::COUNT:
+	    break;
+	default:
+	    ThrowException ("Invalid attribute type: ", type);
+	}
+    }
+}
+
+void FoamSnapshot::readAttributes (istream& istr, Element* element)
+{
+    size_t size = read<size_t> (istr);
+    element->m_attributes.Resize (size);
+    for (size_t i = 0; i < size; ++i)
+    {
+	Attribute::Type type = read<Attribute::Type> (istr);
+	switch (type)
+	{
+	case Attribute::INTEGER:
+	    element->m_attributes.SetInteger (i, read<int> (istr));
+	    break;
+	case Attribute::REAL:
+	    element->m_attributes.SetReal (i, read<double> (istr));
+	    break;
+	case Attribute::COLOR:
+	    element->m_attributes.SetColor (i, read<Color::Enum> (istr));
+	    break;
+	case Attribute::INTEGER_ARRAY:
+	{
+	    vector<int>* values = new vector<int> (read<size_t> (istr));
+	    element->SetAttribute (i, new IntegerArrayAttribute (values));
+	    istr.read (reinterpret_cast<char*> (&(*values)[0]),
+		       values->size () * sizeof (int));
+	    break;
+	}
+	case Attribute::REAL_ARRAY:
+	{
+	    vector<double>* values = new vector<double> (read<size_t> (istr));
+	    element->SetAttribute (i, new RealArrayAttribute (values));
+	    istr.read (reinterpret_cast<char*> (&(*values)[0]),
+		       values->size () * sizeof (double));
+	    break;
+	}
+	case Attribute::COUNT:
+	    break;
+	default:
+	    ThrowException ("Invalid attribute type: ", type);
+	}
+    }
+}
+
+
+// Element tables
+// ======================================================================
+
+void FoamSnapshot::collect (const Foam& foam)
+{
+    clear ();
+    BOOST_FOREACH (const boost::shared_ptr<Body>& body, foam.m_bodies)
+    {
+	m_bodyIndex[body.get ()] = m_bodies.size ();
+	m_bodies.push_back (body);
+	BOOST_FOREACH (const boost::shared_ptr<OrientedFace>& of,
+		       body->m_orientedFaces)
+	    addFace (of->GetFace ());
+    }
+    BOOST_FOREACH (const boost::shared_ptr<Face>& face, foam.m_standaloneFaces)
+	addFace (face);
+    BOOST_FOREACH (const boost::shared_ptr<Edge>& edge, foam.m_standaloneEdges)
+	addEdge (edge);
+
+    // vertices keep alive edges that may not be part of any face
+    // (torus unwrapping) so follow adjacency until nothing new is found.
+    size_t vertexCount = 0, edgeCount = 0;
+    while (vertexCount < m_vertices.size () || edgeCount < m_edges.size ())
+    {
+	for (; edgeCount < m_edges.size (); ++edgeCount)
+	{
+	    const Edge& edge = *m_edges[edgeCount];
+	    addVertex (edge.GetBeginPtr ());
+	    addVertex (edge.GetEndPtr ());
+	    if (edge.GetType () == Edge::QUADRATIC_EDGE)
+		addVertex (static_cast<const QuadraticEdge&> (
+			       edge).GetMiddlePtr ());
+	}
+	for (; vertexCount < m_vertices.size (); ++vertexCount)
+	    BOOST_FOREACH (const boost::shared_ptr<Edge>& edge,
+			   m_vertices[vertexCount]->m_adjacentEdges)
+		addEdge (edge);
+    }
+
+    // oriented faces of bodies first, then those of standalone faces.
+    // Read restores them in the same order.
+    BOOST_FOREACH (const boost::shared_ptr<Body>& body, m_bodies)
+	BOOST_FOREACH (const boost::shared_ptr<OrientedFace>& of,
+		       body->m_orientedFaces)
+	{
+	    m_orientedFaceIndex[of.get ()] = m_orientedFaces.size ();
+	    m_orientedFaces.push_back (of);
+	}
+    BOOST_FOREACH (const boost::shared_ptr<Face>& face, m_faces)
+	if (face->m_orientedFace)
+	{
+	    m_orientedFaceIndex[face->m_orientedFace.get ()] =
+		m_orientedFaces.size ();
+	    m_orientedFaces.push_back (face->m_orientedFace);
+	}
+}
+
+void FoamSnapshot::addVertex (const boost::shared_ptr<Vertex>& vertex)
+{
+    if (m_vertexIndex.insert (
+	    IndexMap::value_type (vertex.get (), m_vertices.size ())).second)
+	m_vertices.push_back (vertex);
+}
+
+void FoamSnapshot::addEdge (const boost::shared_ptr<Edge>& edge)
+{
+    RuntimeAssert (edge->GetType () != Edge::CONSTRAINT_EDGE,
+		   "Constraint edges cannot be saved in a snapshot");
+    if (m_edgeIndex.insert (
+	    IndexMap::value_type (edge.get (), m_edges.size ())).second)
+	m_edges.push_back (edge);
+}
+
+void FoamSnapshot::addFace (const boost::shared_ptr<Face>& face)
+{
+    if (m_faceIndex.insert (
+	    IndexMap::value_type (face.get (), m_faces.size ())).second)
+    {
+	m_faces.push_back (face);
+	BOOST_FOREACH (const boost::shared_ptr<OrientedEdge>& oe,
+		       face->m_orientedEdges)
+	    addEdge (oe->GetEdge ());
+    }
+}
+
+size_t FoamSnapshot::getIndex (const IndexMap& indexMap, const void* p) const
+{
+    IndexMap::const_iterator it = indexMap.find (p);
+    return it == indexMap.end () ? INVALID_INDEX : it->second;
+}
+
+void FoamSnapshot::writeTopology (ostream& ostr, const Foam& foam) const
+{
+    write (ostr, m_vertices.size ());
+    BOOST_FOREACH (const boost::shared_ptr<Vertex>& v, m_vertices)
+    {
+	write (ostr, v->GetId ());
+	write (ostr, v->GetDuplicateStatus ());
+    }
+
+    write (ostr, m_edges.size ());
+    BOOST_FOREACH (const boost::shared_ptr<Edge>& e, m_edges)
+    {
+	write (ostr, e->GetId ());
+	write (ostr, e->GetDuplicateStatus ());
+	write (ostr, e->GetType ());
+	write (ostr, getIndex (m_vertexIndex, e->GetBeginPtr ().get ()));
+	write (ostr, getIndex (m_vertexIndex, e->GetEndPtr ().get ()));
+	if (e->GetType () == Edge::QUADRATIC_EDGE)
+	    write (ostr, getIndex (
+		       m_vertexIndex, static_cast<const QuadraticEdge&> (
+			   *e).GetMiddlePtr ().get ()));
+	write (ostr, e->GetEndTranslation ());
+    }
+
+    write (ostr, m_faces.size ());
+    BOOST_FOREACH (const boost::shared_ptr<Face>& f, m_faces)
+    {
+	write (ostr, f->GetId ());
+	write (ostr, f->GetDuplicateStatus ());
+	write (ostr, f->m_orientedEdges.size ());
+	BOOST_FOREACH (const boost::shared_ptr<OrientedEdge>& oe,
+		       f->m_orientedEdges)
+	{
+	    write (ostr, getIndex (m_edgeIndex, oe->GetEdge ().get ()));
+	    write (ostr, oe->IsReversed ());
+	}
+	write (ostr, static_cast<bool> (f->m_orientedFace));
+	if (f->m_orientedFace)
+	    write (ostr, f->m_orientedFace->IsReversed ());
+    }
+
+    write (ostr, m_bodies.size ());
+    BOOST_FOREACH (const boost::shared_ptr<Body>& b, m_bodies)
+    {
+	write (ostr, b->GetId ());
+	write (ostr, b->GetDuplicateStatus ());
+	write (ostr, b->m_orientedFaces.size ());
+	BOOST_FOREACH (const boost::shared_ptr<OrientedFace>& of,
+		       b->m_orientedFaces)
+	{
+	    write (ostr, getIndex (m_faceIndex, of->GetFace ().get ()));
+	    write (ostr, of->IsReversed ());
+	}
+    }
+
+    write (ostr, foam.m_standaloneEdges.size ());
+    BOOST_FOREACH (const boost::shared_ptr<Edge>& e, foam.m_standaloneEdges)
+	write (ostr, getIndex (m_edgeIndex, e.get ()));
+    write (ostr, foam.m_standaloneFaces.size ());
+    BOOST_FOREACH (const boost::shared_ptr<Face>& f, foam.m_standaloneFaces)
+	write (ostr, getIndex (m_faceIndex, f.get ()));
+    writeAdjacency (ostr);
+}
+
+void FoamSnapshot::readTopology (istream& istr, Foam* foam)
+{
+    m_vertices.resize (read<size_t> (istr));
+    for (size_t i = 0; i < m_vertices.size (); ++i)
+    {
+	size_t id = read<size_t> (istr);
+	ElementStatus::Enum status = read<ElementStatus::Enum> (istr);
+	// the position is read with the geometry
+	m_vertices[i] = MakeElement<Vertex> (0, 0, 0, id, status);
+    }
+
+    m_edges.resize (read<size_t> (istr));
+    for (size_t i = 0; i < m_edges.size (); ++i)
+    {
+	size_t id = read<size_t> (istr);
+	ElementStatus::Enum status = read<ElementStatus::Enum> (istr);
+	Edge::Type type = read<Edge::Type> (istr);
+	boost::shared_ptr<Vertex> begin =
+	    getChecked (m_vertices, read<size_t> (istr));
+	boost::shared_ptr<Vertex> end =
+	    getChecked (m_vertices, read<size_t> (istr));
+	if (type == Edge::QUADRATIC_EDGE)
+	{
+	    boost::shared_ptr<Vertex> middle =
+		getChecked (m_vertices, read<size_t> (istr));
+	    G3D::Vector3int16 translation = read<G3D::Vector3int16> (istr);
+	    m_edges[i] = MakeElement<QuadraticEdge> (
+		begin, end, middle, translation, id, status);
+	}
+	else
+	{
+	    RuntimeAssert (type == Edge::EDGE, "Invalid edge type: ", type);
+	    G3D::Vector3int16 translation = read<G3D::Vector3int16> (istr);
+	    m_edges[i] = MakeElement<Edge> (
+		begin, end, translation, id, Edge::EDGE, status);
+	}
+    }
+
+    m_faces.resize (read<size_t> (istr));
+    vector< pair<size_t, bool> > standaloneOrientedFaces;
+    for (size_t i = 0; i < m_faces.size (); ++i)
+    {
+	size_t id = read<size_t> (istr);
+	ElementStatus::Enum status = read<ElementStatus::Enum> (istr);
+	size_t size = read<size_t> (istr);
+	RuntimeAssert (size != 0, "Face without edges: ", id);
+	Face::OrientedEdges orientedEdges (size);
+	for (size_t j = 0; j < size; ++j)
+	{
+	    boost::shared_ptr<Edge> edge =
+		getChecked (m_edges, read<size_t> (istr));
+	    orientedEdges[j] = MakeElement<OrientedEdge> (
+		edge, read<bool> (istr));
+	}
+	boost::shared_ptr<Face> face = MakeElement<Face> (
+	    orientedEdges[0]->GetEdge (), id);
+	face->SetDuplicateStatus (status);
+	face->m_orientedEdges.swap (orientedEdges);
+	if (read<bool> (istr))
+	    standaloneOrientedFaces.push_back (
+		pair<size_t, bool> (i, read<bool> (istr)));
+	m_faces[i] = face;
+    }
+
+    m_bodies.resize (read<size_t> (istr));
+    for (size_t i = 0; i < m_bodies.size (); ++i)
+    {
+	size_t id = read<size_t> (istr);
+	ElementStatus::Enum status = read<ElementStatus::Enum> (istr);
+	vector<int> faceIndexes (read<size_t> (istr));
+	for (size_t j = 0; j < faceIndexes.size (); ++j)
+	{
+	    size_t faceIndex = read<size_t> (istr);
+	    getChecked (m_faces, faceIndex);
+	    // 1-based, negative if reversed (@see Body::Body)
+	    faceIndexes[j] = faceIndex + 1;
+	    if (read<bool> (istr))
+		faceIndexes[j] = - faceIndexes[j];
+	}
+	boost::shared_ptr<Body> body = boost::make_shared<Body> (
+	    faceIndexes, m_faces, id, status);
+	m_bodies[i] = body;
+	copy (body->m_orientedFaces.begin (), body->m_orientedFaces.end (),
+	      back_inserter (m_orientedFaces));
+    }
+    foam->m_bodies = m_bodies;
+
+    for (size_t i = 0; i < standaloneOrientedFaces.size (); ++i)
+    {
+	const boost::shared_ptr<Face>& face =
+	    m_faces[standaloneOrientedFaces[i].first];
+	face->m_orientedFace = MakeElement<OrientedFace> (
+	    face, standaloneOrientedFaces[i].second);
+	m_orientedFaces.push_back (face->m_orientedFace);
+    }
+
+    foam->m_standaloneEdges.resize (read<size_t> (istr));
+    for (size_t i = 0; i < foam->m_standaloneEdges.size (); ++i)
+	foam->m_standaloneEdges[i] = getChecked (m_edges, read<size_t> (istr));
+    foam->m_standaloneFaces.resize (read<size_t> (istr));
+    for (size_t i = 0; i < foam->m_standaloneFaces.size (); ++i)
+	foam->m_standaloneFaces[i] = getChecked (m_faces, read<size_t> (istr));
+    readAdjacency (istr);
+}
+
+void FoamSnapshot::writeGeometry (ostream& ostr) const
+{
+    BOOST_FOREACH (const boost::shared_ptr<Vertex>& v, m_vertices)
+    {
+	write (ostr, v->m_vector);
+	writeAttributes (ostr, *v);
+    }
+    BOOST_FOREACH (const boost::shared_ptr<Edge>& e, m_edges)
+	writeAttributes (ostr, *e);
+    BOOST_FOREACH (const boost::shared_ptr<Face>& f, m_faces)
+    {
+	write (ostr, f->m_normal);
+	write (ostr, f->m_center);
+	write (ostr, f->m_perimeter);
+	write (ostr, f->m_area);
+	writeAttributes (ostr, *f);
+    }
+    BOOST_FOREACH (const boost::shared_ptr<Body>& b, m_bodies)
+    {
+	write (ostr, b->m_center);
+	write (ostr, b->m_hasFreeFace);
+	write (ostr, b->m_pressureDeduced);
+	write (ostr, b->m_targetVolumeDeduced);
+	write (ostr, b->m_actualVolumeDeduced);
+	writeAttributes (ostr, *b);
+    }
+}
+
+void FoamSnapshot::readGeometry (istream& istr)
+{
+    BOOST_FOREACH (const boost::shared_ptr<Vertex>& v, m_vertices)
+    {
+	v->m_vector = read<G3D::Vector3> (istr);
+	readAttributes (istr, v.get ());
+    }
+    BOOST_FOREACH (const boost::shared_ptr<Edge>& e, m_edges)
+	readAttributes (istr, e.get ());
+    BOOST_FOREACH (const boost::shared_ptr<Face>& f, m_faces)
+    {
+	f->m_normal = read<G3D::Vector3> (istr);
+	f->m_center = read<G3D::Vector3> (istr);
+	f->m_perimeter = read<float> (istr);
+	f->m_area = read<float> (istr);
+	readAttributes (istr, f.get ());
+    }
+    BOOST_FOREACH (const boost::shared_ptr<Body>& b, m_bodies)
+    {
+	b->m_center = read<G3D::Vector3> (istr);
+	b->m_hasFreeFace = read<bool> (istr);
+	b->m_pressureDeduced = read<bool> (istr);
+	b->m_targetVolumeDeduced = read<bool> (istr);
+	b->m_actualVolumeDeduced = read<bool> (istr);
+	readAttributes (istr, b.get ());
+    }
+}
+
+
+// Adjacency
+// ======================================================================
+
+void FoamSnapshot::writeAdjacency (ostream& ostr) const
+{
+    BOOST_FOREACH (const boost::shared_ptr<Vertex>& v, m_vertices)
+    {
+	write (ostr, v->m_adjacentEdges.size ());
+	BOOST_FOREACH (const boost::shared_ptr<Edge>& e, v->m_adjacentEdges)
+	    write (ostr, getIndex (m_edgeIndex, e.get ()));
+    }
+
+    vector< pair<size_t, size_t> > adjacent;
+    BOOST_FOREACH (const boost::shared_ptr<Edge>& e, m_edges)
+    {
+	adjacent.clear ();
+	BOOST_FOREACH (const AdjacentOrientedFace& aof,
+		       e->m_adjacentOrientedFaces)
+	{
+	    size_t i = getIndex (m_orientedFaceIndex,
+				 aof.GetOrientedFace ().get ());
+	    if (i != INVALID_INDEX)
+		adjacent.push_back (
+		    pair<size_t, size_t> (i, aof.GetOrientedEdgeIndex ()));
+	}
+	write (ostr, adjacent.size ());
+	for (size_t i = 0; i < adjacent.size (); ++i)
+	    write (ostr, adjacent[i]);
+    }
+
+    BOOST_FOREACH (const boost::shared_ptr<Face>& f, m_faces)
+    {
+	adjacent.clear ();
+	BOOST_FOREACH (const AdjacentBody& ab, f->m_adjacentBodies)
+	{
+	    size_t i = getIndex (m_bodyIndex, ab.GetBody ().get ());
+	    if (i != INVALID_INDEX)
+		adjacent.push_back (
+		    pair<size_t, size_t> (i, ab.GetOrientedFaceIndex ()));
+	}
+	write (ostr, adjacent.size ());
+	for (size_t i = 0; i < adjacent.size (); ++i)
+	    write (ostr, adjacent[i]);
+    }
+}
+
+void FoamSnapshot::readAdjacency (istream& istr)
+{
+    BOOST_FOREACH (const boost::shared_ptr<Vertex>& v, m_vertices)
+    {
+	size_t size = read<size_t> (istr);
+	v->m_adjacentEdges.reserve (size);
+	for (size_t i = 0; i < size; ++i)
+	    v->AddAdjacentEdge (getChecked (m_edges, read<size_t> (istr)));
+    }
+
+    BOOST_FOREACH (const boost::shared_ptr<Edge>& e, m_edges)
+    {
+	size_t size = read<size_t> (istr);
+	for (size_t i = 0; i < size; ++i)
+	{
+	    pair<size_t, size_t> p = read< pair<size_t, size_t> > (istr);
+	    e->AddAdjacentOrientedFace (
+		getChecked (m_orientedFaces, p.first), p.second);
+	}
+    }
+
+    BOOST_FOREACH (const boost::shared_ptr<Face>& f, m_faces)
+    {
+	size_t size = read<size_t> (istr);
+	for (size_t i = 0; i < size; ++i)
+	{
+	    pair<size_t, size_t> p = read< pair<size_t, size_t> > (istr);
+	    f->AddAdjacentBody (getChecked (m_bodies, p.first), p.second);
+	}
+    }
+}
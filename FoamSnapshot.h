@@ -0,0 +1,149 @@
+/**
+ * @file FoamSnapshot.h
+ * @author Dan R. Lipsa
+ * @brief Binary cache for a time step that was parsed and preprocessed.
+ * @ingroup data model
+ */
+#ifndef __FOAM_SNAPSHOT_H__
+#define __FOAM_SNAPSHOT_H__
+
+class AttributeArrayAttribute;
+class Body;
+class Edge;
+class Element;
+class Face;
+class Foam;
+class OrientedFace;
+class Vertex;
+
+/**
+ * @brief A time step kept in memory instead of its element graph
+ * (@see FoamSnapshot::Store).
+ */
+struct StoredFoam
+{
+    bool IsStored () const
+    {
+	return static_cast<bool> (m_topology);
+    }
+    /**
+     * Ids of the elements and the indexes through which they refer to
+     * each other. Time steps with the same topology share it.
+     */
+    boost::shared_ptr<const string> m_topology;
+    /**
+     * Properties, parsing data, positions and attributes of the
+     * elements.
+     */
+    string m_geometry;
+};
+
+/**
+ * @brief Binary cache for a time step that was parsed and preprocessed.
+ *
+ * Stores the element graph of a Foam as it is at the end of
+ * Foam::Preprocess, so that a DMP file that has not changed since the
+ * last run is not parsed again. The snapshot is saved in the
+ * simulation cache directory, next to the regular grid (.vti) files,
+ * and it is used only if the size and the modification time of the
+ * DMP file match the ones recorded when it was written.
+ */
+class FoamSnapshot
+{
+public:
+    /**
+     * A snapshot used only for Store and Restore
+     */
+    FoamSnapshot ();
+    /**
+     * @param dmpPath path to the DMP file
+     * @param cacheDir directory where the snapshot is stored
+     *        (@see Foam::GetCacheDir)
+     */
+    FoamSnapshot (const string& dmpPath, const string& cacheDir);
+    /**
+     * Reads the snapshot into a newly constructed foam.
+     * @return true if a valid snapshot was read, false otherwise. If
+     *         false is returned the foam is in an undefined state and
+     *         it should be discarded.
+     */
+    bool Read (Foam* foam);
+    /**
+     * Writes the snapshot for a foam that was just parsed.
+     */
+    void Write (const Foam& foam);
+    /**
+     * Keeps in memory the snapshot for a foam that was just parsed.
+     */
+    void Store (const Foam& foam, StoredFoam* stored);
+    /**
+     * Rebuilds a foam from memory into a newly constructed foam.
+     */
+    void Restore (const StoredFoam& stored, Foam* foam);
+    const string& GetPath () const
+    {
+	return m_path;
+    }
+    /**
+     * Constraint edges (2D) are computed from expressions stored in
+     * ParsingData, so foams that have them are not cached.
+     */
+    static bool IsSupported (const Foam& foam);
+
+private:
+    typedef boost::unordered_map<const void*, size_t> IndexMap;
+    typedef vector< boost::shared_ptr<Vertex> > Vertices;
+    typedef vector< boost::shared_ptr<Edge> > Edges;
+    typedef vector< boost::shared_ptr<Face> > Faces;
+    typedef vector< boost::shared_ptr<OrientedFace> > OrientedFaces;
+    typedef vector< boost::shared_ptr<Body> > Bodies;
+
+private:
+    void clear ();
+    bool readHeader (istream& istr, const Foam& foam);
+    void writeHeader (ostream& ostr, const Foam& foam) const;
+    void readProperties (istream& istr, Foam* foam) const;
+    void writeProperties (ostream& ostr, const Foam& foam) const;
+    void readAttributesInfo (istream& istr, Foam* foam) const;
+    void writeAttributesInfo (ostream& ostr, const Foam& foam) const;
+    void readParsingData (istream& istr, Foam* foam) const;
+    void writeParsingData (ostream& ostr, const Foam& foam) const;
+    static AttributeArrayAttribute* readArray (istream& istr);
+    static void writeArray (ostream& ostr,
+			    const AttributeArrayAttribute& array);
+    static void readAttributes (istream& istr, Element* element);
+    static void writeAttributes (ostream& ostr, const Element& element);
+
+    void collect (const Foam& foam);
+    void addVertex (const boost::shared_ptr<Vertex>& vertex);
+    void addEdge (const boost::shared_ptr<Edge>& edge);
+    void addFace (const boost::shared_ptr<Face>& face);
+    size_t getIndex (const IndexMap& indexMap, const void* p) const;
+
+    void readTopology (istream& istr, Foam* foam);
+    void writeTopology (ostream& ostr, const Foam& foam) const;
+    void readGeometry (istream& istr);
+    void writeGeometry (ostream& ostr) const;
+    void readAdjacency (istream& istr);
+    void writeAdjacency (ostream& ostr) const;
+
+private:
+    string m_dmpPath;
+    string m_path;
+    Vertices m_vertices;
+    Edges m_edges;
+    Faces m_faces;
+    OrientedFaces m_orientedFaces;
+    Bodies m_bodies;
+    IndexMap m_vertexIndex;
+    IndexMap m_edgeIndex;
+    IndexMap m_faceIndex;
+    IndexMap m_orientedFaceIndex;
+    IndexMap m_bodyIndex;
+};
+
+#endif //__FOAM_SNAPSHOT_H__
+
+// Local Variables:
+// mode: c++
+// End:
@@ -58,6 +58,14 @@ size_t HistogramStatistics::size () const
     return histogramResult.size () - 2;
 }
 
+size_t HistogramStatistics::GetMemorySize () const
+{
+    // the density accumulator stores the histogram, the bin
+    // positions and the samples in each bin
+    return sizeof (HistogramStatistics) + (size () + 2) * 
+	(sizeof (Result::value_type) + 2 * sizeof (double));
+}
+
 
 QwtIntervalData HistogramStatistics::ToQwtIntervalData () const
 {
@@ -104,3 +112,73 @@ string HistogramStatistics::RawToString () const
 	ostr << (it->second * acc::count(*this)) << " ";
     return ostr.str ();
 }
+
+double ValueCollector::Quantile (double fraction)
+{
+    if (m_values.empty ())
+	return 0;
+    RuntimeAssert (fraction >= 0 && fraction <= 1,
+		   "Invalid quantile fraction: ", fraction);
+    double position = fraction * (m_values.size () - 1);
+    size_t rank = floor (position);
+    vector<float>::iterator it = m_values.begin () + rank;
+    nth_element (m_values.begin (), it, m_values.end ());
+    double value = *it;
+    if (rank + 1 == m_values.size ())
+	return value;
+    // the next rank is the smallest value after the nth element
+    double next = *min_element (it + 1, m_values.end ());
+    return value + (position - rank) * (next - value);
+}
+
+size_t ValueCollector::CheckQuantile ()
+{
+    const double fractions[] = {0, 0.1, 0.25, 0.5, 0.75, 0.9, 1};
+    const size_t fractionsCount = sizeof (fractions) / sizeof (fractions[0]);
+    // even and odd counts, with ties on both sides of the median
+    const float even[] = {3, 1, 2, 2, 4, 2, 1, 4};
+    const float odd[] = {2, 5, 2, 1, 5, 5, 2};
+    vector< vector<float> > valueSets;
+    valueSets.push_back (
+	vector<float> (even, even + sizeof (even) / sizeof (even[0])));
+    valueSets.push_back (
+	vector<float> (odd, odd + sizeof (odd) / sizeof (odd[0])));
+    // small sets drawn from a few values, so most of them have ties
+    unsigned int seed = 1;
+    for (size_t size = 1; size <= 64; ++size)
+	for (size_t i = 0; i < 16; ++i)
+	{
+	    vector<float> values (size);
+	    for (size_t j = 0; j < size; ++j)
+	    {
+		seed = seed * 1103515245 + 12345;
+		values[j] = (seed >> 16) % 8;
+	    }
+	    valueSets.push_back (values);
+	}
+    BOOST_FOREACH (const vector<float>& values, valueSets)
+	for (size_t i = 0; i < fractionsCount; ++i)
+	    checkQuantile (values, fractions[i]);
+    return valueSets.size () * fractionsCount;
+}
+
+void ValueCollector::checkQuantile (
+    const vector<float>& values, double fraction)
+{
+    vector<double> sorted (values.begin (), values.end ());
+    sort (sorted.begin (), sorted.end ());
+    double position = fraction * (sorted.size () - 1);
+    size_t rank = floor (position);
+    double expected = (rank + 1 == sorted.size ()) ? sorted[rank] :
+	sorted[rank] + (position - rank) * (sorted[rank + 1] - sorted[rank]);
+    ValueCollector collector;
+    collector.m_values = values;
+    double quantile = collector.Quantile (fraction);
+    if (quantile != expected)
+    {
+	ostringstream ostr;
+	ostr << "Quantile " << fraction << " of " << values.size () 
+	     << " values is " << quantile << " instead of " << expected;
+	ThrowException (ostr.str ());
+    }
+}
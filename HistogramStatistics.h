@@ -41,6 +41,11 @@ public:
     string RawToString () const;
     static size_t GetBin (double value, size_t binCount,
                           double beginInterval, double endInterval);
+    /**
+     * @return bytes used by the bins, including the underflow and
+     *         overflow bins
+     */
+    size_t GetMemorySize () const;
 
 };
 
@@ -49,12 +54,63 @@ typedef acc::accumulator_set<
     double, 
     acc::features<acc::tag::min, 
 		  acc::tag::max, acc::tag::count> > MinMaxStatistics;
-typedef acc::accumulator_set<
-    double, acc::features<acc::tag::median> > MedianStatistics;
 typedef acc::accumulator_set<
     double, acc::features<acc::tag::mean> > MeanStatistics;
 
 
+/**
+ * @brief Stores the values it is called with, in order.
+ *
+ * Used for a parallel reduction: each task collects the values for a
+ * time step and the values are added to the statistics in time step
+ * order afterwards. Floating point sums and the histogram bins do not
+ * depend on the number of threads this way. Values are stored as
+ * float, the type of body scalars, so all the values of a time step
+ * take half the memory they would as double.
+ */
+class ValueCollector
+{
+public:
+    void operator () (float value)
+    {
+	m_values.push_back (value);
+    }
+    template <typename Accumulator>
+    void Accumulate (Accumulator* acc) const
+    {
+	BOOST_FOREACH (float value, m_values)
+	    (*acc) (value);
+    }
+    size_t size () const
+    {
+	return m_values.size ();
+    }
+    /**
+     * Exact quantile of the values stored, interpolated linearly
+     * between the two closest ranks. Uses nth_element so the values
+     * are reordered.
+     * @param fraction in [0, 1], 0.5 is the median
+     * @return the quantile or 0 if there are no values
+     */
+    double Quantile (double fraction);
+    /**
+     * Checks Quantile against the quantile computed from the sorted
+     * values, for an even and an odd number of values with ties and
+     * for a fixed sequence of small value sets. Throws an exception
+     * for the first difference.
+     * @return how many quantiles were checked
+     */
+    static size_t CheckQuantile ();
+
+private:
+    static void checkQuantile (const vector<float>& values, 
+			       double fraction);
+
+private:
+    vector<float> m_values;
+};
+
+
 
 #endif //__HISTOGRAM_STATISTICS_H__
 
@@ -14,6 +14,7 @@
 #include "DisplayFaceFunctors.h"
 #include "DisplayEdgeFunctors.h"
 #include "Foam.h"
+#include "MemoryUsage.h"
 #include "Settings.h"
 #include "Simulation.h"
 #include "WidgetGl.h"
@@ -180,6 +181,16 @@ void ImageBasedAverage<PropertySetter>::AverageRelease ()
     m_fbos.m_debug.reset ();
 }
 
+template<typename PropertySetter>
+void ImageBasedAverage<PropertySetter>::GetMemoryUsage (
+    MemoryUsage* usage) const
+{
+    usage->AddFramebuffer (m_fbos.m_step.get ());
+    usage->AddFramebuffer (m_fbos.m_current.get ());
+    usage->AddFramebuffer (m_fbos.m_previous.get ());
+    usage->AddFramebuffer (m_fbos.m_debug.get ());
+}
+
 
 template<typename PropertySetter>
 void ImageBasedAverage<PropertySetter>::addStep (size_t timeStep, size_t subStep)
@@ -87,6 +87,7 @@ public:
 	return m_widgetGl;
     }
     G3D::Rect2D GetWindowCoord () const;
+    virtual void GetMemoryUsage (MemoryUsage* usage) const;
 
 protected:
     /**
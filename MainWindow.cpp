@@ -58,8 +58,10 @@ const char* MainWindow::PAUSE_TEXT ("||");
 // ======================================================================
 
 MainWindow::MainWindow (
-    boost::shared_ptr<const SimulationGroup> simulationGroup) : 
+    boost::shared_ptr<SimulationGroup> simulationGroup) : 
     m_timer (new QTimer(this)),
+    m_timerFollow (new QTimer(this)),
+    m_pinnedSimulationGroup (simulationGroup),
     m_processBodyTorus (0), 
     m_debugTranslatedBody (false),
     m_currentBody (0),
@@ -79,6 +81,7 @@ MainWindow::MainWindow (
     SetSettings(boost::shared_ptr<Settings> (
                     new Settings (simulationGroup, 
                                   widgetGl->width (), widgetGl->height ())));
+    pinViewTimeSteps ();
     connect (GetSettingsPtr ().get (),
              SIGNAL (SelectionChanged (ViewNumber::Enum)),
              this,
@@ -274,6 +277,8 @@ void MainWindow::connectSignals ()
     
     connect (m_timer.get (), SIGNAL (timeout()),
 	     this, SLOT (TimeoutTimer ()));
+    connect (m_timerFollow.get (), SIGNAL (timeout()),
+	     this, SLOT (TimeoutFollow ()));
     
     connect (widgetGl, SIGNAL (PaintEnd ()),
 	     widgetSave, SLOT (SaveFrame ()));
@@ -528,12 +533,12 @@ void MainWindow::translatedBodyStep ()
     if (m_debugTranslatedBody)
     {
 	Foam& currentFoam = const_cast<Foam&> (GetSimulation ().GetFoam (0));
-	VertexSet vertexSet;
-	EdgeSet edgeSet;
-	FaceSet faceSet;
-	currentFoam.GetVertexSet (&vertexSet);
-	currentFoam.GetEdgeSet (&edgeSet);
-	currentFoam.GetFaceSet (&faceSet);
+	VertexSet vertices = currentFoam.GetVertexSet ();
+	EdgeSet edges = currentFoam.GetEdgeSet ();
+	FaceSet faces = currentFoam.GetFaceSet ();
+	VertexHashSet vertexSet (vertices.begin (), vertices.end ());
+	EdgeHashSet edgeSet (edges.begin (), edges.end ());
+	FaceHashSet faceSet (faces.begin (), faces.end ());
 	m_currentTranslatedBody = currentFoam.BodyInsideOriginalDomainStep (
 	    m_currentTranslatedBody, &vertexSet, &edgeSet, &faceSet);
 	if (m_currentTranslatedBody == currentFoam.GetBodies ().end ())
@@ -557,12 +562,12 @@ void MainWindow::processBodyTorusStep ()
 	}
 	else
 	{
-	    VertexSet vertexSet;
-	    EdgeSet edgeSet;
-	    FaceSet faceSet;
-	    currentFoam.GetVertexSet (&vertexSet);
-	    currentFoam.GetEdgeSet (&edgeSet);
-	    currentFoam.GetFaceSet (&faceSet);
+	    VertexSet vertices = currentFoam.GetVertexSet ();
+	    EdgeSet edges = currentFoam.GetEdgeSet ();
+	    FaceSet faces = currentFoam.GetFaceSet ();
+	    VertexHashSet vertexSet (vertices.begin (), vertices.end ());
+	    EdgeHashSet edgeSet (edges.begin (), edges.end ());
+	    FaceHashSet faceSet (faces.begin (), faces.end ());
 	    if (! m_processBodyTorus->Step (&vertexSet, &edgeSet, &faceSet))
 	    {
 		m_processBodyTorus = 0;
@@ -1357,6 +1362,42 @@ void MainWindow::ButtonClickedEnd ()
     updateButtons ();
 }
 
+void MainWindow::Follow (boost::shared_ptr<SimulationGroup> simulationGroup)
+{
+    m_followedSimulationGroup = simulationGroup;
+    // a new file is added only if its size did not change between
+    // two checks
+    m_timerFollow->setInterval (2000);
+    m_timerFollow->start ();
+}
+
+void MainWindow::TimeoutFollow ()
+{
+    size_t appended = 0;
+    for (size_t i = 0; i < m_followedSimulationGroup->size (); ++i)
+    {
+	try
+	{
+	    appended += m_followedSimulationGroup->GetSimulation (i).
+		AppendDMPs ();
+	}
+	catch (const exception& e)
+	{
+	    cdbg << "Exception: " << e.what () << endl;
+	}
+    }
+    if (appended == 0)
+	return;
+    for (size_t i = 0; i < ViewNumber::COUNT; ++i)
+    {
+	ViewSettings& vs = GetViewSettings (ViewNumber::Enum (i));
+	vs.AppendTimeSteps (GetSimulation (vs.GetSimulationIndex ()));
+    }
+    timeViewToUI (GetViewNumber ());
+    bubblePathsViewToUI ();
+    ValueChangedSliderTimeSteps (sliderTimeSteps->value ());
+}
+
 void MainWindow::TimeoutTimer ()
 {
     int value = sliderTimeSteps->value ();
@@ -1493,6 +1534,7 @@ void MainWindow::ValueChangedSliderTimeSteps (int timeStep)
         GetSettingsPtr ()->UpdateAverageTimeWindow ();
         timeViewToUI (GetViewNumber ());
     }
+    pinViewTimeSteps ();
     for (size_t i = 0; i < vn.size (); ++i)
     {
         ViewNumber::Enum viewNumber = vn[i];
@@ -1529,6 +1571,45 @@ void MainWindow::ValueChangedSliderTimeSteps (int timeStep)
     updateButtons ();
 }
 
+/**
+ * Keeps in memory the time steps the views draw: the first and the
+ * last time step of every simulation and the time of every view. An
+ * average view also needs its time window and the step next to it. The new pins are taken
+ * before the old ones are dropped so that time steps used by both stay
+ * loaded.
+ */
+void MainWindow::pinViewTimeSteps ()
+{
+    vector< boost::shared_ptr<TimeStepPin> > pins;
+    for (size_t i = 0; i < m_pinnedSimulationGroup->size (); ++i)
+    {
+	Simulation& simulation = m_pinnedSimulationGroup->GetSimulation (i);
+	pins.push_back (simulation.Pin (0));
+	pins.push_back (simulation.Pin (simulation.GetTimeSteps () - 1));
+    }
+    for (size_t i = 0; i < ViewNumber::COUNT; ++i)
+    {
+	const ViewSettings& vs = GetViewSettings (ViewNumber::Enum (i));
+	Simulation& simulation = 
+	    m_pinnedSimulationGroup->GetSimulation (vs.GetSimulationIndex ());
+	size_t last = simulation.GetTimeSteps () - 1;
+	size_t time = min (vs.GetTime (), last);
+	size_t begin = time;
+	size_t end = time + 1;
+	if (vs.GetViewType () == ViewType::AVERAGE || 
+	    vs.GetViewType () == ViewType::T1_KDE)
+	{
+	    // Average::AverageStep removes the step that left the window,
+	    // before the current time going forward or after it going back
+	    begin -= min (time, vs.GetTimeWindow ());
+	    end = min (time + 1, last) + 1;
+	}
+	for (size_t t = begin; t < end; ++t)
+	    pins.push_back (simulation.Pin (t));
+    }
+    m_pins.swap (pins);
+}
+
 void MainWindow::ValueChangedT1Size (int index)
 {
     (void)index;
@@ -1547,6 +1628,7 @@ void MainWindow::ValueChangedAverageTimeWindow (int timeSteps)
         GetViewSettings (viewNumber).SetTimeWindow (timeSteps);
     else
         GetSettingsPtr ()->SetAverageTimeWindow (timeSteps);
+    pinViewTimeSteps ();
     timeViewToUI (viewNumber);
 }
 
@@ -1620,6 +1702,7 @@ void MainWindow::ButtonClickedViewType (int vt)
     }
     ViewType::Enum oldViewType = 
         GetSettingsPtr ()->SetTwoHalvesViewType (viewType);
+    pinViewTimeSteps ();
     if (oldViewType == ViewType::T1_KDE)
     {
         vector<QWidget*> widgetsEnabled = getHistogramWidgets ();
@@ -1695,6 +1778,7 @@ void MainWindow::CurrentIndexChangedSimulation (int simulationIndex)
 	getColorMapScalar (
             simulationIndex, viewNumber, viewType, property, statisticsType));
     widgetGl->CurrentIndexChangedSimulation (simulationIndex);
+    pinViewTimeSteps ();
     ViewToUI (viewNumber);
 }
 
@@ -1896,9 +1980,13 @@ void MainWindow::EditColorMapVelocity ()
 	GetViewSettings (viewNumber).GetSimulationIndex ();
     boost::shared_ptr<ColorBarModel> colorBarModel = 
 	m_colorMapVelocity[simulationIndex][viewNumber];
+    // the time steps of the views are pinned (@see pinViewTimeSteps)
+    const Foam& foam = GetSimulation (viewNumber).GetFoam (
+	GetViewSettings (viewNumber).GetTime ());
     m_editColorMap->SetData (p.first, p.second, 
 			     *colorBarModel,
-			     checkBoxHistogramGridShown->isChecked ());
+			     checkBoxHistogramGridShown->isChecked (),
+			     &foam, BodyScalar::VELOCITY_MAGNITUDE);
     if (m_editColorMap->exec () == QDialog::Accepted)
     {
 	*colorBarModel = m_editColorMap->GetColorMap ();
@@ -1909,11 +1997,23 @@ void MainWindow::EditColorMapVelocity ()
 
 void MainWindow::EditColorMapScalar ()
 {
+    size_t bodyOrOtherScalar = widgetGl->GetBodyOrOtherScalar ();
     HistogramInfo p = getHistogramInfo (
-	GetSettings ().GetColorMapScalarType (), widgetGl->GetBodyOrOtherScalar ());
+	GetSettings ().GetColorMapScalarType (), bodyOrOtherScalar);
+    ViewNumber::Enum viewNumber = GetViewNumber ();
+    // the time steps of the views are pinned (@see pinViewTimeSteps)
+    const Foam& foam = GetSimulation (viewNumber).GetFoam (
+	GetViewSettings (viewNumber).GetTime ());
+    bool bodyScalar = 
+	GetSettings ().GetColorMapScalarType () == 
+	ColorMapScalarType::PROPERTY &&
+	bodyOrOtherScalar < BodyScalar::COUNT;
     m_editColorMap->SetData (
 	p.first, p.second, *getColorMapScalar (),
-	checkBoxHistogramGridShown->isChecked ());
+	checkBoxHistogramGridShown->isChecked (),
+	bodyScalar ? &foam : 0,
+	bodyScalar ? BodyScalar::FromSizeT (bodyOrOtherScalar) :
+	BodyScalar::PRESSURE);
     if (m_editColorMap->exec () == QDialog::Accepted)
     {
 	*getColorMapScalar () = m_editColorMap->GetColorMap ();
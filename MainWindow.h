@@ -22,6 +22,7 @@ class QTimer;
 class Settings;
 class SimulationGroup;
 class DerivedData;
+class TimeStepPin;
 
 /**
  * @brief Stores the OpenGL, Vtk and, Histogram widgets, implements
@@ -44,7 +45,12 @@ public:
      * Constructor
      * @param simulationGroup data to be displayed
      */
-    MainWindow(boost::shared_ptr<const SimulationGroup> simulationGroup);
+    MainWindow(boost::shared_ptr<SimulationGroup> simulationGroup);
+    /**
+     * Periodically adds to the simulations the time steps written
+     * after they were loaded (@see Simulation::AppendDMPs)
+     */
+    void Follow (boost::shared_ptr<SimulationGroup> simulationGroup);
     /**
      * Called when a key is pressed
      * @param event object describing the key
@@ -148,6 +154,10 @@ public Q_SLOTS:
      * Invoqued by the timer to show the next data in the vector
      */
     void TimeoutTimer ();
+    /**
+     * Invoqued by the follow timer to add new time steps
+     */
+    void TimeoutFollow ();
     
 
     void ValueChangedT1KDEIsosurfaceAlpha (int value);
@@ -184,6 +194,7 @@ private:
     void currentIndexChangedOtherScalar (ViewNumber::Enum viewNumber);
     void settingsViewToUI (ViewNumber::Enum viewNumber);
     void timeViewToUI (ViewNumber::Enum viewNumber);
+    void pinViewTimeSteps ();
     void linkedTimeEventsViewToUI (ViewNumber::Enum viewNumber);
     void t1ViewToUI ();
     void velocityViewToUI ();
@@ -290,6 +301,16 @@ private:
      * display the files too fast.
      */    
     boost::scoped_ptr<QTimer> m_timer;
+    /**
+     * Timer used to check for new time steps (@see Follow)
+     */
+    boost::scoped_ptr<QTimer> m_timerFollow;
+    boost::shared_ptr<SimulationGroup> m_followedSimulationGroup;
+    /**
+     * Time steps the views draw (@see pinViewTimeSteps)
+     */
+    boost::shared_ptr<SimulationGroup> m_pinnedSimulationGroup;
+    vector< boost::shared_ptr<TimeStepPin> > m_pins;
     
     ////////////
     // Debug PBC
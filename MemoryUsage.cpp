@@ -0,0 +1,94 @@
+/**
+ * @file   MemoryUsage.cpp
+ * @author Dan R. Lipsa
+ *
+ * Definitions for the MemoryUsage class.
+ */
+
+#include "MemoryUsage.h"
+
+
+// Private Functions
+// ======================================================================
+
+namespace
+{
+const int COLUMN_WIDTH = 12;
+
+size_t toKb (size_t bytes)
+{
+    return (bytes + 1023) / 1024;
+}
+}
+
+
+// Methods
+// ======================================================================
+
+MemoryUsage::MemoryUsage ()
+{
+    m_bytes.assign (0);
+}
+
+void MemoryUsage::AddFramebuffer (const QGLFramebufferObject* fbo)
+{
+    if (fbo == 0)
+	return;
+    size_t pixels = fbo->size ().width () * fbo->size ().height ();
+    size_t bytesPerPixel =
+	(fbo->format ().internalTextureFormat () == GL_RGBA32F) ? 16 : 4;
+    if (fbo->attachment () != QGLFramebufferObject::NoAttachment)
+	// 24 bit depth and 8 bit stencil
+	bytesPerPixel += 4;
+    Add (MemoryCategory::TEXTURES, pixels * bytesPerPixel);
+}
+
+void MemoryUsage::AddRegularGrid (vtkImageData* data)
+{
+    if (data == 0)
+	return;
+    // GetActualMemorySize returns KB
+    Add (MemoryCategory::REGULAR_GRIDS,
+	 static_cast<size_t> (data->GetActualMemorySize ()) * 1024);
+}
+
+size_t MemoryUsage::GetTotal () const
+{
+    return accumulate (m_bytes.begin (), m_bytes.end (), size_t (0));
+}
+
+MemoryUsage& MemoryUsage::operator+= (const MemoryUsage& other)
+{
+    for (size_t i = 0; i < MemoryCategory::COUNT; ++i)
+	m_bytes[i] += other.m_bytes[i];
+    return *this;
+}
+
+ostream& MemoryUsage::PrintHeader (ostream& ostr, const char* firstColumn)
+{
+    ostr << left << setw (COLUMN_WIDTH) << firstColumn << right;
+    for (size_t i = 0; i < MemoryCategory::COUNT; ++i)
+    {
+	// the names are too long for a column
+	string name = MemoryCategory::ToString (MemoryCategory::Enum (i));
+	ostr << " " << setw (COLUMN_WIDTH) << name.substr (0, COLUMN_WIDTH);
+    }
+    return ostr << " " << setw (COLUMN_WIDTH) << "total" << endl;
+}
+
+ostream& MemoryUsage::PrintRow (ostream& ostr, const string& firstColumn) const
+{
+    ostr << left << setw (COLUMN_WIDTH) << firstColumn << right;
+    for (size_t i = 0; i < MemoryCategory::COUNT; ++i)
+	ostr << " " << setw (COLUMN_WIDTH) << toKb (m_bytes[i]);
+    return ostr << " " << setw (COLUMN_WIDTH) << toKb (GetTotal ()) << endl;
+}
+
+ostream& MemoryUsage::Print (ostream& ostr) const
+{
+    for (size_t i = 0; i < MemoryCategory::COUNT; ++i)
+	if (m_bytes[i] != 0)
+	    ostr << MemoryCategory::ToString (MemoryCategory::Enum (i))
+		 << ": " << toKb (m_bytes[i]) << " KB" << endl;
+    return ostr << "total: " << toKb (GetTotal ()) << " KB" << endl;
+}
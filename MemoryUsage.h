@@ -0,0 +1,69 @@
+/**
+ * @file   MemoryUsage.h
+ * @author Dan R. Lipsa
+ * @brief Bytes used by the data structures of a simulation
+ * @ingroup utils
+ */
+
+#ifndef __MEMORY_USAGE_H__
+#define __MEMORY_USAGE_H__
+
+#include "Enums.h"
+
+/**
+ * @brief Bytes used by the data structures of a simulation
+ *
+ * Sizes are computed from the number of objects and the capacity of
+ * their containers, so they are an estimate: memory used by the heap
+ * itself and by reference counts is not included. Used to size jobs
+ * and to see which data structures dominate (@see
+ * Simulation::GetMemoryInfo).
+ */
+class MemoryUsage
+{
+public:
+    MemoryUsage ();
+    void Add (MemoryCategory::Enum category, size_t bytes)
+    {
+	m_bytes[category] += bytes;
+    }
+    /**
+     * Adds the color and depth buffers of a framebuffer object to
+     * TEXTURES
+     */
+    void AddFramebuffer (const QGLFramebufferObject* fbo);
+    /**
+     * Adds the arrays of a regular grid to REGULAR_GRIDS
+     */
+    void AddRegularGrid (vtkImageData* data);
+    size_t Get (MemoryCategory::Enum category) const
+    {
+	return m_bytes[category];
+    }
+    size_t GetTotal () const;
+    MemoryUsage& operator+= (const MemoryUsage& other);
+
+    /**
+     * Prints a line with the names of the categories, in KB, as
+     * columns of a table
+     */
+    static ostream& PrintHeader (ostream& ostr, const char* firstColumn);
+    /**
+     * Prints a line with the KB used by each category and the total
+     */
+    ostream& PrintRow (ostream& ostr, const string& firstColumn) const;
+    /**
+     * Prints one line for each category that uses memory and the total
+     */
+    ostream& Print (ostream& ostr) const;
+
+private:
+    boost::array<size_t, MemoryCategory::COUNT> m_bytes;
+};
+
+
+#endif //__MEMORY_USAGE_H__
+
+// Local Variables:
+// mode: c++
+// End:
@@ -18,7 +18,7 @@ void ObjectPositions::SetAverageAroundPositions (
     m_averageAroundPositions.resize (simulation.GetTimeSteps ());
     for (size_t i = 0; i < m_averageAroundPositions.size (); ++i)
 	m_averageAroundPositions[i] = 
-	    simulation.GetFoam (i).GetDmpObjectPosition ();
+	    simulation.GetFoamSummary (i).GetDmpObjectPosition ();
 }
 
 void ObjectPositions::SetAverageAroundPositions (
@@ -28,7 +28,7 @@ void ObjectPositions::SetAverageAroundPositions (
     for (size_t i = 0; i < m_averageAroundPositions.size (); ++i)
     {
 	ObjectPosition& objectPosition = m_averageAroundPositions[i];
-	const Foam& foam = simulation.GetFoam (i);
+	const Foam& foam = simulation.GetFoamSummary (i);
 	objectPosition.m_angleRadians = 0;
 	objectPosition.m_rotationCenter = 
 	    (*foam.FindBody (bodyId))->GetCenter ();
@@ -40,14 +40,15 @@ void ObjectPositions::SetAverageAroundPositions (
     size_t bodyId, size_t secondBodyId)
 {
     G3D::Vector2 beginAxis = 
-	simulation.GetFoam (0).GetAverageAroundAxis (bodyId, secondBodyId);
+	simulation.GetFoamSummary (0).GetAverageAroundAxis (
+	    bodyId, secondBodyId);
     // the angle for i = 0 is already set to 0. Trying to calculate will results 
     // in acosValue slightly greater than 1, a Nan and then an error 
     // in gluUnProject.
     for (size_t i = 1; i < m_averageAroundPositions.size (); ++i)
     {
 	ObjectPosition& objectPosition = m_averageAroundPositions[i];
-	const Foam& foam = simulation.GetFoam (i);
+	const Foam& foam = simulation.GetFoamSummary (i);
 
 	G3D::Vector2 currentAxis = 
 	    foam.GetAverageAroundAxis (bodyId, secondBodyId);
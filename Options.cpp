@@ -7,7 +7,9 @@
  */
 
 #include "Debug.h"
+#include "HistogramStatistics.h"
 #include "Options.h"
+#include "ParsingDriver.h"
 #include "BrowseSimulations.h"
 
 // Private Classes/Functions
@@ -49,17 +51,21 @@ void filterAndExpandWildcards (vector<string>* fileNames, string filter)
                         fileName.toStdString ());
     QRegExp rx("\\?+");
     fileName.replace (rx, QString (filter.c_str ()));
-    QDir dir (path, fileName);
+    // accept compressed DMP files as well, but prefer the uncompressed
+    // file if both are present
+    QDir dir (path);
+    dir.setNameFilters (
+	QStringList () << fileName << fileName + ".gz" << fileName + ".zst");
     QStringList fns = dir.entryList ();
-    fileNames->resize (fns.size ());
-    vector<string>::iterator itDest = fileNames->begin ();
-    QStringList::const_iterator itSrc = fns.constBegin ();
-    while (itSrc != fns.constEnd ())
+    fileNames->clear ();
+    BOOST_FOREACH (const QString& fn, fns)
     {
-	QString full = path + "/" + *itSrc;
-	*itDest = full.toStdString ();
-	++itSrc;
-	++itDest;
+	QString uncompressed = fn;
+	uncompressed.remove (QRegExp ("\\.(gz|zst)$"));
+	if (uncompressed != fn && fns.contains (uncompressed))
+	    continue;
+	QString full = path + "/" + fn;
+	fileNames->push_back (full.toStdString ());
     }
 }
 
@@ -188,6 +194,21 @@ void printVersion ()
     cout << endl;
 }
 
+void checkQuantile ()
+{
+    size_t checked = ValueCollector::CheckQuantile ();
+    cout << checked << " quantiles checked against the sorted values" 
+	 << endl;
+}
+
+void checkRealConversion ()
+{
+    size_t fast;
+    size_t checked = ParsingDriver::CheckRealConversion (&fast);
+    cout << checked << " reals checked, " << fast 
+	 << " converted without strtod to the same value as strtod" << endl;
+}
+
 
 void questionMarkCount (const vector<string>& parameters, vector<size_t>* c)
 {
@@ -298,23 +319,36 @@ void validate(boost::any& v, const std::vector<std::string>& values,
 // ======================================================================
 
 const char* Option::m_name[] = {
+    "attributes",
+    "benchmark",
+    "benchmark-scanner",
+    "check-quantile",
+    "check-real-conversion",
     "constraint",
     "constraint-rotation",
     "debug-parsing",
     "debug-scanning",
     "dmp-files",
+    "element-arena",
     "filter",
+    "follow",
     "force",
     "help",
+    "in-flight-time-steps",
     "ini-file",
     "name",
     "labels",
+    "no-mmap",
+    "no-parallel-sections",
+    "no-snapshot",
     "original-pressure",
     "output-text",
     "parameters",
     "reflection-axis",
+    "resident-time-steps",
     "resolution",
     "rotation-2d",
+    "share-topology",
     "simulation",
     "simulation-box",
     "t1s",
@@ -343,6 +377,16 @@ void CommandLineOptions::read (int argc, char *argv[])
 	printVersion ();
 	exit (0);
     }
+    if (m_vm.count (Option::m_name[Option::CHECK_QUANTILE]))
+    {
+	checkQuantile ();
+	exit (0);
+    }
+    if (m_vm.count (Option::m_name[Option::CHECK_REAL_CONVERSION]))
+    {
+	checkRealConversion ();
+	exit (0);
+    }
     if (m_vm.count (Option::m_name[Option::HELP])) 
     {	
 	cout << CommonOptions::getDescription () << "\n";
@@ -376,6 +420,24 @@ po::options_description CommandLineOptions::getDescription (
     po::options_description commandLineOptions (
 	"COMMAND_LINE_OPTIONS");
     commandLineOptions.add_options()
+	(Option::m_name[Option::BENCHMARK],
+	 "loads the simulation without a user interface, ignoring "
+	 "snapshots, and prints as JSON the wall-clock and CPU time, the "
+	 "bytes processed and the peak resident set size for each phase "
+	 "of the loading. The parse phase includes scanning and "
+	 "Foam::Preprocess.")
+	(Option::m_name[Option::BENCHMARK_SCANNER],
+	 "runs only the scanner over the DMP files, without loading the "
+	 "simulation, and prints its timings as JSON, same as --benchmark. "
+	 "Run it separately from --benchmark so that the scan does not "
+	 "read the files ahead of the timed load.")
+	(Option::m_name[Option::CHECK_QUANTILE],
+	 "checks the exact quantiles used for the pressure medians against "
+	 "the sorted values, with even and odd counts and ties, and exits")
+	(Option::m_name[Option::CHECK_REAL_CONVERSION],
+	 "checks that the scanner converts reals to the same values as "
+	 "strtod, for values at the limits of its fast conversion, and "
+	 "exits")
 	(Option::m_name[Option::DEBUG_PARSING], 
 	 "produces output that help debugging the parser")
 	(Option::m_name[Option::DEBUG_SCANNING], 
@@ -389,14 +451,57 @@ po::options_description CommandLineOptions::getDescription (
 	 "'???1' which selects DMP files numbered 0001, 0011, 0021, ..., 0091, "
 	 "0101, ...., filter '0001' results in patern '0001' which selects "
 	 "only the DMP numbered 0001.")
+	(Option::m_name[Option::ELEMENT_ARENA],
+	 "allocate the vertices, edges and faces of each time step "
+	 "from one arena, which is freed in one piece when the time step "
+	 "is freed. This makes loading and freeing time steps faster.")
+	(Option::m_name[Option::FOLLOW],
+	 "watch the directory of the DMP files and add to the simulation "
+	 "the DMP files written after it was loaded, for instance by a "
+	 "Surface Evolver job that is still running. New files need to "
+	 "have the same name pattern as the loaded ones and sort after them.")
 	(Option::m_name[Option::HELP], "produce help message")
+	(Option::m_name[Option::IN_FLIGHT_TIME_STEPS],
+	 po::value<size_t> (),
+	 "parse and preprocess the DMP files in batches of a number of "
+	 "time steps. The parsing data of a time step is freed as soon "
+	 "as the time step is preprocessed, so only a batch keeps it "
+	 "at a time.\n"
+	 "arg=<n> where n=0 parses all DMP files before preprocessing "
+	 "them. The default is twice the number of cores.")
 	(Option::m_name[Option::INI_FILE], 
 	 po::value<string>(iniFileName), 
 	 "choose simulation and read visualization parameters " 
 	 "from the ini file.\n"
 	 "arg=<iniFileName>. See simulations.ini for an example.")
+	(Option::m_name[Option::NO_MMAP],
+	 "read DMP files through stdio instead of scanning "
+	 "a memory mapping of each file.")
+	(Option::m_name[Option::NO_PARALLEL_SECTIONS],
+	 "parse the vertices, edges, faces and bodies of a large DMP "
+	 "file serially. By default they are parsed in parallel by "
+	 "the threads that are not busy parsing other DMP files.")
+	(Option::m_name[Option::NO_SNAPSHOT],
+	 "parse all DMP files, ignoring the binary snapshots saved "
+	 "in the cache directory by a previous run.")
 	(Option::m_name[Option::OUTPUT_TEXT],
-	 "outputs a text representation of the data")
+	 "outputs a text representation of the data followed by the memory "
+	 "used by each time step and the peak and the change in resident "
+	 "memory of each loading phase")
+	(Option::m_name[Option::RESIDENT_TIME_STEPS],
+	 po::value<size_t> (),
+	 "keep in memory the vertices, edges and faces for only a "
+	 "number of time steps. The other time steps keep only their "
+	 "bodies and statistics and are read again when displayed.\n"
+	 "arg=<n> where n=0 (the default) keeps all time steps in memory, "
+	 "otherwise n >= 2. Use at least the number of time steps "
+	 "in the averaging time window.")
+	(Option::m_name[Option::SHARE_TOPOLOGY],
+	 "keep in memory the time steps that are not resident, instead "
+	 "of reading them again from their DMP files. A time step with "
+	 "the same vertices, edges, faces and bodies as the previous "
+	 "time step shares them and keeps only its own positions and "
+	 "attributes. Sets --resident-time-steps to 8 if it is not set.")
 	(Option::m_name[Option::SIMULATION],
 	 po::value< vector<string> >(simulationName),
 	 "arg=<simulationNames>, parse the simulations with names "
@@ -418,7 +523,7 @@ CommonOptions::CommonOptions () :
 	getCommonAndHiddenOptions (
             &m_fileNames, 
             getDescription (
-                &m_t1sFile, &m_dmpObjectInfo, &m_forceNames, 
+                &m_attributes, &m_t1sFile, &m_dmpObjectInfo, &m_forceNames, 
                 &m_ticksForTimeStep, &m_simulationBoundingBoxAllTimeSteps, 
                 &m_resolution, &m_rotation2D, &m_reflectionAxis)))
 {
@@ -440,6 +545,10 @@ void CommonOptions::read (int argc, char *argv[])
 		       "Invalid axis: ", m_reflectionAxis);
     if (m_dmpObjectInfo.m_constraintIndex != INVALID_INDEX)
 	--m_dmpObjectInfo.m_constraintIndex;
+    typedef boost::tokenizer< boost::char_separator<char> > Tokenizer;
+    boost::char_separator<char> sep(", ");
+    Tokenizer tok (m_attributes, sep);
+    m_loadAttributes.assign (tok.begin (), tok.end ());
     if (argc == 1 || ! m_vm.count (Option::m_name[Option::DMP_FILES]))
     {
 	printVersion ();
@@ -474,7 +583,7 @@ void CommonOptions::read (string parameters, string filter)
 
 
 po::options_description CommonOptions::getDescription (
-    string* t1sFile,
+    string* attributes, string* t1sFile,
     DmpObjectInfo* dmpObjectInfo,
     vector<ForceNamesOneObject>* forceNames,
     size_t* ticksForTimeStep, G3D::AABox* simulationBox, size_t* resolution,
@@ -494,6 +603,13 @@ po::options_description CommonOptions::getDescription (
 	"\t./foam --t1s /home/dlipsa/Documents/swansea-phd/foam/ctrctndumps_704v_0.1520_0.2400_8.0000_v1/energy_704v_0.1520_0.2400_8.0000_v1.dat /home/dlipsa/Documents/swansea-phd/foam/ctrctndumps_704v_0.1520_0.2400_8.0000_v1/dump_0.1520_0.2400_8.0000_0???.dmp\n"
 	"COMMON_OPTIONS");
     commonOptions.add_options()
+	(Option::m_name[Option::ATTRIBUTES],
+	 po::value<string>(attributes),
+	 "user defined attributes (DEFINE ... ATTRIBUTE) stored for "
+	 "vertices, edges, faces and bodies.\n"
+	 "arg=\"<name>,<name>,...\" Values of the other user defined "
+	 "attributes are skipped when parsing. By default no user "
+	 "defined attribute is stored.")
 	(Option::m_name[Option::CONSTRAINT],
 	 po::value<size_t>(&dmpObjectInfo->m_constraintIndex), 
 	 "a constraint that specifies an object.\n"
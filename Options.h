@@ -20,23 +20,36 @@ struct Option
 {
     enum Enum
     {
+	ATTRIBUTES,
+	BENCHMARK,
+	BENCHMARK_SCANNER,
+	CHECK_QUANTILE,
+	CHECK_REAL_CONVERSION,
 	CONSTRAINT,
 	CONSTRAINT_ROTATION,
 	DEBUG_PARSING,
 	DEBUG_SCANNING,
 	DMP_FILES,
+	ELEMENT_ARENA,
 	FILTER,
+	FOLLOW,
 	FORCES,
 	HELP,
+	IN_FLIGHT_TIME_STEPS,
 	INI_FILE,
 	NAME,
 	LABELS,
+	NO_MMAP,
+	NO_PARALLEL_SECTIONS,
+	NO_SNAPSHOT,
 	ORIGINAL_PRESSURE,
 	OUTPUT_TEXT,
 	PARAMETERS,
 	REFLECTION_AXIS,
+	RESIDENT_TIME_STEPS,
 	RESOLUTION,
 	ROTATION_2D,
+	SHARE_TOPOLOGY,
 	SIMULATION,
         SIMULATION_BOX,
 	T1S,
@@ -93,17 +106,21 @@ public:
     void read (string parameters, string filter);
     static po::options_description getDescription ()
     {
-	return getDescription (0, 0, 0, 0, 0, 0, 0, 0);
+	return getDescription (0, 0, 0, 0, 0, 0, 0, 0, 0);
     }
 
     static po::options_description getDescription (
-	string* t1sFile,
+	string* attributes, string* t1sFile,
 	DmpObjectInfo* dmpObjectInfo,
 	vector<ForceNamesOneObject>* forcesNames,
 	size_t* ticksForTimeStep, G3D::AABox* simulationBox, size_t* resolution,
 	int* rotation2D, size_t* reflectionAxis);
 
 public:
+    /**
+     * User defined attributes to load, parsed from m_attributes
+     */
+    vector<string> m_loadAttributes;
     string m_t1sFile;
     vector<string> m_fileNames;
     DmpObjectInfo m_dmpObjectInfo;
@@ -116,6 +133,7 @@ public:
     po::variables_map m_vm;
 
 private:
+    string m_attributes;
     po::options_description m_commonOptions;
     po::positional_options_description m_positionalOptions;
 };
@@ -8,11 +8,13 @@
 #include "Attribute.h"
 #include "Debug.h"
 #include "Edge.h"
+#include "ElementArena.h"
 #include "ExpressionTree.h"
 #include "Face.h"
 #include "Foam.h"
 #include "ParsingData.h"
 #include "QuadraticEdge.h"
+#include "SectionParser.h"
 #include "Utils.h"
 #include "Vertex.h"
 
@@ -90,7 +92,8 @@ ParsingData::ParsingData (
     m_newLineSignificant (false),
     m_useOriginal (useOriginal),
     m_dmpObjectInfo (dmpObjectInfo),
-    m_keywordsIgnored (false)
+    m_keywordsIgnored (false),
+    m_sectionRecords (0)
 {
     m_forceNames.resize (forcesNames.size ());
     copy (forcesNames.begin (), forcesNames.end (), m_forceNames.begin ());
@@ -222,16 +225,50 @@ ParsingData::BinaryFunctionIt ParsingData::GetBinaryFunctionIt (
 
 const char* ParsingData::CreateIdentifier(const char* name)
 {
-    pair<Identifiers::iterator, bool> p = m_identifiers.insert (name);
-    return p.first->c_str ();
+    // look up the C string first so that no string is built for
+    // identifiers seen before
+    Identifiers::const_iterator it =
+	m_identifiers.find (name, HashNoCase (), EqualNoCase ());
+    if (it == m_identifiers.end ())
+	it = m_identifiers.insert (name).first;
+    return it->c_str ();
+}
+
+void ParsingData::SetLoadAttributes (const vector<string>& names)
+{
+    m_loadAttributeNames = names;
+    sort (m_loadAttributeNames.begin (), m_loadAttributeNames.end (),
+	  LessThanNoCase ());
+    m_loadAttributes.clear ();
+    BOOST_FOREACH (const string& name, names)
+	m_loadAttributes.insert (CreateIdentifier (name.c_str ()));
+}
+
+void ParsingData::CopyHeader (const ParsingData& header)
+{
+    SetFile (header.GetFile ());
+    SetDebugParsing (header.IsDebugParsing ());
+    SetDebugScanning (header.IsDebugScanning ());
+    m_variables = header.m_variables;
+    m_arrays = header.m_arrays;
+    // identifiers are interned in this object
+    BOOST_FOREACH (const char* id, header.m_attributes)
+	AddAttribute (id, header.IsAttributeLoaded (id));
+    BOOST_FOREACH (const char* id, header.m_methodOrQuantity)
+	AddMethodOrQuantity (id);
 }
 
 void ParsingData::SetVertex (size_t i, double x, double y, double z,
 			     vector<NameSemanticValue*>& attributes,
 			     const AttributesInfo& attributesInfo) 
 {
+    if (m_sectionRecords != 0)
+    {
+	m_sectionRecords->AddVertex (i, x, y, z, attributes);
+	return;
+    }
     resizeAllowIndex (&m_vertices, i);
-    boost::shared_ptr<Vertex> vertex = boost::make_shared<Vertex> (x, y ,z, i);
+    boost::shared_ptr<Vertex> vertex = MakeElement<Vertex> (x, y ,z, i);
     if (&attributes != 0)
         vertex->StoreAttributes (attributes, attributesInfo);
     m_vertices[i] = vertex;
@@ -244,14 +281,20 @@ void ParsingData::SetEdge (size_t i,
 			   const AttributesInfo& attributesInfo,
 			   bool isQuadratic)
 {
+    if (m_sectionRecords != 0)
+    {
+	m_sectionRecords->AddEdge (i, begin, end, middle, endTranslation,
+				   attributes);
+	return;
+    }
     resizeAllowIndex (&m_edges, i);
     boost::shared_ptr<Edge> edge;
     if (isQuadratic)
-	edge.reset (new QuadraticEdge (
-			GetVertex(begin), GetVertex(end), GetVertex (middle), 
-			endTranslation, i));
+	edge = MakeElement<QuadraticEdge> (
+	    GetVertex(begin), GetVertex(end), GetVertex (middle), 
+	    endTranslation, i);
     else
-	edge = boost::make_shared<Edge> (
+	edge = MakeElement<Edge> (
 	    GetVertex(begin), GetVertex(end), endTranslation, i);
     if (&attributes != 0)
         edge->StoreAttributes (attributes, attributesInfo);
@@ -262,8 +305,13 @@ void ParsingData::SetFace (size_t i,  vector<int>& edges,
 			   vector<NameSemanticValue*>& attributes,
 			   const AttributesInfo& attributesInfo)
 {
+    if (m_sectionRecords != 0)
+    {
+	m_sectionRecords->AddFace (i, edges, attributes);
+	return;
+    }
     resizeAllowIndex (&m_faces, i);
-    boost::shared_ptr<Face> face = boost::make_shared<Face> (edges, m_edges, i);
+    boost::shared_ptr<Face> face = MakeElement<Face> (edges, m_edges, i);
     if (&attributes != 0)
         face->StoreAttributes (attributes, attributesInfo);
     m_faces[i] = face;
@@ -273,6 +321,38 @@ void ParsingData::SetConstraint (size_t i, ExpressionTree* function)
 {
     resizeAllowIndex (&m_constraints, i);
     m_constraints[i].reset (function);
+    resizeAllowIndex (&m_constraintPrograms, i);
+    m_constraintPrograms[i].reset ();
+}
+
+const ExpressionProgram& ParsingData::GetConstraintProgram (size_t i)
+{
+    boost::shared_ptr<ExpressionProgram>& program = m_constraintPrograms[i];
+    if (! program)
+	program.reset (new ExpressionProgram (*m_constraints[i]));
+    return *program;
+}
+
+size_t ParsingData::GetMemorySize () const
+{
+    // a node in a red-black tree has three links and a color, a node in
+    // a hash table has one link
+    const size_t treeNode = 4 * sizeof (void*);
+    size_t size = sizeof (ParsingData) +
+	(m_vertices.capacity () + m_edges.capacity () + m_faces.capacity ()) *
+	sizeof (Vertices::value_type) +
+	m_variables.size () * (sizeof (Variables::value_type) + treeNode) +
+	m_arrays.size () * (sizeof (Arrays::value_type) + treeNode) +
+	m_unaryFunctions.size () *
+	(sizeof (UnaryFunctions::value_type) + treeNode) +
+	m_binaryFunctions.size () *
+	(sizeof (BinaryFunctions::value_type) + treeNode) +
+	m_constraints.capacity () * sizeof (Constraints::value_type) +
+	m_constraintPrograms.capacity () * 
+	sizeof (ConstraintPrograms::value_type);
+    BOOST_FOREACH (const string& identifier, m_identifiers)
+	size += sizeof (string) + sizeof (void*) + identifier.capacity ();
+    return size;
 }
 
 string ParsingData::ToString () const
@@ -17,7 +17,9 @@
 
 class AttributesInfo;
 class ExpressionTree;
+class ExpressionProgram;
 class AttributeArrayAttribute;
+class SectionRecords;
 
 /**
  * @brief Stores data used during  the parsing such as identifiers, variables
@@ -63,13 +65,19 @@ public:
     typedef map<string, BinaryFunction, LessThanNoCase> BinaryFunctions;
     typedef BinaryFunctions::const_iterator BinaryFunctionIt;
     /**
-     * Identifiers type
+     * Identifiers type. Identifiers that differ only in case are stored
+     * once so the pointer to an identifier identifies it.
      */
-    typedef set<string, LessThanNoCase> Identifiers;
+    typedef boost::unordered_set<string, HashNoCase, EqualNoCase> Identifiers;
+    /**
+     * Set of identifiers returned by CreateIdentifier
+     */
+    typedef boost::unordered_set<const char*> IdentifierSet;
     typedef vector< boost::shared_ptr<Vertex> > Vertices;
     typedef vector< boost::shared_ptr<Edge> > Edges;
     typedef vector< boost::shared_ptr<Face> > Faces;
     typedef vector< boost::shared_ptr<ExpressionTree> > Constraints;
+    typedef vector< boost::shared_ptr<ExpressionProgram> > ConstraintPrograms;
 
 public:
     /**
@@ -79,9 +87,18 @@ public:
 		 const DmpObjectInfo& dmpObjectInfo,
 		 const vector<ForceNamesOneObject>& forcesNames);
 
-    void AddAttribute (const char* s)
+    /**
+     * Marks an identifier as an attribute name.
+     * @param s attribute name
+     * @param loaded true if the attribute is stored in the elements
+     *        for at least one element type
+     */
+    void AddAttribute (const char* s, bool loaded)
     {
-	m_attributes.insert (s);
+	const char* id = CreateIdentifier (s);
+	m_attributes.insert (id);
+	if (loaded)
+	    m_loadedAttributes.insert (id);
     }
 
     void CloseParenthesis ()
@@ -91,7 +108,9 @@ public:
     /**
      * Stores a string from the lexer for later use in the parser
      * @param id string from the lexer
-     * @return a string pointer which is stored in ParsingData object
+     * @return a string pointer which is stored in ParsingData object.
+     *         The same pointer is returned for strings that differ only
+     *         in case.
      */
     const char* CreateIdentifier(const char* id);
 
@@ -243,9 +262,36 @@ public:
     {
 	return m_vertices;
     }
-    bool IsAttribute (const char* s)
+    /**
+     * @param id identifier returned by CreateIdentifier
+     */
+    bool IsAttribute (const char* id) const
+    {
+	return m_attributes.find (id) != m_attributes.end ();
+    }
+    /**
+     * Attributes that are not loaded are skipped by the parser, no
+     * values are stored for them.
+     * @param id identifier returned by CreateIdentifier
+     */
+    bool IsAttributeLoaded (const char* id) const
+    {
+	return m_loadedAttributes.find (id) != m_loadedAttributes.end ();
+    }
+    /**
+     * User defined attributes that are loaded, in addition to the
+     * attributes foam uses (@see AttributesInfoElements). By default
+     * user defined attributes are not loaded.
+     */
+    void SetLoadAttributes (const vector<string>& names);
+    const vector<string>& GetLoadAttributes () const
+    {
+	return m_loadAttributeNames;
+    }
+    bool IsLoadAttribute (const char* name)
     {
-	return m_attributes.find (s) != m_attributes.end ();
+	return m_loadAttributes.find (CreateIdentifier (name)) !=
+	    m_loadAttributes.end ();
     }
     bool IsSpaceSignificant () const
     {
@@ -257,12 +303,14 @@ public:
     }
     void AddMethodOrQuantity (const char* s)
     {
-	m_methodOrQuantity.insert (s);
+	m_methodOrQuantity.insert (CreateIdentifier (s));
     }
-    bool IsMethodOrQuantity (const char* s)
+    /**
+     * @param id identifier returned by CreateIdentifier
+     */
+    bool IsMethodOrQuantity (const char* id) const
     {
-	bool result = m_methodOrQuantity.find (s) != m_methodOrQuantity.end ();
-	return result;
+	return m_methodOrQuantity.find (id) != m_methodOrQuantity.end ();
     }
     void OpenParenthesis ()
     {
@@ -310,6 +358,12 @@ public:
     {
 	return m_constraints[i];
     }
+    /**
+     * Gets a constraint compiled to an ExpressionProgram. The constraint
+     * is compiled the first time it is used, so variables used by the
+     * constraint need to be set before.
+     */
+    const ExpressionProgram& GetConstraintProgram (size_t i);
 
     bool OriginalUsed () const
     {
@@ -325,6 +379,28 @@ public:
 	return m_forceNames;
     }
 
+    /**
+     * While a piece of an element section is parsed in parallel
+     * SetVertex, SetEdge, SetFace and Foam::SetBody record their
+     * arguments in records instead of storing elements
+     * (@see SectionParser).
+     * @param records where arguments are recorded or 0 to store elements
+     */
+    void SetSectionRecords (SectionRecords* records)
+    {
+	m_sectionRecords = records;
+    }
+    SectionRecords* GetSectionRecords () const
+    {
+	return m_sectionRecords;
+    }
+    /**
+     * Copies what is needed to parse an element section from the
+     * ParsingData that parsed the header: the file name, variables,
+     * arrays and attribute, method and quantity names.
+     */
+    void CopyHeader (const ParsingData& header);
+
     /**
      * Gets the T1s stored in the DMP between this step and the
      * previous one. Returns false if the arrayName and countNames
@@ -358,6 +434,12 @@ public:
 
 public:
     string ToString () const;
+    /**
+     * @return bytes used by the variables, arrays and the lists of
+     *         elements. The elements themselves are not included.
+     */
+    size_t GetMemorySize () const;
+    friend class FoamSnapshot;
 
 private:
     /**
@@ -411,9 +493,13 @@ private:
      * Identifiers
      */
     Identifiers m_identifiers;
-    set<string, LessThanNoCase> m_attributes;
-    set<string, LessThanNoCase> m_methodOrQuantity;
+    IdentifierSet m_attributes;
+    IdentifierSet m_loadedAttributes;
+    IdentifierSet m_loadAttributes;
+    vector<string> m_loadAttributeNames;
+    IdentifierSet m_methodOrQuantity;
     Constraints m_constraints;
+    ConstraintPrograms m_constraintPrograms;
     bool m_spaceSignificant;
     size_t m_parenthesisCount;
     bool m_newLineSignificant;
@@ -421,6 +507,7 @@ private:
     DmpObjectInfo m_dmpObjectInfo;
     vector<ForceNamesOneObject> m_forceNames;
     bool m_keywordsIgnored;
+    SectionRecords* m_sectionRecords;
 
 private:
     static const char* IMPLEMENTED_METHODS[];
@@ -7,17 +7,96 @@
 #include "SystemDifferences.h"
 #include "ParsingDriver.h"
 #include "Debug.h"
+#include "DmpDecompressor.h"
+#include "SectionParser.h"
+#include "Comparisons.h"
+
+
+// Private Classes
+// ======================================================================
+
+/**
+ * Case insensitive perfect hash for a table of keywords. Each keyword
+ * gets its own slot in a table, so looking up a string takes a hash
+ * computation and at most one string comparison. The seed that
+ * avoids collisions is searched for when the table is built.
+ */
+class KeywordHash
+{
+public:
+    KeywordHash (const char* keywords[], size_t size) :
+	m_keywords (keywords),
+	m_table (TABLE_SIZE)
+    {
+	RuntimeAssert (size < numeric_limits<unsigned char>::max (),
+		       "Too many keywords: ", size);
+	for (m_seed = 0; m_seed < MAX_SEED; ++m_seed)
+	    if (fill (size))
+		return;
+	ThrowException ("No perfect hash for keywords, increase TABLE_SIZE");
+    }
+    /**
+     * @return the index of the keyword or -1 if s is not a keyword.
+     */
+    int Find (const char* s) const
+    {
+	unsigned char i = m_table[getSlot (s)];
+	if (i != 0 && strcasecmp (m_keywords[i - 1], s) == 0)
+	    return i - 1;
+	else
+	    return -1;
+    }
+
+private:
+    size_t getSlot (const char* s) const
+    {
+	unsigned int h = (HashNoCase () (s) ^ m_seed) * 2654435761u;
+	return (h >> 16) & (TABLE_SIZE - 1);
+    }
+    bool fill (size_t size)
+    {
+	fill_n (m_table.begin (), m_table.size (), 0);
+	for (size_t i = 0; i < size; ++i)
+	{
+	    unsigned char& slot = m_table[getSlot (m_keywords[i])];
+	    if (slot != 0)
+		return false;
+	    slot = i + 1;
+	}
+	return true;
+    }
+
+private:
+    /**
+     * Power of 2, large enough that a seed without collisions is
+     * found quickly.
+     */
+    static const size_t TABLE_SIZE = 4096;
+    static const unsigned int MAX_SEED = 1000;
+    const char** m_keywords;
+    /**
+     * Keyword index + 1, 0 for an empty slot
+     */
+    vector<unsigned char> m_table;
+    unsigned int m_seed;
+};
 
 
 ParsingDriver::ParsingDriver ()
   : m_debugScanning (false), 
     m_scanner (0),
-    m_debugParsing (false)
+    m_debugParsing (false),
+    m_memoryMapped (true),
+    m_parallelSections (true),
+    m_startToken (0),
+    m_mappedBuffer (0),
+    m_mappedSize (0)
 {
 }
 
 ParsingDriver::~ParsingDriver ()
 {
+    unmapFile ();
 }
 
 void ParsingDriver::PrintError (
@@ -28,14 +107,196 @@ void ParsingDriver::PrintError (
 
 long ParsingDriver::ReadInteger (char* str, int base)
 {
+    long i;
+    if (base == 10 && readDecimalFast (str, &i))
+	return i;
     char *tail = str;
     errno = 0;
-    long i = strtol (str, &tail, base);
+    i = strtol (str, &tail, base);
     if (errno)
 	ThrowException (string() + "Scanner: long overflow " + str);
     return i;
 }
 
+double ParsingDriver::ReadReal (char* str)
+{
+    double fast;
+    bool isFast = readRealFast (str, &fast);
+#ifdef QT_NO_DEBUG
+    if (isFast)
+	return fast;
+#endif
+    char *tail = str;
+    errno = 0;
+    double d = strtod (str, &tail);
+    // report error only for overflow, not for underflow
+    if (errno && (d == HUGE_VAL || d == -HUGE_VAL))
+	ThrowException (string("Scanner: overflow ") + str);
+    // debug builds validate the fast conversion against strtod
+    RuntimeAssert (! isFast || memcmp (&fast, &d, sizeof (d)) == 0,
+		   "Scanner: fast conversion differs from strtod for", str);
+    return d;
+}
+
+bool ParsingDriver::readDecimalFast (const char* str, long* value)
+{
+    const char* s = str;
+    bool negative = (*s == '-');
+    if (*s == '-' || *s == '+')
+	++s;
+    const char* begin = s;
+    long i = 0;
+    for (; *s != 0; ++s)
+    {
+	// up to digits10 digits cannot overflow
+	if (s - begin == numeric_limits<long>::digits10)
+	    return false;
+	i = i * 10 + (*s - '0');
+    }
+    *value = negative ? -i : i;
+    return true;
+}
+
+bool ParsingDriver::readRealFast (const char* str, double* value)
+{
+#if defined (__FLT_EVAL_METHOD__) && __FLT_EVAL_METHOD__ != 0
+    // extended precision intermediate results may round differently
+    (void)str;
+    (void)value;
+    return false;
+#else
+    // Doubles represent exactly integers with up to 15 digits and
+    // powers of 10 up to 10^22. A single multiplication or division of
+    // two exact values is correctly rounded, so it gives the same
+    // result as strtod (Clinger's fast path). Surface Evolver
+    // writes reals with 15 significant digits.
+    const int MAX_DIGITS = 15;
+    const int MAX_EXPONENT = 22;
+    static const double POWERS_OF_10[MAX_EXPONENT + 1] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    const char* s = str;
+    bool negative = (*s == '-');
+    if (*s == '-' || *s == '+')
+	++s;
+    double mantissa = 0;
+    int digits = 0;
+    // trailing zeros are added to the mantissa only if followed by
+    // a non zero digit
+    int zeros = 0;
+    int exponent = 0;
+    bool fraction = false;
+    for (; *s != 0 && *s != 'e' && *s != 'E'; ++s)
+    {
+	if (*s == '.')
+	{
+	    fraction = true;
+	    continue;
+	}
+	if (fraction)
+	    --exponent;
+	if (*s == '0')
+	{
+	    if (digits > 0)
+		++zeros;
+	    continue;
+	}
+	digits += zeros + 1;
+	if (digits > MAX_DIGITS)
+	    return false;
+	for (; zeros > 0; --zeros)
+	    mantissa *= 10;
+	mantissa = mantissa * 10 + (*s - '0');
+    }
+    exponent += zeros;
+    if (*s != 0)
+    {
+	++s;
+	bool negativeExponent = (*s == '-');
+	if (*s == '-' || *s == '+')
+	    ++s;
+	int e = 0;
+	for (; *s != 0; ++s)
+	{
+	    e = e * 10 + (*s - '0');
+	    if (e > 1000)
+		return false;
+	}
+	exponent += negativeExponent ? -e : e;
+    }
+    if (mantissa == 0)
+	exponent = 0;
+    if (exponent < -MAX_EXPONENT || exponent > MAX_EXPONENT)
+	return false;
+    if (exponent >= 0)
+	mantissa *= POWERS_OF_10[exponent];
+    else
+	mantissa /= POWERS_OF_10[-exponent];
+    *value = negative ? -mantissa : mantissa;
+    return true;
+#endif
+}
+
+size_t ParsingDriver::CheckRealConversion (size_t* fast)
+{
+    const char* limits[] = {
+	"0", "-0", "-0.0", "-0e5", ".5", "5.", "-.5", "+5.", "0.5e-0",
+	// 15 and 16 significant digits
+	"123456789012345", "1234567890123456", "999999999999999",
+	"9999999999999999", "9007199254740993", "0.123456789012345",
+	"0.1234567890123456", "1.23456789012345e-5", "1.234567890123456e-5",
+	"100000000000000000000", "0.000000000000000000000001",
+	// exponents around 22
+	"1e22", "1e23", "1e-22", "1e-23", "-1e22", "-1e23",
+	"1.5e0022", "1.5e-0022", "123456789012345e22", "123456789012345e23",
+	"123456789012345e-22", "123456789012345e-23",
+	"1234567.89012345e15", "0.00000123456789012345e-16",
+	"1.79769313486232e+308", "2.22507385850720e-308",
+	"4.94065645841247e-324"
+    };
+    size_t checked = 0;
+    *fast = 0;
+    for (size_t i = 0; i < sizeof (limits) / sizeof (limits[0]); ++i)
+    {
+	checkRealConversion (limits[i], fast);
+	++checked;
+    }
+    // Surface Evolver writes reals with 15 significant digits, 16
+    // digits exercise the fallback to strtod
+    unsigned int random = 1;
+    char str[64];
+    for (int exponent = -30; exponent <= 30; ++exponent)
+	for (size_t i = 0; i < 1000; ++i)
+	{
+	    random = random * 1103515245u + 12345u;
+	    double value = (1 + (random >> 8) / double (1 << 24)) * 
+		pow (10.0, exponent);
+	    if (random & 1)
+		value = -value;
+	    const char* formats[] = {"%.14e", "%.15e", "%.15g", "%.16g"};
+	    for (size_t j = 0; j < sizeof (formats) / sizeof (formats[0]); ++j)
+	    {
+		sprintf (str, formats[j], value);
+		checkRealConversion (str, fast);
+		++checked;
+	    }
+	}
+    return checked;
+}
+
+void ParsingDriver::checkRealConversion (const char* str, size_t* fast)
+{
+    double value;
+    if (! readRealFast (str, &value))
+	return;
+    ++(*fast);
+    double d = strtod (str, 0);
+    if (memcmp (&value, &d, sizeof (d)) != 0)
+	ThrowException ("Scanner: fast conversion differs from strtod for ",
+			str);
+}
+
  int const ParsingDriver::FIRST_TOKEN = EvolverData::parser::token::PARAMETER;
 
 const char* ParsingDriver::KEYWORD_TABLE[] = {
@@ -144,15 +405,14 @@ const char* ParsingDriver::KEYWORD_TABLE[] = {
     "VALUE"
 };
 
-int ParsingDriver::GetKeywordId (char* keyword)
+// KEYWORD_TABLE is initialized statically so it is ready before this
+const KeywordHash ParsingDriver::KEYWORD_HASH (
+    KEYWORD_TABLE, sizeof (KEYWORD_TABLE) / sizeof (KEYWORD_TABLE[0]));
+
+int ParsingDriver::GetKeywordId (const char* keyword)
 {
-    for (size_t i = 0; 
-         i < sizeof (KEYWORD_TABLE) / sizeof (KEYWORD_TABLE[0]); ++i)
-    {
-	if (strcasecmp (KEYWORD_TABLE[i], keyword) == 0)
-	    return i + FIRST_TOKEN;
-    }
-    return 0;
+    int i = KEYWORD_HASH.Find (keyword);
+    return i == -1 ? 0 : i + FIRST_TOKEN;
 }
 
 const char* ParsingDriver::GetKeywordString (int id)
@@ -164,10 +424,140 @@ const char* ParsingDriver::GetKeywordString (int id)
 int ParsingDriver::Parse (const string& f, Foam* data)
 {
     m_file = f;
+    size_t fileSize;
+    if (m_parallelSections && m_memoryMapped &&
+	DmpDecompressor::GetFormat (m_file) == DmpDecompressor::NONE &&
+	mapFile (&fileSize))
+    {
+	bool split;
+	int result = 0;
+	try
+	{
+	    SectionParser sectionParser (m_mappedBuffer, fileSize);
+	    split = sectionParser.IsSplit ();
+	    if (split)
+		result = sectionParser.Parse (data);
+	}
+	catch (...)
+	{
+	    unmapFile ();
+	    throw;
+	}
+	unmapFile ();
+	if (split)
+	    return result;
+    }
     ScanBegin ();
-    EvolverData::parser parser (data, m_scanner);
-    parser.set_debug_level (m_debugParsing);
-    int result = parser.parse ();
+    int result;
+    try
+    {
+	EvolverData::parser parser (data, m_scanner);
+	parser.set_debug_level (m_debugParsing);
+	result = parser.parse ();
+    }
+    catch (...)
+    {
+	ScanEnd ();
+	throw;
+    }
     ScanEnd ();
     return result;
 }
+
+bool ParsingDriver::mapFile (size_t* fileSize)
+{
+#ifdef _MSC_VER
+    (void)fileSize;
+    return false;
+#else //_MSC_VER
+    int fd = open (m_file.c_str (), O_RDONLY);
+    if (fd == -1)
+	return false;
+    struct stat st;
+    if (fstat (fd, &st) == -1 || ! S_ISREG (st.st_mode) || st.st_size == 0)
+    {
+	close (fd);
+	return false;
+    }
+    *fileSize = st.st_size;
+    // Reserve a zeroed region at least two bytes larger than the file
+    // and map the file over its beginning. The bytes past the end of
+    // the file are 0 either way. The mapping is private and writable
+    // because the scanner temporarily writes into its buffer.
+    size_t pageSize = sysconf (_SC_PAGESIZE);
+    size_t mappedSize = 
+	(*fileSize + 2 + pageSize - 1) / pageSize * pageSize;
+    void* region = mmap (0, mappedSize, PROT_READ | PROT_WRITE, 
+			 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (region == MAP_FAILED)
+    {
+	close (fd);
+	return false;
+    }
+    if (mmap (region, *fileSize, PROT_READ | PROT_WRITE, 
+	      MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED)
+    {
+	munmap (region, mappedSize);
+	close (fd);
+	return false;
+    }
+    close (fd);
+    madvise (region, *fileSize, MADV_SEQUENTIAL);
+    m_mappedBuffer = static_cast<char*> (region);
+    m_mappedSize = mappedSize;
+    return true;
+#endif //_MSC_VER
+}
+
+void ParsingDriver::unmapFile ()
+{
+#ifndef _MSC_VER
+    if (m_mappedBuffer != 0)
+    {
+	munmap (m_mappedBuffer, m_mappedSize);
+	m_mappedBuffer = 0;
+	m_mappedSize = 0;
+    }
+#endif //_MSC_VER
+}
+
+FILE* ParsingDriver::openDecompressed ()
+{
+    DmpDecompressor::Format format = DmpDecompressor::GetFormat (m_file);
+    if (format == DmpDecompressor::NONE)
+	return 0;
+#ifdef _MSC_VER
+    ThrowException ("Scanner: compressed DMP files are not supported:", 
+		    m_file);
+    return 0;
+#else //_MSC_VER
+    int fd[2];
+    if (pipe (fd) == -1)
+	ThrowException ("Scanner: cannot create pipe for", m_file);
+#ifdef F_SETPIPE_SZ
+    // a larger pipe lets the decompressor run further ahead of the scanner
+    fcntl (fd[1], F_SETPIPE_SZ, 1024 * 1024);
+#endif
+    FILE* dataFile = fdopen (fd[0], "r");
+    if (! dataFile)
+    {
+	close (fd[0]);
+	close (fd[1]);
+	ThrowException ("Scanner: cannot open pipe for", m_file);
+    }
+    m_decompressor.reset (new DmpDecompressor (m_file, format, fd[1]));
+    m_decompressor->start ();
+    return dataFile;
+#endif //_MSC_VER
+}
+
+void ParsingDriver::closeDecompressed ()
+{
+    if (! m_decompressor)
+	return;
+    m_decompressor->wait ();
+    string error = m_decompressor->GetError ();
+    m_decompressor.reset ();
+    if (! error.empty ())
+	ThrowException ("Scanner:", m_file, error);
+}
@@ -9,6 +9,8 @@
 
 #include "EvolverData_yacc.h"
 
+class DmpDecompressor;
+class KeywordHash;
 class Foam;
 
 /**
@@ -41,6 +43,27 @@ public:
     {
         m_debugScanning = debugScanning;
     }
+    bool IsDebugScanning () const
+    {
+	return m_debugScanning;
+    }
+    /**
+     * Scan the data file from a memory mapping of the whole file
+     * rather than through stdio. This is the default. If the file
+     * cannot be mapped stdio is used.
+     */
+    void SetMemoryMapped (bool memoryMapped)
+    {
+	m_memoryMapped = memoryMapped;
+    }
+    /**
+     * Parse the element sections of a memory mapped data file in
+     * parallel (@see SectionParser). This is the default.
+     */
+    void SetParallelSections (bool parallelSections)
+    {
+	m_parallelSections = parallelSections;
+    }
 
     /**
      * Parses a data file and stores the parsed data in an Foam object
@@ -49,6 +72,37 @@ public:
      * @return 0 for success, <> than 0 otherwise
      */
     int Parse (const string& f, Foam* data);
+    /**
+     * Parses part of a data file stored in memory
+     * @param begin beginning of the text
+     * @param end end of the text
+     * @param line line number of the beginning of the text
+     * @param startToken first token read by the parser. It tells the
+     *        parser which part of the data file the text contains.
+     * @param data object where data is to be stored
+     * @return 0 for success, <> than 0 otherwise
+     */
+    int ParseText (const char* begin, const char* end,
+		   size_t line, int startToken, Foam* data);
+    /**
+     * Called by the scanner before reading a token.
+     * @return the token set by ParseText the first time it is
+     *         called, 0 afterwards.
+     */
+    int TakeStartToken ()
+    {
+	int startToken = m_startToken;
+	m_startToken = 0;
+	return startToken;
+    }
+    /**
+     * Runs only the scanner over a data file, for benchmarking. The
+     * scanner is not driven by the parser so it may not produce the
+     * same tokens.
+     * @param f the file to be scanned
+     * @return the number of tokens read
+     */
+    size_t Scan (const string& f);
     /**
      * Turns on or off debugging for parsing
      * @param debugParsing true if you want debugging, false otherwise
@@ -57,11 +111,15 @@ public:
     {
         m_debugParsing = debugParsing;
     }
+    bool IsDebugParsing () const
+    {
+	return m_debugParsing;
+    }
     /**
      * Sets the file to be parsed
      * @param file the file to be parsed
      */
-    void SetFile (string& file)
+    void SetFile (const string& file)
     {
         m_file = file;
     }
@@ -73,6 +131,10 @@ public:
     {
         return m_file;
     }
+    const string& GetFile () const
+    {
+        return m_file;
+    }
     /**
      * Called by the parser in case of errors
      * @param l line and column where error occurend in the parsed file
@@ -87,18 +149,68 @@ public:
      * @return the converted integer
      */
     long ReadInteger (char* str, int base);
+    /**
+     * Converts a string matched by the real number rule of the scanner
+     * to a double. The result is the same as the one returned by
+     * strtod. Throws an exception on overflow.
+     * @param str string to be converted to a double
+     * @return the converted double
+     */
+    double ReadReal (char* str);
+    /**
+     * Checks that the conversion of reals without strtod gives the same
+     * bits as strtod, for values at the limits of that conversion and
+     * for a fixed sequence of values written as Surface Evolver writes
+     * them. Runs in release builds, which do not call strtod for
+     * those values. Throws an exception for the first difference.
+     * @param fast stores how many values were converted without strtod
+     * @return how many values were checked
+     */
+    static size_t CheckRealConversion (size_t* fast);
     /**
      * Gets the ID associated with a keyword
      * @param keyword keyword name
-     * @return keyword ID
+     * @return keyword ID or 0 if the string is not a keyword
      */
-    static int GetKeywordId (char* keyword);
+    static int GetKeywordId (const char* keyword);
     /**
      * Gets the name associated with a keyword ID
      * @param id keyword ID
      * @return keyword name
      */
     static const char* GetKeywordString (int id);
+
+private:
+    /**
+     * Maps m_file in memory followed by two 0 bytes, as required by
+     * the scanner for in-memory buffers.
+     * @param fileSize size of the file
+     * @return true if the file was mapped, false otherwise
+     */
+    bool mapFile (size_t* fileSize);
+    void unmapFile ();
+    /**
+     * Converts a decimal integer without calling strtol.
+     * @return false if the integer might overflow
+     */
+    static bool readDecimalFast (const char* str, long* value);
+    /**
+     * Converts a real without calling strtod.
+     * @return false if the result could differ from strtod
+     */
+    static bool readRealFast (const char* str, double* value);
+    static void checkRealConversion (const char* str, size_t* fast);
+    /**
+     * Starts decompressing m_file into a pipe if the file is compressed
+     * (@see DmpDecompressor::GetFormat)
+     * @return the read end of the pipe or 0 if the file is not compressed
+     */
+    FILE* openDecompressed ();
+    /**
+     * Waits for the decompressor to finish and throws if it failed.
+     */
+    void closeDecompressed ();
+
 private:
     /**
      * Do we want debugging information from the scanner?
@@ -116,6 +228,22 @@ private:
      * Parsed file
      */
     string m_file;
+    bool m_memoryMapped;
+    bool m_parallelSections;
+    /**
+     * Token returned by the scanner before the text
+     */
+    int m_startToken;
+    /**
+     * Memory mapping of the parsed file or 0 if the file is read
+     * through stdio
+     */
+    char* m_mappedBuffer;
+    size_t m_mappedSize;
+    /**
+     * Decompresses the parsed file or 0 if the file is not compressed
+     */
+    boost::shared_ptr<DmpDecompressor> m_decompressor;
 
 private:
     /**
@@ -125,6 +253,10 @@ private:
      *    - add the correct rule in EvolverData.y
      */
     static const char* KEYWORD_TABLE[];
+    /**
+     * Finds keywords in KEYWORD_TABLE
+     */
+    static const KeywordHash KEYWORD_HASH;
     /**
      * The ID of the first token
      */
@@ -19,7 +19,8 @@
 
 ProcessBodyTorus::ProcessBodyTorus (const Foam& foam, 
 				    const boost::shared_ptr<Body>& body) : 
-    m_foam (foam), m_body (body), m_traversed (body->GetFaceCount (), false)
+    m_foam (foam), m_body (body), m_traversed (body->GetFaceCount (), false),
+    m_translation (body->GetFaceCount (), Vector3int16Zero)
 {}
 
 void ProcessBodyTorus::Initialize ()
@@ -30,26 +31,64 @@ void ProcessBodyTorus::Initialize ()
 }
 
 void ProcessBodyTorus::Unwrap (
-    VertexSet* vertexSet, EdgeSet* edgeSet, FaceSet* faceSet)
+    VertexHashSet* vertexSet, EdgeHashSet* edgeSet, FaceHashSet* faceSet)
 {
     Initialize ();
     while (Step (vertexSet, edgeSet, faceSet))
 	;
 }
 
+void ProcessBodyTorus::CalculateTranslations ()
+{
+    Initialize ();
+    AdjacentOrientedFace aof, nextAof;
+    while (pop (&aof, &nextAof))
+    {
+	size_t i = aof.GetOrientedFace ()->GetAdjacentBody ().
+	    GetOrientedFaceIndex ();
+	size_t next = nextAof.GetOrientedFace ()->GetAdjacentBody ().
+	    GetOrientedFaceIndex ();
+	m_translation[next] = getTranslation (aof, nextAof, m_translation[i]);
+	if (m_translation[next] != Vector3int16Zero)
+	    m_translated.push_back (next);
+    }
+}
+
+void ProcessBodyTorus::LinkDuplicates (
+    VertexHashSet* vertexSet, EdgeHashSet* edgeSet, FaceHashSet* faceSet)
+{
+    BOOST_FOREACH (size_t i, m_translated)
+    {
+	boost::shared_ptr<OrientedFace> of = m_body->GetOrientedFacePtr (i);
+	of->SetFace (
+	    of->GetFace ()->GetDuplicate (
+		m_foam.GetTorusDomain (), m_translation[i],
+		vertexSet, edgeSet, faceSet));
+    }
+}
+
+G3D::Vector3int16 ProcessBodyTorus::getTranslation (
+    const AdjacentOrientedFace& aof, const AdjacentOrientedFace& nextAof,
+    const G3D::Vector3int16& translation) const
+{
+    const OOBox& periods = m_foam.GetTorusDomain ();
+    G3D::Vector3 end = aof.GetOrientedEdge ().GetEndVector ();
+    if (translation != Vector3int16Zero)
+	end = periods.TorusTranslate (end, translation);
+    return periods.GetTranslation (
+	nextAof.GetOrientedEdge ().GetBeginVector (), end);
+}
+
 bool ProcessBodyTorus::Step (
-    VertexSet* vertexSet, EdgeSet* edgeSet, FaceSet* faceSet)
+    VertexHashSet* vertexSet, EdgeHashSet* edgeSet, FaceHashSet* faceSet)
 {
     using G3D::Vector3int16;
     AdjacentOrientedFace aof, nextAof;
     if (! pop (&aof, &nextAof))
 	return false;
-    const OrientedEdge& oe = aof.GetOrientedEdge ();
-    const OrientedEdge& nextOe = nextAof.GetOrientedEdge ();
-    const OOBox& periods = m_foam.GetTorusDomain ();
-
+    // the face of aof is already linked to its duplicate
     G3D::Vector3int16 translation = 
-	periods.GetTranslation (nextOe.GetBeginVector (), oe.GetEndVector ());
+	getTranslation (aof, nextAof, Vector3int16Zero);
     if (translation != Vector3int16Zero)
     {
 	boost::shared_ptr<Face>  translatedNextFace = 
@@ -10,22 +10,54 @@
 #define __PROCESS_BODY_TORUS_H__
 
 #include "AdjacentOrientedFace.h"
+#include "ElementHashSet.h"
 class Body;
 class Foam;
 class OrientedFace;
 
 /**
  * @brief Processing done to "unwrap" bodies in torus model.
+ *
+ * Unwrap (or Initialize and Step) links the faces of the body to
+ * their duplicates as it traverses them. The bodies of a foam can
+ * also be unwrapped in two phases: CalculateTranslations only reads
+ * the faces so it can run for all bodies in parallel, then
+ * LinkDuplicates, called for the bodies in order, creates and links
+ * the same duplicates Unwrap would.
  */
 class ProcessBodyTorus
 {
 public:
     ProcessBodyTorus (const Foam& foam, const boost::shared_ptr<Body>& body);
     void Initialize ();
-    bool Step (VertexSet* vertexSet, EdgeSet* edgeSet, FaceSet* faceSet);
-    void Unwrap (VertexSet* vertexSet, EdgeSet* edgeSet, FaceSet* faceSet);
+    bool Step (VertexHashSet* vertexSet, EdgeHashSet* edgeSet,
+	FaceHashSet* faceSet);
+    void Unwrap (VertexHashSet* vertexSet, EdgeHashSet* edgeSet,
+	FaceHashSet* faceSet);
+    /**
+     * Traverses the body as Unwrap does and stores the translation of
+     * each face from its position in the unwrapped body, without
+     * changing any face.
+     */
+    void CalculateTranslations ();
+    /**
+     * Links the faces translated by CalculateTranslations to their
+     * duplicates, in traversal order.
+     */
+    void LinkDuplicates (VertexHashSet* vertexSet, EdgeHashSet* edgeSet,
+			 FaceHashSet* faceSet);
 
 private:
+    /**
+     * @param translation of the face of aof from the face the body
+     *        is linked to
+     * @return the translation of the face of nextAof
+     */
+    G3D::Vector3int16 getTranslation (
+	const AdjacentOrientedFace& aof, 
+	const AdjacentOrientedFace& nextAof, 
+	const G3D::Vector3int16& translation) const;
+
     void push (boost::shared_ptr<OrientedFace>  of);
     bool pop (AdjacentOrientedFace* orientedFaceIndex,
 	      AdjacentOrientedFace* nextOrientedFaceIndex);
@@ -44,6 +76,15 @@ private:
      */
     queue<AdjacentOrientedFace> m_queue;
     vector<bool> m_traversed;
+    /**
+     * Translation of each oriented face (@see CalculateTranslations)
+     */
+    vector<G3D::Vector3int16> m_translation;
+    /**
+     * Indexes of the oriented faces with a translation, in traversal
+     * order.
+     */
+    vector<size_t> m_translated;
 };
 
 
@@ -6,6 +6,7 @@
  */
 
 #include "Debug.h"
+#include "ElementArena.h"
 #include "OOBox.h"
 #include "QuadraticEdge.h"
 #include "Vertex.h"
@@ -34,12 +35,12 @@ QuadraticEdge::QuadraticEdge (const QuadraticEdge& quadraticEdge) :
 
 boost::shared_ptr<Edge> QuadraticEdge::Clone () const
 {
-    return boost::shared_ptr<Edge> (new QuadraticEdge(*this));
+    return MakeElement<QuadraticEdge> (*this);
 }
 
 boost::shared_ptr<Edge> QuadraticEdge::createDuplicate (
     const OOBox& originalDomain,
-    const G3D::Vector3& newBegin, VertexSet* vertexSet) const
+    const G3D::Vector3& newBegin, VertexHashSet* vertexSet) const
 {
     G3D::Vector3int16 translation = originalDomain.GetTranslation (
 	GetBeginVector (), newBegin);
@@ -22,6 +22,7 @@ public:
 	const G3D::Vector3int16& endLocation, 
 	size_t id,
 	ElementStatus::Enum duplicateStatus = ElementStatus::ORIGINAL);
+    QuadraticEdge (const QuadraticEdge& quadraticEdge);
     boost::shared_ptr<Vertex> GetMiddlePtr () const
     {
 	return m_middle;
@@ -36,10 +37,9 @@ public:
     virtual void SetEnd(boost::shared_ptr<Vertex> end);
 
 protected:
-    QuadraticEdge (const QuadraticEdge& quadraticEdge);
     virtual boost::shared_ptr<Edge> createDuplicate (
 	const OOBox& periods,
-	const G3D::Vector3& newBegin, VertexSet* vertexSet) const;
+	const G3D::Vector3& newBegin, VertexHashSet* vertexSet) const;
 
 private:
     /**
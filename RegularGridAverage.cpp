@@ -9,6 +9,7 @@
 
 #include "Debug.h"
 #include "Foam.h"
+#include "MemoryUsage.h"
 #include "RegularGridAverage.h"
 #include "Settings.h"
 #include "Simulation.h"
@@ -61,6 +62,12 @@ void RegularGridAverage::AverageRelease ()
     m_average = 0;
 }
 
+void RegularGridAverage::GetMemoryUsage (MemoryUsage* usage) const
+{
+    usage->AddRegularGrid (m_sum);
+    usage->AddRegularGrid (m_average);
+}
+
 
 void RegularGridAverage::AverageRotateAndDisplay (
     StatisticsType::Enum displayType, G3D::Vector2 rotationCenter, 
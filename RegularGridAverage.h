@@ -39,6 +39,7 @@ public:
 	float angleDegrees = 0) const;
     virtual void AverageRelease ();
     void ComputeAverage ();
+    virtual void GetMemoryUsage (MemoryUsage* usage) const;
     const vtkImageData& GetAverage () const
     {
         return *m_average;
@@ -0,0 +1,351 @@
+/**
+ * @file   SectionParser.cpp
+ * @author Dan R. Lipsa
+ *
+ * Definitions for the SectionRecords and SectionParser classes.
+ */
+
+#include "Debug.h"
+#include "Foam.h"
+#include "NameSemanticValue.h"
+#include "ParsingData.h"
+#include "SectionParser.h"
+
+
+// Private Functions and constants
+// ======================================================================
+
+namespace
+{
+typedef EvolverData::parser::token token;
+
+/**
+ * Smaller files are parsed serially
+ */
+const size_t MIN_PARALLEL_SIZE = 4 * 1024 * 1024;
+const size_t MIN_PIECE_SIZE = 512 * 1024;
+/**
+ * More pieces than threads balance the work when pieces take
+ * different times to parse
+ */
+const size_t PIECES_PER_THREAD = 4;
+
+/**
+ * @return the keyword ID of the identifier at the beginning of a
+ *         line or 0 if the line does not start with a keyword
+ */
+int lineKeyword (const char* line, const char* end)
+{
+    const size_t MAX_KEYWORD = 32;
+    char keyword[MAX_KEYWORD];
+    size_t i = 0;
+    while (line < end && (isalnum (*line) || *line == '_'))
+    {
+	if (i == MAX_KEYWORD - 1)
+	    return 0;
+	keyword[i++] = *line++;
+    }
+    keyword[i] = 0;
+    return ParsingDriver::GetKeywordId (keyword);
+}
+
+/**
+ * @return true if the line before line ends with \, so it continues
+ *         on line
+ */
+bool isSpliced (const char* buffer, const char* line)
+{
+    const char* p = line - 1;
+    if (p > buffer && p[-1] == '\r')
+	--p;
+    return p > buffer && p[-1] == '\\';
+}
+
+/**
+ * @return true if the section that starts with keyword can follow
+ *         section
+ */
+bool isNextSection (int section, int keyword)
+{
+    switch (section)
+    {
+    case token::VERTICES:
+	return keyword == token::EDGES;
+    case token::EDGES:
+	return keyword == token::FACES;
+    case token::FACES:
+	return keyword == token::BODIES || keyword == token::READ;
+    case token::BODIES:
+	return keyword == token::READ;
+    default:
+	return false;
+    }
+}
+
+int startToken (int section)
+{
+    switch (section)
+    {
+    case token::VERTICES:
+	return token::VERTICES_START;
+    case token::EDGES:
+	return token::EDGES_START;
+    case token::FACES:
+	return token::FACES_START;
+    default:
+	return token::BODIES_START;
+    }
+}
+}
+
+
+// Members: SectionRecords
+// ======================================================================
+
+SectionRecords::~SectionRecords ()
+{
+    BOOST_FOREACH (VertexRecord& r, m_vertices)
+	NameSemanticValue::DeleteVector (r.m_attributes);
+    BOOST_FOREACH (EdgeRecord& r, m_edges)
+	NameSemanticValue::DeleteVector (r.m_attributes);
+    BOOST_FOREACH (FaceRecord& r, m_faces)
+	NameSemanticValue::DeleteVector (r.m_attributes);
+    BOOST_FOREACH (FaceRecord& r, m_bodies)
+	NameSemanticValue::DeleteVector (r.m_attributes);
+}
+
+vector<NameSemanticValue*>* SectionRecords::takeAttributes (
+    vector<NameSemanticValue*>& attributes)
+{
+    // the parser passes a null reference for elements without attributes
+    if (&attributes == 0)
+	return 0;
+    vector<NameSemanticValue*>* taken = new vector<NameSemanticValue*> ();
+    taken->swap (attributes);
+    return taken;
+}
+
+void SectionRecords::AddVertex (size_t i, double x, double y, double z,
+				vector<NameSemanticValue*>& attributes)
+{
+    VertexRecord r = {i, x, y, z, 0};
+    r.m_attributes = takeAttributes (attributes);
+    m_vertices.push_back (r);
+}
+
+void SectionRecords::AddEdge (
+    size_t i, size_t begin, size_t end, size_t middle,
+    const G3D::Vector3int16& endTranslation,
+    vector<NameSemanticValue*>& attributes)
+{
+    EdgeRecord r;
+    r.m_i = i;
+    r.m_begin = begin;
+    r.m_end = end;
+    r.m_middle = middle;
+    r.m_endTranslation = endTranslation;
+    r.m_attributes = takeAttributes (attributes);
+    m_edges.push_back (r);
+}
+
+void SectionRecords::AddFace (size_t i, vector<int>& edges,
+			      vector<NameSemanticValue*>& attributes)
+{
+    addFace (&m_faces, i, edges, attributes);
+}
+
+void SectionRecords::AddBody (size_t i, vector<int>& faces,
+			      vector<NameSemanticValue*>& attributes)
+{
+    addFace (&m_bodies, i, faces, attributes);
+}
+
+void SectionRecords::addFace (
+    vector<FaceRecord>* records, size_t i, vector<int>& elements,
+    vector<NameSemanticValue*>& attributes)
+{
+    records->push_back (FaceRecord ());
+    FaceRecord& r = records->back ();
+    r.m_i = i;
+    r.m_elements.swap (elements);
+    r.m_attributes = takeAttributes (attributes);
+}
+
+void SectionRecords::Apply (Foam* foam)
+{
+    ParsingData& parsingData = foam->GetParsingData ();
+    const AttributesInfoElements& infos = foam->GetAttributesInfoElements ();
+    BOOST_FOREACH (VertexRecord& r, m_vertices)
+    {
+	parsingData.SetVertex (r.m_i, r.m_x, r.m_y, r.m_z,
+			       *r.m_attributes, infos.GetInfoVertex ());
+	NameSemanticValue::DeleteVector (r.m_attributes);
+	r.m_attributes = 0;
+    }
+    BOOST_FOREACH (EdgeRecord& r, m_edges)
+    {
+	parsingData.SetEdge (r.m_i, r.m_begin, r.m_end, r.m_middle,
+			     r.m_endTranslation, *r.m_attributes,
+			     infos.GetInfoEdge (), foam->IsQuadratic ());
+	NameSemanticValue::DeleteVector (r.m_attributes);
+	r.m_attributes = 0;
+    }
+    BOOST_FOREACH (FaceRecord& r, m_faces)
+    {
+	parsingData.SetFace (r.m_i, r.m_elements, *r.m_attributes,
+			     infos.GetInfoFace ());
+	NameSemanticValue::DeleteVector (r.m_attributes);
+	r.m_attributes = 0;
+    }
+    BOOST_FOREACH (FaceRecord& r, m_bodies)
+    {
+	foam->SetBody (r.m_i, r.m_elements, *r.m_attributes,
+		       parsingData.OriginalUsed ());
+	NameSemanticValue::DeleteVector (r.m_attributes);
+	r.m_attributes = 0;
+    }
+}
+
+
+// Members: SectionParser
+// ======================================================================
+
+SectionParser::SectionParser (const char* buffer, size_t size) :
+    m_buffer (buffer),
+    m_headerEnd (0)
+{
+    // the calling thread parses pieces too
+    QThreadPool* pool = QThreadPool::globalInstance ();
+    int threads = min (
+	QThread::idealThreadCount (),
+	pool->maxThreadCount () - pool->activeThreadCount () + 1);
+    if (size < MIN_PARALLEL_SIZE || threads < 2)
+	return;
+    size_t pieceSize = max (
+	MIN_PIECE_SIZE, size / (threads * PIECES_PER_THREAD));
+    const char* end = buffer + size;
+    // keyword of the current section or 0 for the header
+    int section = 0;
+    const char* pieceBegin = 0;
+    size_t pieceLine = 0;
+    size_t line = 1;
+    const char* p = buffer;
+    for (; p < end; ++line)
+    {
+	const char* lineEnd = static_cast<const char*> (
+	    memchr (p, '\n', end - p));
+	lineEnd = (lineEnd == 0) ? end : lineEnd + 1;
+	const char* c = p;
+	while (c < lineEnd && (*c == ' ' || *c == '\t'))
+	    ++c;
+	if (c < lineEnd && isalpha (*c))
+	{
+	    int keyword = lineKeyword (c, lineEnd);
+	    if (section == 0)
+	    {
+		if (keyword == token::VERTICES)
+		    m_headerEnd = p;
+	    }
+	    else if (isNextSection (section, keyword))
+		addPiece (pieceBegin, p, pieceLine, startToken (section));
+	    else
+	    {
+		// unexpected content, the file is parsed serially
+		m_pieces.clear ();
+		return;
+	    }
+	    if (keyword == token::READ)
+		break;
+	    if (m_headerEnd != 0)
+	    {
+		section = keyword;
+		pieceBegin = lineEnd;
+		pieceLine = line + 1;
+	    }
+	}
+	else if (section != 0 && c < lineEnd && isdigit (*c) &&
+		 size_t (p - pieceBegin) >= pieceSize &&
+		 ! isSpliced (buffer, p))
+	{
+	    addPiece (pieceBegin, p, pieceLine, startToken (section));
+	    pieceBegin = p;
+	    pieceLine = line;
+	}
+	p = lineEnd;
+    }
+    if (section != token::FACES && section != token::BODIES)
+    {
+	// the file is incomplete, the serial parser reports the error
+	m_pieces.clear ();
+	return;
+    }
+    if (p == end)
+	addPiece (pieceBegin, end, pieceLine, startToken (section));
+}
+
+void SectionParser::addPiece (const char* begin, const char* end, 
+			      size_t line, int startToken)
+{
+    Piece piece;
+    piece.m_begin = begin;
+    piece.m_end = end;
+    piece.m_line = line;
+    piece.m_startToken = startToken;
+    piece.m_header = 0;
+    piece.m_dataProperties = &m_dataProperties;
+    piece.m_result = 0;
+    m_pieces.push_back (piece);
+}
+
+int SectionParser::Parse (Foam* foam)
+{
+    ParsingData& parsingData = foam->GetParsingData ();
+    int result = parsingData.ParseText (
+	m_buffer, m_headerEnd, 1, token::HEADER_START, foam);
+    if (result != 0)
+	return result;
+    BOOST_FOREACH (Piece& piece, m_pieces)
+	piece.m_header = &parsingData;
+    QtConcurrent::blockingMap (m_pieces, &Piece::Parse);
+    BOOST_FOREACH (Piece& piece, m_pieces)
+    {
+	if (! piece.m_error.empty ())
+	    ThrowException (piece.m_error);
+	if (piece.m_result != 0)
+	    return piece.m_result;
+    }
+    // pieces are in the order of the file, so vertices are stored
+    // before the edges that use them and so on.
+    BOOST_FOREACH (Piece& piece, m_pieces)
+    {
+	piece.m_records->Apply (foam);
+	piece.m_records.reset ();
+	piece.m_foam.reset ();
+    }
+    foam->Preprocess ();
+    return 0;
+}
+
+void SectionParser::Piece::Parse ()
+{
+    try
+    {
+	m_foam.reset (
+	    new Foam (m_header->OriginalUsed (), m_header->GetDmpObjectInfo (),
+		      m_header->GetForcesNames (), *m_dataProperties,
+		      Foam::OWN_DATA_PROPERTIES));
+	m_records.reset (new SectionRecords ());
+	ParsingData& parsingData = m_foam->GetParsingData ();
+	parsingData.CopyHeader (*m_header);
+	parsingData.SetSectionRecords (m_records.get ());
+	m_result = parsingData.ParseText (
+	    m_begin, m_end, m_line, m_startToken, m_foam.get ());
+	parsingData.SetSectionRecords (0);
+    }
+    // exceptions cannot leave a QtConcurrent thread
+    catch (const exception& e)
+    {
+	m_error = e.what ();
+	m_result = 1;
+    }
+}
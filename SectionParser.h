@@ -0,0 +1,163 @@
+/**
+ * @file SectionParser.h
+ * @author Dan R. Lipsa
+ * @brief Parses the element sections of a DMP file in parallel.
+ * @ingroup parser
+ */
+#ifndef __SECTION_PARSER_H__
+#define __SECTION_PARSER_H__
+
+#include "DataProperties.h"
+
+class Foam;
+class NameSemanticValue;
+class ParsingData;
+
+/**
+ * @brief Arguments of ParsingData::SetVertex, ParsingData::SetEdge,
+ * ParsingData::SetFace and Foam::SetBody recorded while parsing a
+ * piece of an element section.
+ *
+ * The recorded attributes are owned by this object and their names
+ * are stored in the ParsingData that parsed the piece, so it has to
+ * exist until the records are applied.
+ */
+class SectionRecords
+{
+public:
+    ~SectionRecords ();
+    /**
+     * The Add functions take the lists and leave them empty
+     */
+    void AddVertex (size_t i, double x, double y, double z,
+		    vector<NameSemanticValue*>& attributes);
+    void AddEdge (size_t i, size_t begin, size_t end, size_t middle,
+		  const G3D::Vector3int16& endTranslation,
+		  vector<NameSemanticValue*>& attributes);
+    void AddFace (size_t i, vector<int>& edges,
+		  vector<NameSemanticValue*>& attributes);
+    void AddBody (size_t i, vector<int>& faces,
+		  vector<NameSemanticValue*>& attributes);
+    /**
+     * Stores the recorded elements in foam in the order they were parsed.
+     */
+    void Apply (Foam* foam);
+
+private:
+    struct VertexRecord
+    {
+	size_t m_i;
+	double m_x, m_y, m_z;
+	vector<NameSemanticValue*>* m_attributes;
+    };
+    struct EdgeRecord
+    {
+	size_t m_i;
+	size_t m_begin, m_end, m_middle;
+	G3D::Vector3int16 m_endTranslation;
+	vector<NameSemanticValue*>* m_attributes;
+    };
+    /**
+     * A face and its edges or a body and its faces
+     */
+    struct FaceRecord
+    {
+	size_t m_i;
+	vector<int> m_elements;
+	vector<NameSemanticValue*>* m_attributes;
+    };
+
+private:
+    static vector<NameSemanticValue*>* takeAttributes (
+	vector<NameSemanticValue*>& attributes);
+    void addFace (vector<FaceRecord>* records, size_t i, vector<int>& elements,
+		  vector<NameSemanticValue*>& attributes);
+
+private:
+    vector<VertexRecord> m_vertices;
+    vector<EdgeRecord> m_edges;
+    vector<FaceRecord> m_faces;
+    vector<FaceRecord> m_bodies;
+};
+
+
+/**
+ * @brief Parses the element sections of a DMP file in parallel.
+ *
+ * The file is split at the lines that start the vertices, edges,
+ * faces and bodies sections and each section is split further, at
+ * lines that start an element, into pieces. The header is parsed
+ * first, then the pieces are parsed in parallel, each by its own
+ * ParsingData which records the elements (@see SectionRecords). At
+ * the end, the elements are stored in the foam in the order they
+ * appear in the file. Element lines are expected not to be inside
+ * comments that span several lines.
+ */
+class SectionParser
+{
+public:
+    /**
+     * Splits a data file
+     * @param buffer the data file in memory
+     * @param size size of the data file
+     */
+    SectionParser (const char* buffer, size_t size);
+    /**
+     * @return false if the file was not split because it is too
+     * small, there are no threads available or it has unexpected
+     * content between elements.
+     */
+    bool IsSplit () const
+    {
+	return ! m_pieces.empty ();
+    }
+    /**
+     * Parses the file and preprocesses the foam
+     * @param foam object where data is to be stored
+     * @return 0 for success, <> than 0 otherwise
+     */
+    int Parse (Foam* foam);
+
+private:
+    /**
+     * @brief A piece of an element section
+     */
+    struct Piece
+    {
+	void Parse ();
+
+	const char* m_begin;
+	const char* m_end;
+	size_t m_line;
+	int m_startToken;
+	const ParsingData* m_header;
+	DataProperties* m_dataProperties;
+	/**
+	 * Parsing context for the piece
+	 */
+	boost::shared_ptr<Foam> m_foam;
+	boost::shared_ptr<SectionRecords> m_records;
+	int m_result;
+	string m_error;
+    };
+
+private:
+    void addPiece (const char* begin, const char* end, size_t line,
+		   int startToken);
+
+private:
+    const char* m_buffer;
+    const char* m_headerEnd;
+    vector<Piece> m_pieces;
+    /**
+     * Not used, each piece of the file is parsed with OWN_DATA_PROPERTIES
+     */
+    DataProperties m_dataProperties;
+};
+
+
+#endif //__SECTION_PARSER_H__
+
+// Local Variables:
+// mode: c++
+// End:
@@ -4,10 +4,14 @@
  *
  */
 
+#include "Benchmark.h"
 #include "Body.h"
 #include "Debug.h"
+#include "ElementArena.h"
 #include "Foam.h"
+#include "FoamSnapshot.h"
 #include "Simulation.h"
+#include "TaskGraph.h"
 #include "OpenGLUtils.h"
 #include "ParsingData.h"
 #include "Settings.h"
@@ -60,16 +64,23 @@ public:
 	QString dir, 
 	const DmpObjectInfo& dmpObjectInfo, 
 	const vector<ForceNamesOneObject>& forceNames,
+	const vector<string>& loadAttributes,
 	bool useOriginal, DataProperties* dataProperties, 
 	Foam::ParametersOperation parametersOperation, size_t resolution,
-	bool debugParsing = false, bool debugScanning = false) : 
+	bool snapshotUsed, bool memoryMapped, bool parallelSections,
+	bool arenaUsed, bool debugParsing = false, bool debugScanning = false) : 
 
         m_dir (qPrintable(dir)), 
 	m_dmpObjectInfo (dmpObjectInfo), 
+	m_loadAttributes (loadAttributes),
 	m_useOriginal (useOriginal),
 	m_dataProperties (dataProperties), 
 	m_parametersOperation (parametersOperation),
         m_regularGridResolution (resolution),
+	m_snapshotUsed (snapshotUsed && ! debugParsing && ! debugScanning),
+	m_memoryMapped (memoryMapped),
+	m_parallelSections (parallelSections),
+	m_arenaUsed (arenaUsed),
 	m_debugParsing (debugParsing),
 	m_debugScanning (debugScanning)
     {
@@ -83,25 +94,78 @@ public:
      */
     boost::shared_ptr<Foam> operator () (QString dmpFile)
     {
-	boost::shared_ptr<Foam> foam;
 	string file = qPrintable (dmpFile);
 	string fullPath = m_dir + '/' + file;
 	int result;
 	ostringstream ostr;
+	boost::shared_ptr<Foam> foam = newFoam (fullPath);
+	FoamSnapshot snapshot (fullPath, foam->GetCacheDir ());
+	if (m_snapshotUsed)
+	{
+	    if (readSnapshot (&snapshot, foam.get ()))
+	    {
+		ostr << "Reading " << snapshot.GetPath () << " ..." << endl;
+		cdbg << ostr.str ();
+		return foam;
+	    }
+	    // a failed read may leave the foam half built
+	    foam = newFoam (fullPath);
+	}
 	ostr << "Parsing " << file << " ..." << endl;
 	cdbg << ostr.str ();
-	foam.reset (
+	qint64 bytes = Benchmark::Get ().IsEnabled () ? 
+	    QFileInfo (fullPath.c_str ()).size () : 0;
+	{
+	    // includes scanning and Foam::Preprocess
+	    BenchmarkPhase phase ("parse", Benchmark::PER_TIME_STEP, bytes);
+	    ElementArena::Scope scope (foam->GetArena ());
+	    result = foam->GetParsingData ().Parse (fullPath, foam.get ());
+	}
+	if (result != 0)
+	    ThrowException ("Error parsing ", fullPath);
+	if (m_snapshotUsed && FoamSnapshot::IsSupported (*foam))
+	    snapshot.Write (*foam);
+	return foam;
+    }
+
+    /**
+     * Rebuilds a time step kept in memory
+     * @param dmpFile name of the DMP file of the time step
+     */
+    boost::shared_ptr<Foam> Restore (QString dmpFile, const StoredFoam& stored)
+    {
+	boost::shared_ptr<Foam> foam = 
+	    newFoam (m_dir + '/' + qPrintable (dmpFile));
+	ElementArena::Scope scope (foam->GetArena ());
+	FoamSnapshot ().Restore (stored, foam.get ());
+	return foam;
+    }
+
+private:
+    bool readSnapshot (FoamSnapshot* snapshot, Foam* foam)
+    {
+	ElementArena::Scope scope (foam->GetArena ());
+	return snapshot->Read (foam);
+    }
+
+
+    boost::shared_ptr<Foam> newFoam (const string& fullPath)
+    {
+	boost::shared_ptr<Foam> foam (
 	    new Foam (m_useOriginal, m_dmpObjectInfo,
 		      m_forceNames, *m_dataProperties, 
 		      m_parametersOperation));
 	foam->GetParsingData ().SetDebugParsing (m_debugParsing);
 	foam->GetParsingData ().SetDebugScanning (m_debugScanning);	    
+	foam->GetParsingData ().SetMemoryMapped (m_memoryMapped);
+	foam->GetParsingData ().SetParallelSections (m_parallelSections);
+	foam->GetParsingData ().SetLoadAttributes (m_loadAttributes);
 	foam->SetVtiPath (fullPath, m_regularGridResolution);
-	result = foam->GetParsingData ().Parse (fullPath, foam.get ());
-	if (result != 0)
-	    ThrowException ("Error parsing ", fullPath);
+	if (m_arenaUsed)
+	    foam->CreateArena ();
 	return foam;
     }
+
 private:
     /**
      * Directory that stores the DMP files.
@@ -109,16 +173,255 @@ private:
     const string m_dir;
     const DmpObjectInfo& m_dmpObjectInfo;
     vector<ForceNamesOneObject> m_forceNames;
+    const vector<string>& m_loadAttributes;
     const bool m_useOriginal;
     DataProperties* m_dataProperties;
     Foam::ParametersOperation m_parametersOperation;
     size_t m_regularGridResolution;
+    const bool m_snapshotUsed;
+    const bool m_memoryMapped;
+    const bool m_parallelSections;
+    const bool m_arenaUsed;
     const bool m_debugParsing;
     const bool m_debugScanning;
 };
 
-const vector<T1> NO_T1S;
+/**
+ * Functor used to load the geometry of a time step that is not
+ * resident.
+ */
+class LoadTimeStep : public unary_function< size_t, boost::shared_ptr<Foam> >
+{
+public:
+    LoadTimeStep (const ParseDMP& parseDMP, const QStringList& dmpFiles,
+		  const vector<StoredFoam>& storedFoams) :
+	m_parseDMP (parseDMP),
+	m_dmpFiles (dmpFiles),
+	m_storedFoams (storedFoams)
+    {
+    }
+
+    boost::shared_ptr<Foam> operator () (size_t timeStep)
+    {
+	if (timeStep < m_storedFoams.size () && 
+	    m_storedFoams[timeStep].IsStored ())
+	    return m_parseDMP.Restore (
+		m_dmpFiles[timeStep], m_storedFoams[timeStep]);
+	else
+	    return m_parseDMP (m_dmpFiles[timeStep]);
+    }
+
+private:
+    ParseDMP m_parseDMP;
+    const QStringList& m_dmpFiles;
+    const vector<StoredFoam>& m_storedFoams;
+};
+
+/**
+ * Values of the body scalars of a time step, in the order of the
+ * bodies.
+ */
+struct FoamScalars
+{
+    boost::array<ValueCollector, BodyScalar::COUNT> m_property;
+    /**
+     * Largest deformation eigen value of bodies that are not objects
+     */
+    ValueCollector m_deformationEigenValue;
+};
+
+/**
+ * Reads all body scalars of a time step in one pass over its bodies.
+ */
+FoamScalars gatherScalars (const boost::shared_ptr<Foam>& foam)
+{
+    FoamScalars scalars;
+    getBodyDeformationEigenValue<0> deformationEigenValue;
+    BOOST_FOREACH (const boost::shared_ptr<Body>& body, foam->GetBodies ())
+    {
+	for (size_t i = BodyScalar::PROPERTY_BEGIN; 
+	     i < BodyScalar::COUNT; ++i)
+	{
+	    BodyScalar::Enum property = BodyScalar::FromSizeT (i);
+	    if (body->HasScalarValue (property))
+		scalars.m_property[i] (body->GetScalarValue (property));
+	}
+	if (! body->IsObject ())
+	    scalars.m_deformationEigenValue (deformationEigenValue (body));
+    }
+    return scalars;
+}
+
+/**
+ * Histogram of a property for all time steps. Values are added in
+ * time step order, so the result does not depend on the number of
+ * threads.
+ */
+void histogramAllTimeSteps (
+    vector<HistogramStatistics>* histograms,
+    const vector<FoamScalars>& scalars, size_t property)
+{
+    MinMaxStatistics minMaxStat;
+    BOOST_FOREACH (const FoamScalars& s, scalars)
+	s.m_property[property].Accumulate (&minMaxStat);
+    HistogramStatistics& histogram = (*histograms)[property];
+    histogram (acc::min (minMaxStat));
+    histogram (acc::max (minMaxStat));
+    BOOST_FOREACH (const FoamScalars& s, scalars)
+	s.m_property[property].Accumulate (&histogram);
+}
+
+/**
+ * Histograms of all properties for a time step, using the intervals
+ * of the histograms for all time steps.
+ * @param scalars values of the time steps starting with first
+ */
+void histogramsTimeStep (
+    const Simulation::Foams& foams, 
+    const vector<HistogramStatistics>& histograms,
+    const vector<FoamScalars>& scalars, size_t first, size_t timeStep)
+{
+    for (size_t i = BodyScalar::PROPERTY_BEGIN; i < BodyScalar::COUNT; ++i)
+	foams[timeStep]->CalculateHistogramStatistics (
+	    BodyScalar::FromSizeT (i), 
+	    acc::min (histograms[i]), acc::max (histograms[i]),
+	    scalars[timeStep - first].m_property[i]);
+}
+
+void benchmarkFoamMethod (const char* name, 
+			  const Simulation::FoamParamMethod& method, Foam* foam)
+{
+    BenchmarkPhase phase (name, Benchmark::PER_TIME_STEP);
+    method (foam);
+}
+
+qint64 filesSize (const QDir& dir, const QStringList& files)
+{
+    qint64 bytes = 0;
+    BOOST_FOREACH (const QString& file, files)
+	bytes += QFileInfo (dir, file).size ();
+    return bytes;
+}
+
+/**
+ * Runs only the scanner over a DMP file (@see Simulation::ScanDMPs)
+ */
+void scanDMP (const string& dir, bool useOriginal, 
+	      const DmpObjectInfo& dmpObjectInfo,
+	      const vector<ForceNamesOneObject>& forceNames,
+	      const QString& dmpFile)
+{
+    string fullPath = dir + '/' + qPrintable (dmpFile);
+    BenchmarkPhase phase ("scan", Benchmark::PER_TIME_STEP, 
+			  QFileInfo (fullPath.c_str ()).size ());
+    ParsingData (useOriginal, dmpObjectInfo, forceNames).Scan (fullPath);
+}
+
+void storeFoam (const Simulation::Foams& foams, StoredFoam* stored, size_t i)
+{
+    const Foam& foam = *foams[i];
+    // the other time steps are parsed again when they are needed
+    if (FoamSnapshot::IsSupported (foam))
+	FoamSnapshot ().Store (foam, &stored[i]);
+}
+
 const char* CACHE_DIR_NAME = ".foamvis";
+const char* T1S_ARRAY = "t1positions";
+const char* T1S_COUNT = "num_pops_step";
+
+/**
+ * Reads the T1s stored in variables in the DMP file of a time step.
+ * @param found stores false if the variables are not in the DMP file
+ */
+void readT1s (Foam* foam, bool is2D, vector<T1>* t1s, char* found)
+{
+    *found = foam->GetParsingData ().GetT1 (T1S_ARRAY, T1S_COUNT, t1s, is2D);
+}
+
+/**
+ * Median pressure of a time step measured from its minimum pressure.
+ * The pressures are not modified, see alignPressureMedian.
+ */
+void pressureMedianAboveMin (const Foam* foam, double* median)
+{
+    *median = foam->CalculateMedian (BodyScalar::PRESSURE) - 
+	foam->GetMinScalar (BodyScalar::PRESSURE);
+}
+
+void maxPressureMedian (const vector<double>& medians, double* maxMedian)
+{
+    *maxMedian = *max_element (medians.begin (), medians.end ());
+}
+
+/**
+ * Makes every pressure greater than 0 by subtracting the minimum
+ * pressure of a bubble in the time step and aligns the pressure median
+ * with maxMedian. Both offsets are subtracted in one pass over the bodies.
+ * @param median the median returned by pressureMedianAboveMin
+ */
+void alignPressureMedian (
+    Foam* foam, const double* median, const double* maxMedian)
+{
+    foam->SubtractFromPressure (
+	foam->GetMinScalar (BodyScalar::PRESSURE) + *median - *maxMedian);
+}
+
+/**
+ * Functor that parses a DMP file and runs on it the methods Preprocess
+ * applies to each time step. This frees the parsing data of the time
+ * step right after it is parsed, instead of after all DMP files are
+ * parsed. The T1s stored in the DMP file are read before that.
+ */
+class ParsePreprocessDMP : 
+    public unary_function< size_t, boost::shared_ptr<Foam> >
+{
+public:
+    /**
+     * @param begin first time step of the batch, the index of t1s
+     * @param t1s where to store the T1s of each time step or 0 if
+     *        T1s are not read
+     * @param t1sFound stores false for a time step without T1s
+     */
+    ParsePreprocessDMP (
+	const ParseDMP& parseDMP, const QStringList& dmpFiles,
+	vector<Simulation::FoamParamMethod>* methods, bool is2D,
+	size_t begin, vector< vector<T1> >* t1s, vector<char>* t1sFound) :
+	m_parseDMP (parseDMP),
+	m_dmpFiles (dmpFiles),
+	m_methods (methods),
+	m_is2D (is2D),
+	m_begin (begin),
+	m_t1s (t1s),
+	m_t1sFound (t1sFound)
+    {
+    }
+
+    /**
+     * A time step with constraint points to fix is only parsed, as
+     * it is fixed using the previous time step
+     * (@see Simulation::parsePreprocess).
+     */
+    boost::shared_ptr<Foam> operator () (size_t timeStep)
+    {
+	boost::shared_ptr<Foam> foam = m_parseDMP (m_dmpFiles[timeStep]);
+	if (foam == 0 || foam->HasConstraintPointsToFix ())
+	    return foam;
+	size_t i = timeStep - m_begin;
+	if (m_t1s != 0)
+	    readT1s (foam.get (), m_is2D, &(*m_t1s)[i], &(*m_t1sFound)[i]);
+	FoamParamMethodList (&(*m_methods)[0], m_methods->size ()) (foam);
+	return foam;
+    }
+
+private:
+    ParseDMP m_parseDMP;
+    const QStringList& m_dmpFiles;
+    vector<Simulation::FoamParamMethod>* m_methods;
+    bool m_is2D;
+    size_t m_begin;
+    vector< vector<T1> >* m_t1s;
+    vector<char>* m_t1sFound;
+};
 
 vtkSmartPointer<vtkImageData> doubleToFloatArray (
     vtkSmartPointer<vtkImageData> p)
@@ -147,12 +450,23 @@ Simulation::Simulation () :
         BodyScalar::COUNT, HistogramStatistics (HISTOGRAM_INTERVALS)),
     m_meanVolume (0),
     m_pressureAdjusted (false),
+    m_maxPressureMedian (0),
+    m_t1sInDmp (false),
     m_t1Shift (0),
     m_useOriginal (false),
     m_rotation2D (0),
     m_reflectAxis (numeric_limits<size_t>::max ()),
     m_maxDeformationEigenValue (0),
-    m_regularGridResolution (64)
+    m_regularGridResolution (64),
+    m_snapshotUsed (true),
+    m_dmpMemoryMapped (true),
+    m_dmpParallelSections (true),
+    m_elementArenaUsed (false),
+    m_residentTimeSteps (0),
+    m_inFlightTimeSteps (2 * max (QThread::idealThreadCount (), 1)),
+    m_foamsPreprocessed (false),
+    m_residentMutex (new QMutex ()),
+    m_topologyShared (false)
 {
     QDir h = QDir::home ();
     if (! h.exists (CACHE_DIR_NAME))
@@ -169,7 +483,15 @@ string Simulation::GetBaseCacheDir ()
 
 string Simulation::GetCacheDir () const
 {
-    return GetFoam (0).GetCacheDir ();
+    return GetFoamSummary (0).GetCacheDir ();
+}
+
+void Simulation::SetResidentTimeSteps (size_t timeSteps)
+{
+    // a caller may use the foams for two time steps at the same time
+    if (timeSteps == 1)
+	ThrowException ("Resident time steps needs to be 0 or at least 2");
+    m_residentTimeSteps = timeSteps;
 }
 
 
@@ -216,15 +538,12 @@ void Simulation::calculateBodyWraps ()
 	boost::bind (
 	    &BodyAlongTime::CalculateBodyWraps,
 	    boost::bind (&BodiesAlongTime::BodyMap::value_type::second, 
-			 _1), *this));
+			 _1), *this, 0));
 }
 
 
-void Simulation::Preprocess ()
+vector<Simulation::FoamParamMethod> Simulation::getPreprocessMethods () const
 {
-    cdbg << "Preprocess temporal foam data ..." << endl;
-    fixConstraintPoints ();
-    ParseT1s ("t1positions", "num_pops_step");
     boost::array<FoamParamMethod, 9> methods = {{
 	    boost::bind (&Foam::CreateObjectBody, _1, 
 			 GetDmpObjectInfo ().m_constraintIndex),
@@ -237,36 +556,198 @@ void Simulation::Preprocess ()
 	    boost::bind (&Foam::StoreObjects, _1),
 	    boost::bind (&Foam::StoreConstraintFaces, _1)
     }};
-    MapPerFoam (&methods[0], methods.size ());
-    CalculateBoundingBox ();
-    CacheBodiesAlongTime ();
-    calculateBodyWraps ();
-    calculateVelocity ();
-    FoamParamMethod f = boost::bind (&Foam::CalculateMinMaxStatistics, _1);
-    MapPerFoam (&f, 1);
+    boost::array<const char*, 9> names = {{
+	    "Foam::CreateObjectBody",
+	    "Foam::SetForceAllObjects",
+	    "Foam::ReleaseParsingData",
+	    "Foam::CalculateBoundingBox",
+	    "Foam::CalculateDeformationSimple",
+	    "Foam::CalculateBodyNeighborsAndGrowthRate",
+	    "Foam::CalculateDeformationTensor",
+	    "Foam::StoreObjects",
+	    "Foam::StoreConstraintFaces"
+    }};
+    vector<FoamParamMethod> v (methods.begin (), methods.end ());
+    if (Benchmark::Get ().IsEnabled ())
+	for (size_t i = 0; i < v.size (); ++i)
+	    v[i] = boost::bind (benchmarkFoamMethod, names[i], v[i], _1);
+    return v;
+}
+
+/**
+ * The steps are tasks in a TaskGraph. Steps for a time step depend
+ * only on the previous steps for the same time step, or for the next
+ * time step when fixing constraint points, so different time steps do
+ * not wait for each other. Steps that use the bodies of all time
+ * steps depend on the steps before them for all time steps.
+ */
+void Simulation::Preprocess ()
+{
+    BenchmarkPhase benchmarkPhase ("Simulation::Preprocess");
+    cdbg << "Preprocess temporal foam data ..." << endl;
+    size_t timeSteps = m_foams.size ();
+    TaskGraph graph;
+    // the last task that changes each time step
+    vector<TaskGraph::Task> last (timeSteps, TaskGraph::NONE);
+    TaskGraph::Task t1sPushed = TaskGraph::NONE;
+    vector< vector<T1> > t1s;
+    vector<char> t1sFound;
+    vector<FoamParamMethod> methods = getPreprocessMethods ();
+    // ParseDMPs runs the methods for each time step, unless
+    // constraint points are fixed and there are resident time steps
+    // (@see preprocessParsed)
+    if (! m_foamsPreprocessed)
+    {
+	// constraint points are fixed using the previous time step, 
+	// which cannot change while they are fixed
+	vector<TaskGraph::Task> fix (timeSteps);
+	for (size_t i = 0; i < timeSteps; ++i)
+	{
+	    fix[i] = graph.Add (
+		"Foam::FixConstraintPoints", Benchmark::PER_TIME_STEP,
+		boost::bind (&Foam::FixConstraintPoints, m_foams[i].get (),
+			     i == 0 ? 0 : m_foams[i - 1].get ()));
+	    if (i != 0)
+		graph.AddDependency (fix[i - 1], fix[i]);
+	}
+	if (m_t1.IsEmpty () && timeSteps > 1)
+	{
+	    cdbg << "Parsing topological changes..." << endl;
+	    t1s.resize (timeSteps - 1);
+	    t1sFound.resize (t1s.size (), false);
+	    t1sPushed = graph.Add (
+		"Simulation::pushT1s", Benchmark::SERIAL,
+		boost::bind (&Simulation::pushT1s, this, 1, 
+			     boost::cref (t1s), boost::cref (t1sFound)));
+	}
+	for (size_t i = 0; i < timeSteps; ++i)
+	{
+	    TaskGraph::Task preprocess = graph.Add (
+		"Simulation::preprocessFoam", Benchmark::PER_TIME_STEP,
+		boost::bind<void> (
+		    FoamParamMethodList (&methods[0], methods.size ()),
+		    m_foams[i]));
+	    TaskGraph::Task t1 = TaskGraph::NONE;
+	    // T1s are read before the parsing data is released
+	    if (t1sPushed != TaskGraph::NONE && i != 0)
+	    {
+		t1 = graph.Add (
+		    "Simulation::readT1s", Benchmark::PER_TIME_STEP,
+		    boost::bind (readT1s, m_foams[i].get (), 
+				 GetFoamSummary (0).Is2D (),
+				 &t1s[i - 1], &t1sFound[i - 1]));
+		graph.AddDependency (fix[i], t1);
+		graph.AddDependency (t1, preprocess);
+		graph.AddDependency (t1, t1sPushed);
+	    }
+	    // the next time step is fixed using this one
+	    for (size_t j = i; j < min (i + 2, timeSteps); ++j)
+		graph.AddDependency (fix[j], preprocess);
+	    last[i] = preprocess;
+	}
+    }
+    // the steps below need only the summary of each time step
+    TaskGraph::Task boundingBox = graph.Add (
+	"Simulation::CalculateBoundingBox", Benchmark::SERIAL,
+	boost::bind (&Simulation::CalculateBoundingBox, this));
+    TaskGraph::Task cache = graph.Add (
+	"Simulation::CacheBodiesAlongTime", Benchmark::SERIAL,
+	boost::bind (&Simulation::CacheBodiesAlongTime, this));
+    for (size_t i = 0; i < timeSteps; ++i)
+    {
+	graph.AddDependency (last[i], boundingBox);
+	graph.AddDependency (last[i], cache);
+    }
+    TaskGraph::Task wraps = graph.Add (
+	"Simulation::calculateBodyWraps", Benchmark::SERIAL,
+	boost::bind (&Simulation::calculateBodyWraps, this));
+    graph.AddDependency (cache, wraps);
+    TaskGraph::Task velocity = graph.Add (
+	"Simulation::calculateVelocity", Benchmark::SERIAL,
+	boost::bind (&Simulation::calculateVelocity, this));
+    graph.AddDependency (wraps, velocity);
+    for (size_t i = 0; i < timeSteps; ++i)
+    {
+	last[i] = graph.Add (
+	    "Foam::CalculateMinMaxStatistics", Benchmark::PER_TIME_STEP,
+	    boost::bind (&Foam::CalculateMinMaxStatistics, m_foams[i]));
+	graph.AddDependency (velocity, last[i]);
+    }
     // save the regular grid before adjusting pressure
     if (Is3D () && GetRegularGridResolution () != 0)
     {
 	cdbg << "Resampling to a regular grid ..." << endl;
-	f = boost::bind (
-            &Foam::SaveRegularGrid, _1, 
-            GetRegularGridResolution (), GetBoundingBoxAllTimeSteps ());
-	MapPerFoam (&f, 1);
+	if (GetResidentTimeSteps () == 0)
+	    for (size_t i = 0; i < timeSteps; ++i)
+	    {
+		TaskGraph::Task grid = graph.Add (
+		    "Foam::SaveRegularGrid", Benchmark::PER_TIME_STEP,
+		    boost::bind (
+			&Foam::SaveRegularGrid, m_foams[i], 
+			GetRegularGridResolution (),
+			boost::bind (
+			    &Simulation::GetBoundingBoxAllTimeSteps, this)));
+		graph.AddDependency (boundingBox, grid);
+		graph.AddDependency (last[i], grid);
+		last[i] = grid;
+	    }
+	else
+	{
+	    // loads time steps that are not resident
+	    TaskGraph::Task grids = graph.Add (
+		"Simulation::saveRegularGrids", Benchmark::SERIAL,
+		boost::bind (&Simulation::saveRegularGrids, this));
+	    graph.AddDependency (boundingBox, grids);
+	    for (size_t i = 0; i < timeSteps; ++i)
+	    {
+		graph.AddDependency (last[i], grids);
+		last[i] = grids;
+	    }
+	}
     }
-    if (m_pressureAdjusted && ! GetFoam (0).HasFreeFace ())
-        adjustPressureAlignMedians ();
-    calculateStatistics ();
+    vector<double> medians (timeSteps);
+    if (m_pressureAdjusted && ! GetFoamSummary (0).HasFreeFace ())
+    {
+	// align the pressure medians in every time step with the max
+	// median for all time steps
+	TaskGraph::Task maxMedian = graph.Add (
+	    "Simulation::maxPressureMedian", Benchmark::SERIAL,
+	    boost::bind (maxPressureMedian, boost::cref (medians), 
+			 &m_maxPressureMedian));
+	for (size_t i = 0; i < timeSteps; ++i)
+	{
+	    TaskGraph::Task median = graph.Add (
+		"Foam::pressureMedianAboveMin", Benchmark::PER_TIME_STEP,
+		boost::bind (pressureMedianAboveMin, m_foams[i].get (), 
+			     &medians[i]));
+	    graph.AddDependency (last[i], median);
+	    graph.AddDependency (median, maxMedian);
+	    last[i] = graph.Add (
+		"Foam::alignPressureMedian", Benchmark::PER_TIME_STEP,
+		boost::bind (alignPressureMedian, m_foams[i].get (), 
+			     &medians[i], &m_maxPressureMedian));
+	    graph.AddDependency (maxMedian, last[i]);
+	}
+    }
+    TaskGraph::Task statistics = graph.Add (
+	"Simulation::calculateStatistics", Benchmark::SERIAL,
+	boost::bind (&Simulation::calculateStatistics, this));
+    for (size_t i = 0; i < timeSteps; ++i)
+	graph.AddDependency (last[i], statistics);
+    TaskGraph::Task t1sMoved = TaskGraph::NONE;
     if (IsTorus () && Is3D ())
     {
-        for (size_t i = 0; i < m_t1.size (); ++i)
-        {
-            const OOBox& originalDomain = m_foams[i]->GetTorusDomain ();
-            for (size_t j = 0; j < m_t1[i].size (); ++j)
-                moveInsideOriginalDomain (
-                    &m_t1[i][j], originalDomain);
-        }
+	t1sMoved = graph.Add (
+	    "Simulation::moveT1sInsideOriginalDomain", Benchmark::SERIAL,
+	    boost::bind (&Simulation::moveT1sInsideOriginalDomain, this));
+	graph.AddDependency (t1sPushed, t1sMoved);
     }
-    calculateT1TypeCount ();
+    TaskGraph::Task t1TypeCount = graph.Add (
+	"Simulation::calculateT1TypeCount", Benchmark::SERIAL,
+	boost::bind (&Simulation::calculateT1TypeCount, this));
+    graph.AddDependency (t1sPushed, t1TypeCount);
+    graph.AddDependency (t1sMoved, t1TypeCount);
+    graph.Run ();
 }
 
 boost::array<int, 6> Simulation::GetExtentResolution () const
@@ -294,124 +775,408 @@ void Simulation::moveInsideOriginalDomain (
 }
 
 
-void Simulation::fixConstraintPoints ()
+void Simulation::moveT1sInsideOriginalDomain ()
 {
-    Foams& foams = GetFoams ();
-    Foam* prevFoam = 0;
-    for (size_t i = 0; i < foams.size (); ++i)
+    for (size_t i = 0; i < m_t1.GetTimeSteps (); ++i)
     {
-	Foam* foam = foams[i].get ();
-	foam->FixConstraintPoints (prevFoam);
-	prevFoam = foam;
+	const OOBox& originalDomain = m_foams[i]->GetTorusDomain ();
+	BOOST_FOREACH (T1& t1, m_t1.Get (i))
+	    moveInsideOriginalDomain (&t1, originalDomain);
     }
 }
 
 
 void Simulation::MapPerFoam (FoamParamMethod* foamMethods, size_t n)
+{
+    mapPerFoam (m_foams.begin (), m_foams.end (), foamMethods, n);
+}
+
+void Simulation::mapPerFoam (Foams::iterator begin, Foams::iterator end,
+			     FoamParamMethod* foamMethods, size_t n)
 {
     FoamParamMethodList fl (foamMethods, n);
-    QtConcurrent::blockingMap (m_foams.begin (), m_foams.end (), fl);
+    QtConcurrent::blockingMap (begin, end, fl);
 }
 
+/**
+ * Runs the methods Preprocess applies to each time step on
+ * [begin, end), which were just parsed, and releases their
+ * geometry if there are resident time steps. This way at most
+ * GetResidentTimeSteps () time steps are in memory while parsing.
+ * @return false if a time step has constraint points to fix and
+ *         there are resident time steps. Nothing is preprocessed, as
+ *         a time step loaded again would not have its points fixed.
+ */
+bool Simulation::preprocessParsed (
+    size_t begin, size_t end, bool* t1sParsed)
+{
+    if (GetResidentTimeSteps () != 0 && 
+	hasConstraintPointsToFix (begin, end))
+	return false;
+    fixConstraintPoints (begin, end);
+    if (*t1sParsed)
+	*t1sParsed = parseT1s (T1S_ARRAY, T1S_COUNT, begin, end);
+    if (GetResidentTimeSteps () != 0 && IsTopologyShared ())
+	storeFoams (begin, end);
+    vector<FoamParamMethod> methods = getPreprocessMethods ();
+    mapPerFoam (m_foams.begin () + begin, m_foams.begin () + end,
+		&methods[0], methods.size ());
+    releaseGeometry (begin, end);
+    return true;
+}
 
-size_t foamsIndex (
-    Simulation::Foams::iterator current, Simulation::Foams::iterator begin)
+/**
+ * Parses and preprocesses the time steps [begin, end), one task for
+ * each time step, so that there is no wait between parsing and
+ * preprocessing. Used after the first batch, which sets the
+ * DataProperties. Time steps with constraint points to fix are
+ * fixed in order, after all of them are parsed, and preprocessed
+ * afterwards.
+ * @return false in the same case as preprocessParsed
+ */
+bool Simulation::parsePreprocess (size_t begin, size_t end, bool* t1sParsed,
+				  bool debugParsing, bool debugScanning)
 {
-    return (current - begin) / sizeof *begin;
+    vector<size_t> timeSteps;
+    for (size_t i = begin; i < end; ++i)
+	timeSteps.push_back (i);
+    vector< vector<T1> > t1s (*t1sParsed ? timeSteps.size () : 0);
+    vector<char> t1sFound (t1s.size (), false);
+    vector<FoamParamMethod> methods = getPreprocessMethods ();
+    QList< boost::shared_ptr<Foam> > foams = QtConcurrent::blockingMapped 
+	< QList < boost::shared_ptr<Foam> > > (
+	    timeSteps.begin (), timeSteps.end (),
+	    ParsePreprocessDMP (
+		ParseDMP (
+		    m_dmpDir, GetDmpObjectInfo (),
+		    GetForcesNames (), GetLoadAttributes (), OriginalUsed (),
+		    GetDataProperties (),
+		    Foam::TEST_DATA_PROPERTIES, GetRegularGridResolution (),
+		    IsSnapshotUsed (), IsDmpMemoryMapped (),
+		    IsDmpParallelSections (), IsElementArenaUsed (),
+		    debugParsing, debugScanning),
+		m_dmpFiles, &methods, GetFoamSummary (0).Is2D (), begin,
+		*t1sParsed ? &t1s : 0, &t1sFound));
+    if (count_if (foams.constBegin (), foams.constEnd (),
+		  bl::_1 != boost::shared_ptr<Foam>()) != foams.size ())
+	ThrowException ("Could not process all files\n");
+    copy (foams.constBegin (), foams.constEnd (), m_foams.begin () + begin);
+    if (GetResidentTimeSteps () != 0 && 
+	hasConstraintPointsToFix (begin, end))
+	return false;
+    Foams fixed;
+    BOOST_FOREACH (size_t timeStep, fixConstraintPoints (begin, end))
+    {
+	size_t i = timeStep - begin;
+	if (*t1sParsed)
+	    readT1s (m_foams[timeStep].get (), GetFoamSummary (0).Is2D (),
+		     &t1s[i], &t1sFound[i]);
+	fixed.push_back (m_foams[timeStep]);
+    }
+    mapPerFoam (fixed.begin (), fixed.end (), &methods[0], methods.size ());
+    if (*t1sParsed)
+	*t1sParsed = pushT1s (begin, t1s, t1sFound);
+    releaseGeometry (begin, end);
+    return true;
 }
 
+bool Simulation::hasConstraintPointsToFix (size_t begin, size_t end) const
+{
+    for (size_t i = begin; i < end; ++i)
+	if (m_foams[i]->HasConstraintPointsToFix ())
+	    return true;
+    return false;
+}
 
-double GetPressureBody0 (const boost::shared_ptr<Foam>& foam)
+/**
+ * Fixes the constraint points of the time steps in [begin, end) in
+ * order, each one using the previous time step. Called only when
+ * there are no resident time steps, so the previous time step is in
+ * memory.
+ * @return the time steps that were fixed
+ */
+vector<size_t> Simulation::fixConstraintPoints (size_t begin, size_t end)
 {
-    return foam->GetBody (0).GetScalarValue (
-        BodyScalar::PRESSURE);
+    vector<size_t> fixed;
+    for (size_t i = begin; i < end; ++i)
+	if (m_foams[i]->HasConstraintPointsToFix ())
+	{
+	    m_foams[i]->FixConstraintPoints (
+		i == 0 ? 0 : m_foams[i - 1].get ());
+	    fixed.push_back (i);
+	}
+    return fixed;
 }
 
-void Simulation::adjustPressureSubtractReference ()
+/**
+ * Adds the T1s read by readT1s for the time steps starting at begin,
+ * in order.
+ * @return false if the T1s variables are not in the DMP files, same
+ *         as parseT1s
+ */
+bool Simulation::pushT1s (size_t begin, const vector< vector<T1> >& t1s,
+			  const vector<char>& t1sFound)
 {
-    QtConcurrent::blockingMap (
-	m_foams.begin (), m_foams.end (),
-	boost::bind (&Foam::SubtractFromPressure, _1, 
-		     boost::bind (GetPressureBody0, _1)));
+    for (size_t i = 0; i < t1s.size (); ++i)
+    {
+	if (! t1sFound[i])
+	{
+	    m_t1.Clear ();
+	    RuntimeAssert (begin + i == 1, 
+			   "ParseT1s: T1s variables not set at index ", 
+			   begin + i);
+	    return false;
+	}
+	m_t1.PushBack (t1s[i]);
+    }
+    m_t1sInDmp = true;
+    return true;
 }
 
-void Simulation::adjustPressureAlignMedians ()
+void Simulation::releaseGeometry (size_t begin, size_t end)
 {
-    // adjust pressure in every time step,
-    // by substracting the minimum pressure of a bubble in that time step.
-    // this makes every pressure greater than 0.
-    QtConcurrent::blockingMap (
-	m_foams.begin (), m_foams.end (),
-	boost::bind (&Foam::SubtractFromPressure, _1, 
-		     boost::bind (&Foam::GetMinScalar, _1, BodyScalar::PRESSURE)));
-
-    // adjust the pressure by aligning the medians in every time step,
-    // with the max median for all time steps
-    vector<double> medians = 
-	QtConcurrent::blockingMapped< vector<double> > (
-	    m_foams.begin (), m_foams.end (),
-	    boost::bind (&Foam::CalculateMedian, _1, BodyScalar::PRESSURE));
-    double maxMedian = *max_element (medians.begin (), medians.end ());
-    for (size_t i = 0; i < m_foams.size (); ++i)
-	m_foams[i]->SubtractFromPressure (medians[i] - maxMedian);
+    if (GetResidentTimeSteps () != 0)
+	for (size_t i = begin; i < end; ++i)
+	    m_foams[i]->ReleaseGeometry ();
 }
 
-void Simulation::calculateStatistics ()
+void Simulation::saveRegularGrids ()
 {
-    for (size_t i = BodyScalar::PROPERTY_BEGIN; 
-	 i < BodyScalar::COUNT; ++i)
+    FoamParamMethod f = boost::bind (
+	&Foam::SaveRegularGrid, _1, 
+	GetRegularGridResolution (), GetBoundingBoxAllTimeSteps ());
+    if (Benchmark::Get ().IsEnabled ())
+	f = boost::bind (benchmarkFoamMethod, "Foam::SaveRegularGrid", f, _1);
+    if (GetResidentTimeSteps () == 0)
     {
-	MinMaxStatistics minMaxStat;
-	// statistics for all time-steps
-	BodyScalar::Enum property = BodyScalar::FromSizeT (i);
-	forAllBodiesAccumulateProperty (&minMaxStat, property);
-	m_histogramScalar[property] (acc::min (minMaxStat));
-	m_histogramScalar[property] (acc::max (minMaxStat));
-	forAllBodiesAccumulateProperty (&m_histogramScalar[property], property);
-
-	// statistics per time-step
-	double min = acc::min(m_histogramScalar[property]);
-	double max = acc::max(m_histogramScalar[property]);
-	QtConcurrent::blockingMap (
-	    m_foams.begin (), m_foams.end (),
-	    boost::bind (&Foam::CalculateHistogramStatistics, _1,
-			 BodyScalar::FromSizeT (i), min, max));
+	MapPerFoam (&f, 1);
+	return;
     }
+    // load only the time steps that don't have a regular grid saved,
+    // GetResidentTimeSteps () at a time
+    vector<size_t> timeSteps;
+    for (size_t i = 0; i < m_foams.size (); ++i)
+    {
+	if (! m_foams[i]->IsRegularGridSaved ())
+	    timeSteps.push_back (i);
+	if (timeSteps.empty () ||
+	    (timeSteps.size () < GetResidentTimeSteps () && 
+	     i + 1 < m_foams.size ()))
+	    continue;
+	loadGeometry (timeSteps);
+	Foams foams;
+	BOOST_FOREACH (size_t timeStep, timeSteps)
+	    foams.push_back (m_foams[timeStep]);
+	mapPerFoam (foams.begin (), foams.end (), &f, 1);
+	BOOST_FOREACH (size_t timeStep, timeSteps)
+	    m_foams[timeStep]->ReleaseGeometry ();
+	timeSteps.clear ();
+    }
+}
+
+boost::shared_ptr<TimeStepPin> Simulation::Pin (size_t timeStep)
+{
+    QMutexLocker locker (m_residentMutex.get ());
+    makeResident (timeStep);
+    ++m_pinCount[timeStep];
+    return boost::shared_ptr<TimeStepPin> (new TimeStepPin (this, timeStep));
+}
+
+void Simulation::unpin (size_t timeStep)
+{
+    QMutexLocker locker (m_residentMutex.get ());
+    map<size_t, size_t>::iterator it = m_pinCount.find (timeStep);
+    if (it != m_pinCount.end () && --it->second == 0)
+	m_pinCount.erase (it);
+}
+
+bool Simulation::IsResident (size_t timeStep) const
+{
+    QMutexLocker locker (m_residentMutex.get ());
+    return ! m_foams[timeStep]->IsGeometryReleased ();
+}
+
+void Simulation::assertResident (size_t timeStep) const
+{
+    if (GetResidentTimeSteps () != 0)
+	RuntimeAssert (IsResident (timeStep),
+		       "GetFoam: time step not pinned: ", timeStep);
+}
+
+/**
+ * Releases the least recently used time steps that are not pinned to
+ * make room for timeStep. Called with m_residentMutex locked.
+ */
+void Simulation::makeResident (size_t timeStep)
+{
+    if (GetResidentTimeSteps () == 0)
+	return;
+    deque<size_t>::iterator it = find (
+	m_residentQueue.begin (), m_residentQueue.end (), timeStep);
+    if (it != m_residentQueue.end ())
+	m_residentQueue.erase (it);
+    else
     {
-	MinMaxStatistics minMaxStat;
-	forAllBodiesAccumulate (
-	    &minMaxStat, 
-	    getBodyDeformationEigenValue<0> ());
-	m_maxDeformationEigenValue = acc::max (minMaxStat);
+	it = m_residentQueue.begin ();
+	while (m_residentQueue.size () >= GetResidentTimeSteps () &&
+	       it != m_residentQueue.end ())
+	{
+	    if (m_pinCount.find (*it) != m_pinCount.end ())
+		++it;
+	    else
+	    {
+		m_foams[*it]->ReleaseGeometry ();
+		it = m_residentQueue.erase (it);
+	    }
+	}
     }
+    if (m_foams[timeStep]->IsGeometryReleased ())
+	loadGeometry (vector<size_t> (1, timeStep));
+    m_residentQueue.push_back (timeStep);
+}
+
+/**
+ * Rebuilds timeSteps from memory (@see SetTopologyShared) or reads
+ * again their DMP files, preprocesses them and gives their geometry
+ * to the foams that released it.
+ */
+void Simulation::loadGeometry (const vector<size_t>& timeSteps)
+{
+    BOOST_FOREACH (size_t timeStep, timeSteps)
+	RuntimeAssert (m_foams[timeStep]->IsGeometryReleased (),
+		       "Time step is already resident:", timeStep);
+    QList< boost::shared_ptr<Foam> > loaded = QtConcurrent::blockingMapped 
+	< QList < boost::shared_ptr<Foam> > > (
+	    timeSteps.begin (), timeSteps.end (),
+	    LoadTimeStep (
+		ParseDMP (
+		    m_dmpDir, GetDmpObjectInfo (),
+		    GetForcesNames (), GetLoadAttributes (), OriginalUsed (),
+		    GetDataProperties (),
+		    Foam::TEST_DATA_PROPERTIES, GetRegularGridResolution (),
+		    IsSnapshotUsed (), IsDmpMemoryMapped (),
+		    IsDmpParallelSections (), IsElementArenaUsed ()),
+		m_dmpFiles, m_storedFoams));
+    Foams foams (loaded.constBegin (), loaded.constEnd ());
+    vector<FoamParamMethod> methods = getPreprocessMethods ();
+    mapPerFoam (foams.begin (), foams.end (), &methods[0], methods.size ());
+    for (size_t i = 0; i < timeSteps.size (); ++i)
     {
-        MeanStatistics meanStat;
-        forAllBodiesAccumulateProperty (&meanStat, BodyScalar::ACTUAL_VOLUME);
-        m_meanVolume = acc::mean (meanStat);
+	size_t timeStep = timeSteps[i];
+	Foam& foam = *m_foams[timeStep];
+	foam.RestoreGeometry (foams[i].get ());
+	BOOST_FOREACH (const boost::shared_ptr<Body>& body, foam.GetBodies ())
+	    m_bodiesAlongTime.CacheBody (body, timeStep, m_foams.size ());
     }
 }
 
-template <typename Accumulator, typename GetBodyScalar>
-void Simulation::forAllBodiesAccumulate (
-    Accumulator* acc, GetBodyScalar getBodyScalar)
+/**
+ * Keeps in memory the time steps [begin, end), which were just
+ * parsed. A time step shares the topology of the previous time step
+ * if they are the same.
+ */
+void Simulation::storeFoams (size_t begin, size_t end)
 {
+    BenchmarkPhase benchmarkPhase ("Simulation::storeFoams");
+    m_storedFoams.resize (end);
+    storeFoams (Foams (m_foams.begin () + begin, m_foams.begin () + end),
+		&m_storedFoams[begin]);
+    shareTopology (begin, end);
+}
+
+void Simulation::storeFoams (const Foams& foams, StoredFoam* stored)
+{
+    vector<size_t> indexes;
+    for (size_t i = 0; i < foams.size (); ++i)
+	indexes.push_back (i);
     QtConcurrent::blockingMap (
-	m_foams.begin (), m_foams.end (),
-	boost::bind (&Foam::Accumulate<Accumulator, GetBodyScalar>, 
-		     _1, acc, getBodyScalar));
+	indexes, boost::bind (storeFoam, boost::cref (foams), stored, _1));
+}
+
+/**
+ * Time steps in [begin, end) share the topology of the previous time
+ * step if they are the same.
+ */
+void Simulation::shareTopology (size_t begin, size_t end)
+{
+    size_t shared = 0;
+    for (size_t i = max (begin, size_t (1)); i < end; ++i)
+    {
+	StoredFoam& previous = m_storedFoams[i - 1];
+	StoredFoam& stored = m_storedFoams[i];
+	if (previous.IsStored () && stored.IsStored () &&
+	    *previous.m_topology == *stored.m_topology)
+	{
+	    stored.m_topology = previous.m_topology;
+	    ++shared;
+	}
+    }
+    cdbg << "Time steps " << begin << " to " << end - 1 << ": "
+	 << shared << " share the topology of the previous time step" 
+	 << endl;
 }
 
 
-template <typename Accumulator>
-void Simulation::forAllBodiesAccumulateProperty (
-    Accumulator* acc, BodyScalar::Enum property)
+size_t foamsIndex (
+    Simulation::Foams::iterator current, Simulation::Foams::iterator begin)
+{
+    return (current - begin) / sizeof *begin;
+}
+
+
+double GetPressureBody0 (const boost::shared_ptr<Foam>& foam)
+{
+    return foam->GetBody (0).GetScalarValue (
+        BodyScalar::PRESSURE);
+}
+
+void Simulation::adjustPressureSubtractReference ()
 {
     QtConcurrent::blockingMap (
 	m_foams.begin (), m_foams.end (),
-	boost::bind (&Foam::AccumulateProperty<Accumulator>, 
-		     _1, acc, property));
+	boost::bind (&Foam::SubtractFromPressure, _1, 
+		     boost::bind (GetPressureBody0, _1)));
 }
 
+/**
+ * Each body is read once, into a buffer for each time step. All
+ * statistics are computed from the buffers.
+ */
+void Simulation::calculateStatistics ()
+{
+    vector<FoamScalars> scalars;
+    {
+	BenchmarkPhase phase ("Simulation::gatherScalars");
+	scalars = QtConcurrent::blockingMapped< vector<FoamScalars> > (
+	    m_foams.begin (), m_foams.end (), gatherScalars);
+    }
+    vector<size_t> indexes;
+    for (size_t i = BodyScalar::PROPERTY_BEGIN; i < BodyScalar::COUNT; ++i)
+	indexes.push_back (i);
+    // statistics for all time-steps
+    QtConcurrent::blockingMap (
+	indexes.begin (), indexes.end (),
+	boost::bind (histogramAllTimeSteps, &m_histogramScalar, 
+		     boost::cref (scalars), _1));
+    // statistics per time-step
+    indexes.clear ();
+    for (size_t i = 0; i < m_foams.size (); ++i)
+	indexes.push_back (i);
+    QtConcurrent::blockingMap (
+	indexes.begin (), indexes.end (),
+	boost::bind (histogramsTimeStep, boost::cref (m_foams), 
+		     boost::cref (m_histogramScalar), boost::cref (scalars), 
+		     0, _1));
+    MinMaxStatistics minMaxStat;
+    BOOST_FOREACH (const FoamScalars& s, scalars)
+    {
+	s.m_deformationEigenValue.Accumulate (&minMaxStat);
+	s.m_property[BodyScalar::ACTUAL_VOLUME].Accumulate (
+	    &m_volumeStatistics);
+    }
+    m_maxDeformationEigenValue = acc::max (minMaxStat);
+    m_meanVolume = acc::mean (m_volumeStatistics);
+}
 
 void Simulation::calculateVelocityBody (
     pair< size_t, boost::shared_ptr<BodyAlongTime> > p)
@@ -458,17 +1223,17 @@ void Simulation::CacheBodiesAlongTime ()
 
 Dimension::Enum Simulation::GetDimension () const
 {
-    return GetFoam (0).GetDimension ();
+    return GetFoamSummary (0).GetDimension ();
 }
 
 bool Simulation::Is2D () const
 {
-    return GetFoam (0).Is2D ();
+    return GetFoamSummary (0).Is2D ();
 }
 
 bool Simulation::IsTorus () const
 {
-    return GetFoam (0).IsTorus ();
+    return GetFoamSummary (0).IsTorus ();
 }
 
 const Body& Simulation::GetBody (size_t bodyId, size_t timeStep) const
@@ -488,6 +1253,9 @@ string Simulation::ToString () const
     return ostr.str ();
 }
 
+/**
+ * The first and the last time step have to be resident (@see Pin).
+ */
 string Simulation::GetInfo () const
 {
     const Foam& firstFoam = GetFoam (0);
@@ -539,6 +1307,51 @@ string Simulation::GetInfo () const
     return ostr.str ();
 }
 
+void Simulation::GetMemoryUsage (
+    MemoryUsage* usage, vector<MemoryUsage>* timeSteps) const
+{
+    timeSteps->assign (m_foams.size (), MemoryUsage ());
+    // time steps with the same topology share it, count it once
+    set<const string*> topologies;
+    for (size_t i = 0; i < m_foams.size (); ++i)
+    {
+	MemoryUsage& timeStep = (*timeSteps)[i];
+	if (m_foams[i])
+	    m_foams[i]->GetMemoryUsage (&timeStep);
+	if (i < m_storedFoams.size () && m_storedFoams[i].IsStored ())
+	{
+	    const StoredFoam& stored = m_storedFoams[i];
+	    timeStep.Add (MemoryCategory::STORED_TIME_STEPS,
+			  stored.m_geometry.capacity ());
+	    if (topologies.insert (stored.m_topology.get ()).second)
+		timeStep.Add (MemoryCategory::STORED_TIME_STEPS,
+			      stored.m_topology->capacity ());
+	}
+	*usage += timeStep;
+    }
+    usage->Add (MemoryCategory::BODIES_ALONG_TIME, 
+		m_bodiesAlongTime.GetMemorySize ());
+    usage->Add (MemoryCategory::T1S, m_t1.GetMemorySize ());
+    BOOST_FOREACH (const HistogramStatistics& h, m_histogramScalar)
+	usage->Add (MemoryCategory::HISTOGRAMS, h.GetMemorySize ());
+}
+
+string Simulation::GetMemoryInfo (MemoryUsage* total) const
+{
+    MemoryUsage usage;
+    vector<MemoryUsage> timeSteps;
+    GetMemoryUsage (&usage, &timeSteps);
+    ostringstream ostr;
+    ostr << "Simulation " << GetName () << " (KB)" << endl;
+    MemoryUsage::PrintHeader (ostr, "time step");
+    for (size_t i = 0; i < timeSteps.size (); ++i)
+	timeSteps[i].PrintRow (ostr, QString::number (i).toStdString ());
+    usage.PrintRow (ostr, "simulation");
+    if (total != 0)
+	*total += usage;
+    return ostr.str ();
+}
+
 
 void Simulation::SetTimeSteps (size_t timeSteps)
 {
@@ -564,7 +1377,7 @@ void Simulation::GetTimeStepSelection (
 {
     for (size_t timeStep = 0; timeStep < GetTimeSteps (); ++timeStep)
     {
-	const Foam& foam = GetFoam (timeStep);
+	const Foam& foam = GetFoamSummary (timeStep);
 	if (valueInterval.intersects (foam.GetIntervalScalar (property))
 	    && foam.ExistsBodyWithValueIn (property, valueInterval))
 	    (*timeStepSelection)[timeStep] = true;
@@ -573,7 +1386,7 @@ void Simulation::GetTimeStepSelection (
 
 bool Simulation::IsQuadratic () const
 {
-    return m_foams[0]->IsQuadratic ();
+    return GetFoamSummary (0).IsQuadratic ();
 }
 
 size_t Simulation::GetMaxCountPerBinIndividual (
@@ -583,31 +1396,24 @@ size_t Simulation::GetMaxCountPerBinIndividual (
     size_t max = 0;
     for (size_t i = 0; i < size; ++i)
 	max = std::max (
-	    max, GetFoam (i).GetHistogramScalar (property).GetMaxCountPerBin ());
+	    max, GetFoamSummary (i).GetHistogramScalar (
+		property).GetMaxCountPerBin ());
     return max;
 }
 
 bool Simulation::IsT1Available () const
 {
-    BOOST_FOREACH (const vector<T1> tc, m_t1)
-	if (tc.size () != 0)
-	    return true;
-    return false;
+    return m_t1.GetCount () != 0;
 }
 
 size_t Simulation::GetT1TimeSteps () const
 {
-    return m_t1.size ();
+    return m_t1.GetTimeSteps ();
 }
 
 size_t Simulation::GetT1CountAllTimeSteps () const
 {
-    size_t size = 0;
-    BOOST_FOREACH (const vector<T1>& tc, m_t1)
-    {
-	size += tc.size ();
-    }
-    return size;
+    return m_t1.GetCount ();
 }
 /**
  * @todo Return the real value here. It would work if clamping would not
@@ -618,9 +1424,9 @@ size_t Simulation::GetMaxT1CountPerTimeStep () const
     return 1;
 /*
     size_t maxCount = 0;
-    BOOST_FOREACH (const vector<T1>& tc, m_t1)
+    for (size_t i = 0; i < m_t1.GetTimeSteps (); ++i)
     {
-	maxCount = max (maxCount, tc.size ());
+	maxCount = max (maxCount, m_t1.Get (i).size ());
     }
     return maxCount;
 */
@@ -630,98 +1436,71 @@ size_t Simulation::GetMaxT1CountPerTimeStep () const
 void Simulation::ParseT1s (
     const char* arrayName, const char* countName)
 {
-    if (! m_t1.empty ())
+    if (! m_t1.IsEmpty ())
         return;
     cdbg << "Parsing topological changes..." << endl;
+    parseT1s (arrayName, countName, 0, GetFoams ().size ());
+}
+
+/**
+ * Reads T1s stored in variables for time steps [begin, end).
+ * @return false if the variables are not in the DMP files
+ */
+bool Simulation::parseT1s (
+    const char* arrayName, const char* countName, size_t begin, size_t end)
+{
     Foams& foams = GetFoams ();
-    m_t1.resize (foams.size () - 1);
-    for (size_t i = 1; i < foams.size (); ++i)
+    vector<T1> t1s;
+    for (size_t i = max (begin, size_t (1)); i < end; ++i)
     {
         boost::shared_ptr<Foam> foam = foams[i];
         // in the file: first time step is 1 and T1s occur before timeStep
         // in memory: first time step is 0 and T1s occur after timeStep
+        t1s.clear ();
         if (! foam->GetParsingData ().GetT1 (
-                arrayName, countName, &m_t1[i - 1], 
-                foams[0]->Is2D ()))
+                arrayName, countName, &t1s, foams[0]->Is2D ()))
         {
-            m_t1.resize (0);
+            m_t1.Clear ();
             RuntimeAssert (
                 i == 1, "ParseT1s: T1s variables not set at index ", i);
-            return;
+            return false;
         }
+        m_t1.PushBack (t1s);
     }
+    m_t1sInDmp = true;
+    return true;
 }
 
 void Simulation::ParseT1s (
     const string& fileName, size_t ticksForTimeStep, bool t1sShiftLower)
 {
     cdbg << "Parsing topological changes ... ";
-    const size_t LINE_LENGTH = 256;
-    ifstream in;
-    in.open (fileName.c_str ());
-    if (! in)
-	ThrowException ("Cannot open \"" + fileName + "\"");
-    in.exceptions (ios::badbit);
-    float timeStep;
-    float x, y, z;
-    size_t type;
-    while (! in.eof ())
-    {
-        char line[LINE_LENGTH + 1];
-	if (in.peek () == '#')
-	{
-	    in.ignore (LINE_LENGTH, '\n');
-	    continue;
-	}
-        in.getline (line, sizeof (line));
-        if (in.fail ())
-            // empty line
-            continue;
-        istringstream inLine;
-        inLine.str (line);
-        inLine >> ws;
-        if (inLine.eof ())
-            // ignore empty lines
-            continue;
-	inLine >> timeStep >> x >> y;
-        RuntimeAssert (! inLine.fail (), "Invalid topological changes file");
-        inLine >> z >> type;
-        T1 tc;
-        if (inLine.fail ())
-            tc = T1 (
-                G3D::Vector3 (x, y, Foam::Z_COORDINATE_2D), 
-                T1Type::POP_VERTEX);
-        else
-            tc = T1 (G3D::Vector3 (x, y, z), 
-                                    T1Type::FromSizeT (type - 1));
-	timeStep /= ticksForTimeStep;
-	// in the file: first time step is 1 and T1s occur before timeStep
-	// in memory: first time step is 0 and T1s occur after timeStep
-	timeStep -= 1;
-	if (timeStep >= m_t1.size ())
-	    m_t1.resize (timeStep + 1);
-	m_t1[timeStep].push_back (tc);
+    BenchmarkPhase benchmarkPhase ("Simulation::ParseT1s");
+    if (Benchmark::Get ().IsEnabled ())
+	benchmarkPhase.SetBytes (QFileInfo (fileName.c_str ()).size ());
+    if (! IsSnapshotUsed () || ! m_t1.ReadIndex (fileName, ticksForTimeStep))
+    {
+	m_t1.Read (fileName, ticksForTimeStep);
+	if (IsSnapshotUsed ())
+	    m_t1.WriteIndex (fileName, ticksForTimeStep);
     }
     m_t1Shift = (t1sShiftLower ? 1 : 0);
-    cdbg << "last topological change timestep: " << timeStep << endl;
+    cdbg << "last topological change timestep: " 
+	 << int (m_t1.GetTimeSteps ()) - 1 << endl;
 }
 
-const vector<T1>& Simulation::GetT1 (
+T1TimeSteps::ConstRange Simulation::GetT1 (
     size_t timeStep, int t1sShift) const
 {
     int t = int(timeStep) + t1sShift;
-    if (t < 0 || size_t (t) >= m_t1.size ())
-	return NO_T1S;
-    else
-	return m_t1[t];
+    // an out of range time step returns no T1s
+    return m_t1.Get (t < 0 ? m_t1.GetTimeSteps () : size_t (t));
 }
 
 vtkSmartPointer<vtkPolyData> Simulation::GetT1Vtk (
     size_t timeStep, int t1sShift) const
 {
-    int t = int(timeStep) + t1sShift;
-    const vector<T1>& t1s = (t < 0 || size_t (t) >= m_t1.size ()) ? 
-        vector<T1> () : m_t1[t];
+    T1TimeSteps::ConstRange t1s = GetT1 (timeStep, t1sShift);
 
     VTK_CREATE (vtkPolyData, t1sVtk);
     VTK_CREATE (vtkPoints, points);
@@ -746,7 +1525,7 @@ vtkSmartPointer<vtkPolyData> Simulation::GetT1Vtk (
 
 string Simulation::GetT1Info (size_t timeStep, int t1sShift) const
 {
-    const vector<T1>& t1s = GetT1 (timeStep, t1sShift);
+    T1TimeSteps::ConstRange t1s = GetT1 (timeStep, t1sShift);
     ostringstream ostr;
     ostr << "t1 count: " << t1s.size () << endl;
     BOOST_FOREACH (T1 t1, t1s)
@@ -782,6 +1561,39 @@ vtkSmartPointer<vtkImageData> Simulation::GetT1KDE (
 }
 
 
+void Simulation::getDmpFiles (const vector<string>& fileNames,
+			      QDir* dir, QStringList* files)
+{
+    QFileInfo fileInfo (fileNames[0].c_str ());
+    *dir = fileInfo.absoluteDir ();
+    if (! dir->exists ())
+	ThrowException ("Directory does not exist: \"" + 
+			dir->path ().toStdString () + "\"");
+    BOOST_FOREACH (const string& fn, fileNames)
+	*files << QFileInfo(fn.c_str ()).fileName ();
+    if (files->size () == 0)
+	ThrowException (
+	    "No files match: \"" + 
+	    fileInfo.filePath ().toStdString () + "\"");
+}
+
+void Simulation::ScanDMPs (
+    const vector<string>& fileNames,
+    bool useOriginal,
+    const DmpObjectInfo& dmpObjectInfo,
+    const vector<ForceNamesOneObject>& forceNames)
+{
+    QDir dir;
+    QStringList files;
+    getDmpFiles (fileNames, &dir, &files);
+    BenchmarkPhase benchmarkPhase ("Simulation::ScanDMPs");
+    benchmarkPhase.SetBytes (filesSize (dir, files));
+    QtConcurrent::blockingMap (
+	files, boost::bind (scanDMP, dir.absolutePath ().toStdString (),
+			    useOriginal, boost::cref (dmpObjectInfo), 
+			    boost::cref (forceNames), _1));
+}
+
 void Simulation::ParseDMPs (
     const vector<string>& fileNames,
     bool useOriginal,
@@ -795,37 +1607,385 @@ void Simulation::ParseDMPs (
     m_dmpObjectInfo = dmpObjectInfo;
     m_forceNames.resize (forceNames.size ());
     copy (forceNames.begin (), forceNames.end (), m_forceNames.begin ());
-    QFileInfo fileInfo (fileNames[0].c_str ());
-    dir = fileInfo.absoluteDir ();
-    if (! dir.exists ())
-	ThrowException ("Directory does not exist: \"" + 
-			dir.path ().toStdString () + "\"");
-    BOOST_FOREACH (const string& fn, fileNames)
-	files << QFileInfo(fn.c_str ()).fileName ();
-    if (files.size () == 0)
-	ThrowException (
-	    "No files match: \"" + 
-	    fileInfo.filePath ().toStdString () + "\"");
-
+    getDmpFiles (fileNames, &dir, &files);
     SetTimeSteps (files.size ());
-    // DataProperties are shared between all Foams
-    GetFoams ()[0] = ParseDMP (
-	dir.absolutePath (), GetDmpObjectInfo (),
-	GetForcesNames (), OriginalUsed (), GetDataProperties (),
-	Foam::SET_DATA_PROPERTIES, GetRegularGridResolution (),
-	debugParsing, debugScanning) (*files.begin ());
-    QList< boost::shared_ptr<Foam> > foams = QtConcurrent::blockingMapped 
+    m_dmpDir = dir.absolutePath ();
+    m_dmpFiles = files;
+    BenchmarkPhase benchmarkPhase ("Simulation::ParseDMPs");
+    if (Benchmark::Get ().IsEnabled ())
+	benchmarkPhase.SetBytes (filesSize (dir, files));
+    QElapsedTimer timer;
+    timer.start ();
+    if (GetResidentTimeSteps () >= size_t (files.size ()))
+	m_residentTimeSteps = 0;
+    size_t window = (GetResidentTimeSteps () != 0) ? 
+	GetResidentTimeSteps () : GetInFlightTimeSteps ();
+    if (window == 0)
+	window = files.size ();
+    bool t1sInDmp = m_t1.IsEmpty ();
+    bool t1sParsed = t1sInDmp;
+    m_foamsPreprocessed = true;
+    for (size_t begin = 0, end; begin < size_t (files.size ()); begin = end)
+    {
+	end = min (begin + window, size_t (files.size ()));
+	bool preprocessed;
+	// stored foams are saved before they are preprocessed
+	if (begin != 0 && m_foamsPreprocessed && 
+	    ! (GetResidentTimeSteps () != 0 && IsTopologyShared ()))
+	    preprocessed = parsePreprocess (begin, end, &t1sParsed, 
+					    debugParsing, debugScanning);
+	else
+	{
+	    // the first files are parsed before the DataProperties are known
+	    Foam::ParametersOperation parametersOperation = (begin == 0) ?
+		Foam::OWN_DATA_PROPERTIES : Foam::TEST_DATA_PROPERTIES;
+	    QList< boost::shared_ptr<Foam> > foams = 
+		QtConcurrent::blockingMapped 
+		< QList < boost::shared_ptr<Foam> > > (
+		    files.begin () + begin, files.begin () + end,
+		    ParseDMP (	
+			dir.absolutePath (), GetDmpObjectInfo (),
+			GetForcesNames (), GetLoadAttributes (), 
+			OriginalUsed (), GetDataProperties (),
+			parametersOperation, GetRegularGridResolution (),
+			IsSnapshotUsed (), IsDmpMemoryMapped (),
+			IsDmpParallelSections (), IsElementArenaUsed (),
+			debugParsing, debugScanning));
+	    if (count_if (foams.constBegin (), foams.constEnd (),
+			  bl::_1 != boost::shared_ptr<Foam>()) != foams.size ())
+		ThrowException ("Could not process all files\n");
+	    copy (foams.constBegin (), foams.constEnd (), 
+		  GetFoams ().begin () + begin);
+	    if (begin == 0)
+		shareDataProperties (end, debugParsing, debugScanning);
+	    preprocessed = ! m_foamsPreprocessed || 
+		preprocessParsed (begin, end, &t1sParsed);
+	}
+	if (! preprocessed)
+	{
+	    // a time step loaded again would not have its points fixed
+	    cdbg << "Constraint points are fixed using the previous "
+		"time step, all time steps are parsed before they are "
+		"preprocessed and stay in memory" << endl;
+	    m_residentTimeSteps = 0;
+	    m_foamsPreprocessed = false;
+	    m_storedFoams.clear ();
+	    if (t1sInDmp)
+		m_t1.Clear ();
+	    t1sParsed = t1sInDmp;
+	    window = files.size ();
+	    // parse the time steps already released again
+	    if (begin != 0)
+		end = 0;
+	}
+    }
+    printParseThroughput (dir, files, timer.elapsed ());
+}
+
+/**
+ * DataProperties are shared between all Foams and they are the ones
+ * found in the first time step. Time steps in [1, end) that found
+ * different properties are parsed again, testing against the shared
+ * properties. This fails if the file has different properties, but
+ * not if it just does not declare them.
+ */
+void Simulation::shareDataProperties (
+    size_t end, bool debugParsing, bool debugScanning)
+{
+    m_dataProperties = GetFoamSummary (0).GetDataProperties ();
+    ParseDMP parseDMP (
+	m_dmpDir, GetDmpObjectInfo (),
+	GetForcesNames (), GetLoadAttributes (), OriginalUsed (),
+	GetDataProperties (),
+	Foam::TEST_DATA_PROPERTIES, GetRegularGridResolution (),
+	IsSnapshotUsed (), IsDmpMemoryMapped (), IsDmpParallelSections (),
+	IsElementArenaUsed (), debugParsing, debugScanning);
+    for (size_t i = 0; i < end; ++i)
+    {
+	if (m_foams[i]->GetDataProperties () == m_dataProperties)
+	    m_foams[i]->SetDataProperties (&m_dataProperties);
+	else
+	    m_foams[i] = parseDMP (m_dmpFiles[i]);
+    }
+}
+
+/**
+ * The new time steps are parsed and preprocessed apart from the
+ * simulation. They are added to it only after every step that can
+ * fail succeeded, so a failure leaves the simulation as it was and the
+ * same files are appended by the next call.
+ */
+size_t Simulation::AppendDMPs ()
+{
+    QStringList files = findNewDmpFiles ();
+    if (files.empty ())
+	return 0;
+    size_t begin = m_foams.size ();
+    size_t end = begin + files.size ();
+    cdbg << "Appending " << files.size () << " time steps ..." << endl;
+    QList< boost::shared_ptr<Foam> > parsed = QtConcurrent::blockingMapped 
 	< QList < boost::shared_ptr<Foam> > > (
-	    files.begin () + 1, files.end (),
-	    ParseDMP (	
-		dir.absolutePath (), GetDmpObjectInfo (),
-		GetForcesNames (), OriginalUsed (), GetDataProperties (),
+	    files.begin (), files.end (),
+	    ParseDMP (
+		m_dmpDir, GetDmpObjectInfo (),
+		GetForcesNames (), GetLoadAttributes (), OriginalUsed (),
+		GetDataProperties (),
 		Foam::TEST_DATA_PROPERTIES, GetRegularGridResolution (),
-                debugParsing, debugScanning));
-    if (count_if (foams.constBegin (), foams.constEnd (),
-		  bl::_1 != boost::shared_ptr<Foam>()) != foams.size ())
+		IsSnapshotUsed (), IsDmpMemoryMapped (),
+		IsDmpParallelSections (), IsElementArenaUsed ()));
+    if (count_if (parsed.constBegin (), parsed.constEnd (),
+		  bl::_1 != boost::shared_ptr<Foam>()) != parsed.size ())
 	ThrowException ("Could not process all files\n");
-    copy (foams.constBegin (), foams.constEnd (), GetFoams ().begin () + 1);
+    Foams foams (parsed.constBegin (), parsed.constEnd ());
+    for (size_t i = 0; i < foams.size (); ++i)
+	if (foams[i]->HasConstraintPointsToFix ())
+	{
+	    if (i == 0)
+	    {
+		boost::shared_ptr<TimeStepPin> previous = Pin (begin - 1);
+		foams[i]->FixConstraintPoints (&GetFoam (begin - 1));
+	    }
+	    else
+		foams[i]->FixConstraintPoints (foams[i - 1].get ());
+	}
+    vector< vector<T1> > t1s (m_t1sInDmp ? foams.size () : 0);
+    for (size_t i = 0; i < t1s.size (); ++i)
+    {
+	char found;
+	readT1s (foams[i].get (), Is2D (), &t1s[i], &found);
+	if (! found)
+	    ThrowException ("AppendDMPs: T1s variables not set in ",
+			    files[i].toStdString ());
+    }
+    vector<StoredFoam> stored;
+    if (GetResidentTimeSteps () != 0 && IsTopologyShared ())
+    {
+	stored.resize (foams.size ());
+	storeFoams (foams, &stored[0]);
+    }
+    vector<FoamParamMethod> methods = getPreprocessMethods ();
+    methods.push_back (boost::bind (&Foam::CalculateMinMaxStatistics, _1));
+    mapPerFoam (foams.begin (), foams.end (), &methods[0], methods.size ());
+
+    // add the new time steps to the simulation
+    m_foams.insert (m_foams.end (), foams.begin (), foams.end ());
+    m_dmpFiles << files;
+    appendT1s (t1s);
+    if (! stored.empty ())
+    {
+	m_storedFoams.resize (begin);
+	m_storedFoams.insert (m_storedFoams.end (), 
+			      stored.begin (), stored.end ());
+	shareTopology (begin, end);
+    }
+    for (size_t i = begin; i < end; ++i)
+    {
+	const Foam& foam = *m_foams[i];
+	m_boundingBox.merge (foam.GetBoundingBox ());
+	m_boundingBoxTorus.merge (foam.GetBoundingBoxTorus ());
+	BOOST_FOREACH (const boost::shared_ptr<Body>& body, foam.GetBodies ())
+	{
+	    m_bodiesAlongTime.CacheBody (body, i, end);
+	    BodyAlongTime& bat = 
+		m_bodiesAlongTime.GetBodyAlongTime (body->GetId ());
+	    bat.CalculateBodyWraps (*this, i - 1);
+	    appendVelocity (&bat, i);
+	}
+    }
+    // the velocity of the previous last time step changed as well
+    FoamParamMethod f = boost::bind (&Foam::CalculateMinMaxStatistics, _1);
+    mapPerFoam (m_foams.begin () + begin - 1, m_foams.end (), &f, 1);
+    if (Is3D () && GetRegularGridResolution () != 0)
+    {
+	f = boost::bind (
+	    &Foam::SaveRegularGrid, _1, 
+	    GetRegularGridResolution (), GetBoundingBoxAllTimeSteps ());
+	mapPerFoam (m_foams.begin () + begin, m_foams.end (), &f, 1);
+    }
+    // after the regular grids are saved, as in Preprocess: the grid
+    // pressures are adjusted when the grid is read
+    bool shifted = false;
+    if (m_pressureAdjusted && ! GetFoamSummary (0).HasFreeFace ())
+	shifted = alignAppendedPressures (begin, end);
+    appendStatistics (begin, end, shifted);
+    releaseGeometry (begin, end);
+    return files.size ();
+}
+
+/**
+ * Aligns the pressures of the time steps [begin, end) the way
+ * Preprocess does: the minimum pressure is subtracted and the median
+ * is aligned with the max median of all time steps. If an appended
+ * time step has a larger median, the time steps before begin are
+ * shifted by the difference between the two max medians.
+ * @return true if the time steps before begin were shifted
+ */
+bool Simulation::alignAppendedPressures (size_t begin, size_t end)
+{
+    vector<double> medians (end - begin);
+    for (size_t i = begin; i < end; ++i)
+	pressureMedianAboveMin (m_foams[i].get (), &medians[i - begin]);
+    double maxMedian;
+    maxPressureMedian (medians, &maxMedian);
+    bool shifted = false;
+    if (maxMedian > m_maxPressureMedian)
+    {
+	for (size_t i = 0; i < begin; ++i)
+	    m_foams[i]->SubtractFromPressure (m_maxPressureMedian - maxMedian);
+	m_maxPressureMedian = maxMedian;
+	shifted = true;
+    }
+    for (size_t i = begin; i < end; ++i)
+	alignPressureMedian (m_foams[i].get (), &medians[i - begin], 
+			     &m_maxPressureMedian);
+    return shifted;
+}
+
+/**
+ * New DMP files have the name of the last file loaded with the digits
+ * replaced by question marks and sort after it. We stop at the first
+ * file that changed size since the previous call.
+ */
+QStringList Simulation::findNewDmpFiles ()
+{
+    const QString& last = m_dmpFiles.last ();
+    QString pattern = last;
+    pattern.replace (QRegExp ("[0-9]"), "?");
+    QDir dir (m_dmpDir);
+    QStringList candidates = 
+	dir.entryList (QStringList () << pattern, QDir::Files, QDir::Name);
+    QStringList files;
+    map<QString, qint64> sizes;
+    bool waiting = false;
+    BOOST_FOREACH (const QString& file, candidates)
+    {
+	if (file <= last)
+	    continue;
+	qint64 size = QFileInfo (dir, file).size ();
+	map<QString, qint64>::const_iterator it = m_newDmpSizes.find (file);
+	if (! waiting && size != 0 && 
+	    it != m_newDmpSizes.end () && it->second == size)
+	    files << file;
+	else
+	{
+	    waiting = true;
+	    sizes[file] = size;
+	}
+    }
+    m_newDmpSizes.swap (sizes);
+    return files;
+}
+
+/**
+ * Adds the T1s read from the DMP files of the time steps that were
+ * just appended.
+ */
+void Simulation::appendT1s (const vector< vector<T1> >& t1s)
+{
+    for (size_t i = 0; i < t1s.size (); ++i)
+    {
+	m_t1.PushBack (t1s[i]);
+	// T1s occur after the time step in memory
+	size_t timeStep = m_t1.GetTimeSteps () - 1;
+	BOOST_FOREACH (T1& t1, m_t1.Get (timeStep))
+	{
+	    if (IsTorus () && Is3D ())
+		moveInsideOriginalDomain (
+		    &t1, m_foams[timeStep]->GetTorusDomain ());
+	    ++m_t1TypeCount[t1.GetType ()];
+	}
+    }
+}
+
+/**
+ * Sets the velocity for a body that moved from timeStep - 1 to
+ * timeStep, the last time step, as calculateVelocity does.
+ */
+void Simulation::appendVelocity (BodyAlongTime* bat, size_t timeStep)
+{
+    if (bat->GetTimeBegin () >= timeStep || bat->GetTimeEnd () != timeStep + 1)
+	return;
+    const boost::shared_ptr<Body>& begin = bat->GetBody (timeStep - 1);
+    const boost::shared_ptr<Body>& end = bat->GetBody (timeStep);
+    G3D::Vector3 endPoint = end->GetCenter ();
+    size_t wraps = bat->GetWrapSize ();
+    if (wraps != 0 && bat->GetWrap (wraps - 1) == timeStep - 1)
+	endPoint = GetFoamSummary (timeStep).GetTorusDomain ().TorusTranslate (
+	    endPoint, Vector3int16Zero - bat->GetTranslation (wraps - 1));
+    G3D::Vector3 velocity = endPoint - begin->GetCenter ();
+    begin->SetVelocity (velocity);
+    end->SetVelocity (velocity);
+}
+
+/**
+ * Updates the statistics after the time steps [begin, end) were
+ * appended. The range of each property is taken from the range of
+ * each new time step and of the time step before them, whose
+ * velocities changed. If it stays inside the range of the histograms
+ * for all time steps, only the new values are added to them and only
+ * the histograms of [begin - 1, end) are calculated. The old values
+ * of the velocities of time step begin - 1 stay in the histograms for
+ * all time steps. Otherwise, or if the pressures of the time steps
+ * before begin were shifted, all statistics are calculated again.
+ * @param shifted the pressures of the time steps before begin changed
+ */
+void Simulation::appendStatistics (size_t begin, size_t end, bool shifted)
+{
+    bool rangeGrows = shifted;
+    for (size_t i = BodyScalar::PROPERTY_BEGIN; i < BodyScalar::COUNT; ++i)
+    {
+	BodyScalar::Enum property = BodyScalar::FromSizeT (i);
+	for (size_t j = begin - 1; j < end; ++j)
+	    if (m_foams[j]->GetMinScalar (property) < GetMinScalar (property) ||
+		m_foams[j]->GetMaxScalar (property) > GetMaxScalar (property))
+		rangeGrows = true;
+    }
+    if (rangeGrows)
+    {
+	m_histogramScalar.assign (
+	    BodyScalar::COUNT, HistogramStatistics (HISTOGRAM_INTERVALS));
+	m_volumeStatistics = MeanStatistics ();
+	calculateStatistics ();
+	return;
+    }
+    size_t first = begin - 1;
+    vector<FoamScalars> scalars = 
+	QtConcurrent::blockingMapped< vector<FoamScalars> > (
+	    m_foams.begin () + first, m_foams.begin () + end, gatherScalars);
+    for (size_t i = BodyScalar::PROPERTY_BEGIN; i < BodyScalar::COUNT; ++i)
+	for (size_t j = begin; j < end; ++j)
+	    scalars[j - first].m_property[i].Accumulate (&m_histogramScalar[i]);
+    vector<size_t> indexes;
+    for (size_t i = first; i < end; ++i)
+	indexes.push_back (i);
+    QtConcurrent::blockingMap (
+	indexes.begin (), indexes.end (),
+	boost::bind (histogramsTimeStep, boost::cref (m_foams), 
+		     boost::cref (m_histogramScalar), boost::cref (scalars), 
+		     first, _1));
+    MinMaxStatistics minMaxStat;
+    minMaxStat (m_maxDeformationEigenValue);
+    for (size_t i = begin; i < end; ++i)
+    {
+	scalars[i - first].m_deformationEigenValue.Accumulate (&minMaxStat);
+	scalars[i - first].m_property[BodyScalar::ACTUAL_VOLUME].Accumulate (
+	    &m_volumeStatistics);
+    }
+    m_maxDeformationEigenValue = acc::max (minMaxStat);
+    m_meanVolume = acc::mean (m_volumeStatistics);
+}
+
+void Simulation::printParseThroughput (
+    const QDir& dir, const QStringList& files, qint64 elapsedMs) const
+{
+    double mb = filesSize (dir, files) / (1024.0 * 1024.0);
+    double seconds = max (elapsedMs, qint64 (1)) / 1000.0;
+    ostringstream ostr;
+    ostr << "Loaded " << files.size () << " DMP files, " 
+	 << setprecision (3) << mb << " MB in " << seconds << " s: "
+	 << mb / seconds << " MB/s (" 
+	 << (IsDmpMemoryMapped () ? "mmap" : "stdio") << ")" << endl;
+    cdbg << ostr.str ();
 }
 
 float Simulation::GetBubbleDiameter () const
@@ -854,12 +2014,8 @@ void Simulation::calculateT1TypeCount ()
     boost::array<
     acc::accumulator_set<size_t, acc::features<acc::tag::count> >, 
         T1Type::COUNT> a;
-    for (size_t i = 0; i < m_t1.size (); ++i)
-        for (size_t j = 0; j < m_t1[i].size (); ++j)
-        {
-            T1 t1 = m_t1[i][j];
-            a[t1.GetType ()] (1);
-        }
+    BOOST_FOREACH (const T1& t1, m_t1.GetAll ())
+        a[t1.GetType ()] (1);
     for (size_t i = 0; i < a.size (); ++i)
         m_t1TypeCount[i] = acc::count (a[i]);
 }
@@ -877,6 +2033,19 @@ string SimulationGroup::ToString () const
     return ostr.str ();
 }
 
+string SimulationGroup::GetMemoryInfo () const
+{
+    ostringstream ostr;
+    MemoryUsage usage;
+    BOOST_FOREACH (const Simulation& simulation, m_simulation)
+	ostr << simulation.GetMemoryInfo (&usage) << endl;
+    ostr << "All simulations" << endl;
+    usage.Print (ostr);
+    ostr << endl << "Peak and change in resident set size for each phase" << endl;
+    Benchmark::Get ().PrintRss (ostr);
+    return ostr.str ();
+}
+
 float SimulationGroup::GetBubbleDiameter () const
 {
     acc::accumulator_set<float, acc::features<acc::tag::min> > a;
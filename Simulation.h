@@ -89,14 +89,17 @@ while (no more items in the queue)
 #include "Comparisons.h"
 #include "DataProperties.h"
 #include "HistogramStatistics.h"
+#include "MemoryUsage.h"
 #include "ObjectPosition.h"
 #include "ForceOneObject.h"
+#include "FoamSnapshot.h"
 #include "Utils.h"
-#include "T1.h"
+#include "T1TimeSteps.h"
 
 class Foam;
 class OOBox;
 class Settings;
+class TimeStepPin;
 
 /**
  * @brief Data for all time-steps in a foam simulation.
@@ -158,15 +161,36 @@ public:
     
     const Body& GetBody (size_t bodyId, size_t timeStep) const;
     /**
-     * Gets the vector of Foam objects
-     * @return vector of data objects
+     * Gets a time step with its geometry. If not all time steps are
+     * resident (@see SetResidentTimeSteps), the caller has to hold a
+     * Pin for timeStep.
      */
     Foam& GetFoam (size_t timeStep)
     {
+	assertResident (timeStep);
 	return *m_foams[timeStep];
     }
-
     const Foam& GetFoam (size_t timeStep) const
+    {
+	assertResident (timeStep);
+	return *m_foams[timeStep];
+    }
+    /**
+     * Loads the geometry of timeStep if it is not resident and keeps it
+     * in memory while the returned pin exists. Pinned time steps are
+     * not released even if there are more of them than
+     * GetResidentTimeSteps (). Thread safe.
+     */
+    boost::shared_ptr<TimeStepPin> Pin (size_t timeStep);
+    bool IsResident (size_t timeStep) const;
+    /**
+     * Gets a time step without loading its geometry if it is not
+     * resident (@see SetResidentTimeSteps). The bodies (with their
+     * centers and scalar values), the bounding box, the torus domain and
+     * the statistics of the time step can be used, the vertices, edges
+     * and faces might be missing.
+     */
+    const Foam& GetFoamSummary (size_t timeStep) const
     {
 	return *m_foams[timeStep];
     }
@@ -244,6 +268,21 @@ public:
     void SetTimeSteps (size_t timeSteps);
     string ToString () const;
     string GetInfo () const;
+    /**
+     * Bytes used by this simulation.
+     * @param usage bytes used by all time steps and by the data shared
+     *        between time steps
+     * @param timeSteps bytes used by each time step
+     */
+    void GetMemoryUsage (
+	MemoryUsage* usage, vector<MemoryUsage>* timeSteps) const;
+    /**
+     * @param total if not null, the bytes used by this simulation are
+     *        added to it
+     * @return a table with the KB used by each time step followed by
+     *         the totals for the simulation
+     */
+    string GetMemoryInfo (MemoryUsage* total = 0) const;
     void SetPressureAdjusted (bool adjustPressure)
     {
 	m_pressureAdjusted = adjustPressure;
@@ -270,6 +309,26 @@ public:
 		    const DmpObjectInfo& dmpObjectInfo,
 		    const vector<ForceNamesOneObject>& forceNames,
 		    bool debugParsing, bool debugScanning);
+    /**
+     * Runs only the scanner over the DMP files and records a scan
+     * phase for each one (@see Benchmark). The simulation is not loaded.
+     */
+    static void ScanDMPs (const vector<string>& fileNames,
+			  bool useOriginal,
+			  const DmpObjectInfo& dmpObjectInfo,
+			  const vector<ForceNamesOneObject>& forceNames);
+    /**
+     * Adds to the simulation the DMP files written in its directory
+     * after it was loaded, for instance by a Surface Evolver job that
+     * is still running. Only new files that have the same name pattern
+     * as the last file loaded, sort after it and have the same size as
+     * in the previous call are added, so a file that is still being
+     * written is added at a later call. Only the new time steps are
+     * parsed and preprocessed, the data for all time steps is updated
+     * incrementally.
+     * @return the number of time steps added
+     */
+    size_t AppendDMPs ();
     DataProperties* GetDataProperties ()
     {
 	return &m_dataProperties;
@@ -296,6 +355,114 @@ public:
 	return m_regularGridResolution;
     }
     void SetRegularGridResolution (size_t resolution);
+    /**
+     * Parsed time steps are cached in a binary snapshot
+     * (@see FoamSnapshot) unless this is turned off.
+     */
+    bool IsSnapshotUsed () const
+    {
+	return m_snapshotUsed;
+    }
+    void SetSnapshotUsed (bool snapshotUsed)
+    {
+	m_snapshotUsed = snapshotUsed;
+    }
+    /**
+     * DMP files are scanned from a memory mapping unless this is
+     * turned off, in which case they are read through stdio.
+     */
+    bool IsDmpMemoryMapped () const
+    {
+	return m_dmpMemoryMapped;
+    }
+    void SetDmpMemoryMapped (bool memoryMapped)
+    {
+	m_dmpMemoryMapped = memoryMapped;
+    }
+    /**
+     * The element sections of a memory mapped DMP file are parsed in
+     * parallel unless this is turned off.
+     */
+    bool IsDmpParallelSections () const
+    {
+	return m_dmpParallelSections;
+    }
+    void SetDmpParallelSections (bool parallelSections)
+    {
+	m_dmpParallelSections = parallelSections;
+    }
+    /**
+     * If this is set, each time step allocates its vertices, edges
+     * and faces from its own arena (@see Foam::CreateArena), which
+     * is freed in one piece when the time step is released.
+     */
+    bool IsElementArenaUsed () const
+    {
+	return m_elementArenaUsed;
+    }
+    void SetElementArenaUsed (bool elementArenaUsed)
+    {
+	m_elementArenaUsed = elementArenaUsed;
+    }
+    /**
+     * User defined attributes (DEFINE ... ATTRIBUTE) stored in the
+     * elements. Values of the other user defined attributes are
+     * skipped by the parser.
+     */
+    const vector<string>& GetLoadAttributes () const
+    {
+	return m_loadAttributes;
+    }
+    void SetLoadAttributes (const vector<string>& loadAttributes)
+    {
+	m_loadAttributes = loadAttributes;
+    }
+    /**
+     * By default all time steps are kept in memory. If this is not 0,
+     * only that many time steps keep their vertices, edges and faces,
+     * the others keep only a summary (@see Foam::ReleaseGeometry) and
+     * are read again from the DMP file, or its snapshot, when they are
+     * pinned (@see Pin). The unpinned time step used least recently is
+     * released first.
+     */
+    size_t GetResidentTimeSteps () const
+    {
+	return m_residentTimeSteps;
+    }
+    void SetResidentTimeSteps (size_t timeSteps);
+    /**
+     * ParseDMPs parses this many DMP files at a time and runs on
+     * each one the steps Preprocess applies to each time step, which
+     * free its parsing data (@see Foam::ReleaseParsingData). If this
+     * is 0, all DMP files are parsed before they are preprocessed.
+     * Ignored if there are resident time steps, which use their
+     * number instead.
+     */
+    size_t GetInFlightTimeSteps () const
+    {
+	return m_inFlightTimeSteps;
+    }
+    void SetInFlightTimeSteps (size_t timeSteps)
+    {
+	m_inFlightTimeSteps = timeSteps;
+    }
+    /**
+     * If this is set, time steps that are not resident are kept in
+     * memory as their topology and geometry (@see FoamSnapshot::Store)
+     * and they are rebuilt from memory instead of being read again
+     * from the DMP file. A time step with the same topology as the
+     * previous time step shares it, so it stores only its own vertex
+     * positions and attributes. Used only if there are resident time
+     * steps.
+     */
+    bool IsTopologyShared () const
+    {
+	return m_topologyShared;
+    }
+    void SetTopologyShared (bool topologyShared)
+    {
+	m_topologyShared = topologyShared;
+    }
     static string GetBaseCacheDir ();
     string GetCacheDir () const;
     boost::array<int, 6> GetExtentResolution () const;
@@ -310,7 +477,7 @@ public:
     {
 	return m_t1Shift == 1;
     }
-    const vector<T1>& GetT1 (size_t timeStep, int t1sShift) const;
+    T1TimeSteps::ConstRange GetT1 (size_t timeStep, int t1sShift) const;
     vtkSmartPointer<vtkPolyData> GetT1Vtk (size_t timeStep, int t1sShift) const;
     const char* GetT1VtkName () const
     {
@@ -340,8 +507,29 @@ public:
 
 private:
     void MapPerFoam (FoamParamMethod* foamMethods, size_t n);
-    void fixConstraintPoints ();
-    void adjustPressureAlignMedians ();
+    static void mapPerFoam (Foams::iterator begin, Foams::iterator end,
+			    FoamParamMethod* foamMethods, size_t n);
+    vector<FoamParamMethod> getPreprocessMethods () const;
+    bool parseT1s (const char* arrayName, const char* countName,
+		   size_t begin, size_t end);
+    bool preprocessParsed (size_t begin, size_t end, bool* t1sParsed);
+    bool parsePreprocess (size_t begin, size_t end, bool* t1sParsed,
+			  bool debugParsing, bool debugScanning);
+    bool hasConstraintPointsToFix (size_t begin, size_t end) const;
+    vector<size_t> fixConstraintPoints (size_t begin, size_t end);
+    bool pushT1s (size_t begin, const vector< vector<T1> >& t1s,
+		  const vector<char>& t1sFound);
+    void releaseGeometry (size_t begin, size_t end);
+    void saveRegularGrids ();
+    void makeResident (size_t timeStep);
+    void unpin (size_t timeStep);
+    void assertResident (size_t timeStep) const;
+    void loadGeometry (const vector<size_t>& timeSteps);
+    static void getDmpFiles (const vector<string>& fileNames,
+			     QDir* dir, QStringList* files);
+    void storeFoams (size_t begin, size_t end);
+    static void storeFoams (const Foams& foams, StoredFoam* stored);
+    void shareTopology (size_t begin, size_t end);
     void adjustPressureSubtractReference ();
 
     void calculateBodyWraps ();
@@ -350,20 +538,24 @@ private:
 	pair< size_t, boost::shared_ptr<BodyAlongTime> > p);
     void calculateStatistics ();
     void calculateT1TypeCount ();
+    QStringList findNewDmpFiles ();
+    void appendT1s (const vector< vector<T1> >& t1s);
+    void appendVelocity (BodyAlongTime* bat, size_t timeStep);
+    bool alignAppendedPressures (size_t begin, size_t end);
+    void appendStatistics (size_t begin, size_t end, bool shifted);
+    void shareDataProperties (
+	size_t end, bool debugParsing, bool debugScanning);
+    void printParseThroughput (
+	const QDir& dir, const QStringList& files, qint64 elapsedMs) const;
     void storeVelocity (
 	const StripIteratorPoint& beforeBegin,
 	const StripIteratorPoint& begin,
 	const StripIteratorPoint& end,
 	const StripIteratorPoint& afterEnd);
-    
-    template <typename Accumulator>
-    void forAllBodiesAccumulateProperty (
-	Accumulator* acc, BodyScalar::Enum property);
-    template <typename Accumulator, typename GetBodyScalar>
-    void forAllBodiesAccumulate (
-	Accumulator* acc, GetBodyScalar getBodyScalar);
+
     void moveInsideOriginalDomain (
         T1* tc, const OOBox& originalDomain);
+    void moveT1sInsideOriginalDomain ();
 
 
 private:
@@ -384,9 +576,20 @@ private:
      */
     string m_name;
     vector<HistogramStatistics> m_histogramScalar;
+    MeanStatistics m_volumeStatistics;
     double m_meanVolume;
     bool m_pressureAdjusted;
-    vector< vector<T1> > m_t1;
+    /**
+     * Pressure medians of all time steps are aligned with this one
+     * (@see Preprocess)
+     */
+    double m_maxPressureMedian;
+    T1TimeSteps m_t1;
+    /**
+     * T1s are read from variables in the DMP files rather than from a
+     * separate file.
+     */
+    bool m_t1sInDmp;
     int m_t1Shift;
     DmpObjectInfo m_dmpObjectInfo;
     vector<ForceNamesOneObject> m_forceNames;
@@ -396,6 +599,79 @@ private:
     float m_maxDeformationEigenValue;
     size_t m_regularGridResolution;
     boost::array<size_t, T1Type::COUNT> m_t1TypeCount;
+    bool m_snapshotUsed;
+    bool m_dmpMemoryMapped;
+    bool m_dmpParallelSections;
+    bool m_elementArenaUsed;
+    vector<string> m_loadAttributes;
+    /**
+     * Directory and names of the DMP files, used to load time steps
+     * that are not resident.
+     */
+    QString m_dmpDir;
+    QStringList m_dmpFiles;
+    size_t m_residentTimeSteps;
+    size_t m_inFlightTimeSteps;
+    /**
+     * True if ParseDMPs ran the steps Preprocess applies to each
+     * time step.
+     */
+    bool m_foamsPreprocessed;
+    /**
+     * Time steps that have their geometry loaded, the most recently
+     * used last.
+     */
+    deque<size_t> m_residentQueue;
+    /**
+     * Number of pins for each pinned time step (@see Pin)
+     */
+    map<size_t, size_t> m_pinCount;
+    /**
+     * Guards m_residentQueue and m_pinCount. Shared so that Simulation
+     * can be stored in a vector (@see SimulationGroup).
+     */
+    boost::shared_ptr<QMutex> m_residentMutex;
+    bool m_topologyShared;
+    /**
+     * Time steps kept in memory if the topology is shared, indexed
+     * by time step.
+     */
+    vector<StoredFoam> m_storedFoams;
+    /**
+     * Sizes of the new DMP files seen by the previous call to
+     * AppendDMPs.
+     */
+    map<QString, qint64> m_newDmpSizes;
+    friend class TimeStepPin;
+};
+
+/**
+ * @brief Keeps the geometry of a time step in memory while it exists
+ *        (@see Simulation::Pin)
+ */
+class TimeStepPin
+{
+public:
+    TimeStepPin (Simulation* simulation, size_t timeStep) :
+	m_simulation (simulation), m_timeStep (timeStep)
+    {
+    }
+    ~TimeStepPin ()
+    {
+	m_simulation->unpin (m_timeStep);
+    }
+    size_t GetTimeStep () const
+    {
+	return m_timeStep;
+    }
+
+private:
+    TimeStepPin (const TimeStepPin&);
+    TimeStepPin& operator= (const TimeStepPin&);
+
+private:
+    Simulation* m_simulation;
+    size_t m_timeStep;
 };
 
 /**
@@ -430,6 +706,11 @@ public:
 	return m_simulation;
     }
     string ToString () const;
+    /**
+     * @return the memory used by each simulation and the peak resident
+     *         set size at the end of each loading phase
+     */
+    string GetMemoryInfo () const;
     float GetBubbleDiameter () const;    
     size_t GetIndex3DSimulation () const
     {
@@ -9,6 +9,7 @@
 #include "AverageShaders.h"
 #include "AverageCacheT1KDEVelocity.h"
 #include "Debug.h"
+#include "MemoryUsage.h"
 #include "Simulation.h"
 #include "WidgetGl.h"
 #include "OpenGLUtils.h"
@@ -155,6 +156,12 @@ void T1KDE2D::InitKernel ()
     m_kernel->release ();
 }
 
+void T1KDE2D::GetMemoryUsage (MemoryUsage* usage) const
+{
+    ScalarAverageTemplate<SetterNop>::GetMemoryUsage (usage);
+    usage->AddFramebuffer (m_kernel.get ());
+}
+
 void T1KDE2D::writeStepValues (ViewNumber::Enum viewNumber, size_t timeStep, 
 			      size_t subStep)
 {
@@ -42,6 +42,7 @@ public:
     void CacheData (
         boost::shared_ptr<AverageCacheT1KDEVelocity> averageCache) const;
     void InitKernel ();
+    virtual void GetMemoryUsage (MemoryUsage* usage) const;
 
 protected:
     virtual void writeStepValues (
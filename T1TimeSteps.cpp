@@ -0,0 +1,297 @@
+/**
+ * @file   T1TimeSteps.cpp
+ * @author Dan R. Lipsa
+ *
+ * Definitions for the T1TimeSteps class.
+ *
+ * The index is a native-endian binary file that is only meant to be
+ * read back on the machine that wrote it.
+ */
+
+#include "Debug.h"
+#include "Foam.h"
+#include "Simulation.h"
+#include "T1TimeSteps.h"
+#include "Utils.h"
+
+
+// Private Functions and constants
+// ======================================================================
+
+namespace
+{
+const char INDEX_MAGIC[] = "FOAMVIS T1 INDEX";
+/**
+ * Increment every time the layout of the index changes.
+ */
+const size_t INDEX_VERSION = 1;
+const size_t MAX_TOKEN = 64;
+
+template<typename T>
+void write (ostream& ostr, const T& value)
+{
+    ostr.write (reinterpret_cast<const char*> (&value), sizeof (value));
+}
+
+template<typename T>
+T read (istream& istr)
+{
+    T value;
+    istr.read (reinterpret_cast<char*> (&value), sizeof (value));
+    return value;
+}
+
+template<typename T>
+void writeVector (ostream& ostr, const vector<T>& v)
+{
+    write (ostr, v.size ());
+    if (! v.empty ())
+	ostr.write (reinterpret_cast<const char*> (&v[0]),
+		    v.size () * sizeof (T));
+}
+
+template<typename T>
+void readVector (istream& istr, vector<T>* v)
+{
+    v->resize (read<size_t> (istr));
+    if (! v->empty ())
+	istr.read (reinterpret_cast<char*> (&(*v)[0]), v->size () * sizeof (T));
+}
+
+qint64 getModificationTime (const QFileInfo& fi)
+{
+    return fi.lastModified ().toTime_t ();
+}
+
+/**
+ * Copies the next token on a line, delimited by spaces, in token.
+ * @return false if there are no more tokens on the line
+ */
+bool nextToken (const char** p, const char* lineEnd, char* token)
+{
+    const char* c = *p;
+    while (c < lineEnd && isspace (*c))
+	++c;
+    const char* begin = c;
+    while (c < lineEnd && ! isspace (*c))
+	++c;
+    size_t size = c - begin;
+    if (size == 0 || size >= MAX_TOKEN)
+	return false;
+    copy (begin, c, token);
+    token[size] = 0;
+    *p = c;
+    return true;
+}
+
+bool nextFloat (const char** p, const char* lineEnd, float* value)
+{
+    char token[MAX_TOKEN];
+    if (! nextToken (p, lineEnd, token))
+	return false;
+    char* tail;
+    *value = strtof (token, &tail);
+    return tail != token;
+}
+
+bool nextSize (const char** p, const char* lineEnd, size_t* value)
+{
+    char token[MAX_TOKEN];
+    if (! nextToken (p, lineEnd, token))
+	return false;
+    char* tail;
+    *value = strtoul (token, &tail, 10);
+    return tail != token;
+}
+} // namespace
+
+
+// Methods
+// ======================================================================
+
+T1TimeSteps::T1TimeSteps () :
+    m_offsets (1, 0)
+{
+}
+
+T1TimeSteps::ConstRange T1TimeSteps::Get (size_t timeStep) const
+{
+    if (timeStep >= GetTimeSteps ())
+	return ConstRange (m_t1s.end (), m_t1s.end ());
+    return ConstRange (m_t1s.begin () + m_offsets[timeStep],
+		       m_t1s.begin () + m_offsets[timeStep + 1]);
+}
+
+T1TimeSteps::Range T1TimeSteps::Get (size_t timeStep)
+{
+    if (timeStep >= GetTimeSteps ())
+	return Range (m_t1s.end (), m_t1s.end ());
+    return Range (m_t1s.begin () + m_offsets[timeStep],
+		  m_t1s.begin () + m_offsets[timeStep + 1]);
+}
+
+void T1TimeSteps::PushBack (const vector<T1>& t1s)
+{
+    m_t1s.insert (m_t1s.end (), t1s.begin (), t1s.end ());
+    m_offsets.push_back (m_t1s.size ());
+}
+
+void T1TimeSteps::Clear ()
+{
+    m_t1s.clear ();
+    m_offsets.assign (1, 0);
+}
+
+void T1TimeSteps::Read (const string& path, size_t ticksForTimeStep)
+{
+    QFile file (path.c_str ());
+    if (! file.open (QIODevice::ReadOnly))
+	ThrowException ("Cannot open \"" + path + "\"");
+    vector<T1> t1s;
+    vector<size_t> timeSteps;
+    const char* begin = (file.size () == 0) ? 0 :
+	reinterpret_cast<const char*> (file.map (0, file.size ()));
+    if (file.size () != 0 && begin == 0)
+	ThrowException ("Cannot map \"" + path + "\"");
+    const char* end = begin + file.size ();
+    // a line has at least 6 characters
+    t1s.reserve (file.size () / 32);
+    timeSteps.reserve (file.size () / 32);
+    const char* next;
+    for (const char* line = begin; line < end; line = next)
+    {
+	const char* lineEnd = static_cast<const char*> (
+	    memchr (line, '\n', end - line));
+	lineEnd = (lineEnd == 0) ? end : lineEnd;
+	next = lineEnd + 1;
+	const char* p = line;
+	float timeStep, x, y, z;
+	size_t type;
+	char token[MAX_TOKEN];
+	if (*p == '#' || ! nextToken (&p, lineEnd, token))
+	    // comments and empty lines
+	    continue;
+	char* tail;
+	timeStep = strtof (token, &tail);
+	RuntimeAssert (tail != token &&
+		       nextFloat (&p, lineEnd, &x) &&
+		       nextFloat (&p, lineEnd, &y),
+		       "Invalid topological changes file");
+	T1 tc;
+	if (nextFloat (&p, lineEnd, &z) && nextSize (&p, lineEnd, &type))
+	    tc = T1 (G3D::Vector3 (x, y, z), T1Type::FromSizeT (type - 1));
+	else
+	    tc = T1 (G3D::Vector3 (x, y, Foam::Z_COORDINATE_2D),
+		     T1Type::POP_VERTEX);
+	timeStep /= ticksForTimeStep;
+	// in the file: first time step is 1 and T1s occur before timeStep
+	// in memory: first time step is 0 and T1s occur after timeStep
+	timeStep -= 1;
+	RuntimeAssert (timeStep >= 0,
+		       "Invalid topological changes time step: ", timeStep);
+	t1s.push_back (tc);
+	timeSteps.push_back (size_t (timeStep));
+    }
+    if (begin != 0)
+	file.unmap (reinterpret_cast<uchar*> (const_cast<char*> (begin)));
+    build (&t1s, timeSteps);
+}
+
+void T1TimeSteps::build (vector<T1>* t1s, const vector<size_t>& timeSteps)
+{
+    size_t n = timeSteps.empty () ? 0 :
+	*max_element (timeSteps.begin (), timeSteps.end ()) + 1;
+    m_offsets.assign (n + 1, 0);
+    BOOST_FOREACH (size_t timeStep, timeSteps)
+	++m_offsets[timeStep + 1];
+    partial_sum (m_offsets.begin (), m_offsets.end (), m_offsets.begin ());
+    // T1 files are usually sorted by time step
+    if (adjacent_find (timeSteps.begin (), timeSteps.end (),
+		       greater<size_t> ()) == timeSteps.end ())
+    {
+	m_t1s.swap (*t1s);
+	return;
+    }
+    vector<size_t> position (m_offsets.begin (), m_offsets.end () - 1);
+    m_t1s.resize (t1s->size ());
+    for (size_t i = 0; i < t1s->size (); ++i)
+	m_t1s[position[timeSteps[i]]++] = (*t1s)[i];
+}
+
+string T1TimeSteps::getIndexPath (const string& path)
+{
+    string dir, file;
+    LastDirFile (path.c_str (), &dir, &file);
+    return Simulation::GetBaseCacheDir () + dir + "/" +
+	ChangeExtension (file, "t1i");
+}
+
+bool T1TimeSteps::ReadIndex (const string& path, size_t ticksForTimeStep)
+{
+    string indexPath = getIndexPath (path);
+    ifstream istr (indexPath.c_str (), ios::binary);
+    if (! istr)
+	return false;
+    QFileInfo fi (path.c_str ());
+    try
+    {
+	istr.exceptions (ios::failbit | ios::badbit | ios::eofbit);
+	char magic[sizeof (INDEX_MAGIC)];
+	istr.read (magic, sizeof (magic));
+	if (! (equal (magic, magic + sizeof (magic), INDEX_MAGIC) &&
+	       read<size_t> (istr) == INDEX_VERSION &&
+	       read<qint64> (istr) == fi.size () &&
+	       read<qint64> (istr) == getModificationTime (fi) &&
+	       read<size_t> (istr) == ticksForTimeStep &&
+	       read<size_t> (istr) == sizeof (T1)))
+	    return false;
+	vector<size_t> offsets;
+	vector<T1> t1s;
+	readVector (istr, &offsets);
+	readVector (istr, &t1s);
+	RuntimeAssert (! offsets.empty () && offsets[0] == 0 &&
+		       offsets.back () == t1s.size (), "Invalid offsets");
+	m_offsets.swap (offsets);
+	m_t1s.swap (t1s);
+	return true;
+    }
+    catch (const exception& e)
+    {
+	cdbg << "Invalid T1 index " << indexPath << ": " << e.what () << endl;
+	return false;
+    }
+}
+
+void T1TimeSteps::WriteIndex (
+    const string& path, size_t ticksForTimeStep) const
+{
+    string indexPath = getIndexPath (path);
+    string tmpPath = indexPath + ".tmp";
+    QFileInfo fi (path.c_str ());
+    try
+    {
+	QDir::root ().mkpath (QFileInfo (indexPath.c_str ()).absolutePath ());
+	{
+	    ofstream ostr (tmpPath.c_str (), ios::binary | ios::trunc);
+	    if (! ostr)
+		ThrowException ("Cannot open ", tmpPath);
+	    ostr.write (INDEX_MAGIC, sizeof (INDEX_MAGIC));
+	    write (ostr, INDEX_VERSION);
+	    write (ostr, fi.size ());
+	    write (ostr, getModificationTime (fi));
+	    write (ostr, ticksForTimeStep);
+	    write (ostr, sizeof (T1));
+	    writeVector (ostr, m_offsets);
+	    writeVector (ostr, m_t1s);
+	    if (! ostr)
+		ThrowException ("Error writing ", tmpPath);
+	}
+	if (rename (tmpPath.c_str (), indexPath.c_str ()) != 0)
+	    ThrowException ("Cannot rename ", tmpPath, " to ", indexPath);
+    }
+    catch (const exception& e)
+    {
+	cdbg << "T1 index not saved: " << e.what () << endl;
+	remove (tmpPath.c_str ());
+    }
+}
@@ -0,0 +1,105 @@
+/**
+ * @file T1TimeSteps.h
+ * @author Dan R. Lipsa
+ * @ingroup data model
+ * @brief Topological changes for all time steps of a simulation
+ */
+
+#ifndef __T1_TIME_STEPS_H__
+#define __T1_TIME_STEPS_H__
+
+#include "T1.h"
+
+/**
+ * @brief Topological changes for all time steps of a simulation
+ *
+ * T1s are stored in one array, sorted by time step, and the T1s for
+ * time step i are at positions [offset[i], offset[i + 1]) in the
+ * array (compressed sparse row). T1s read from a text file
+ * (@see sec_t1s_file) can be saved in a binary index next to the
+ * other cached files, which is read instead of the text file as long
+ * as the text file does not change.
+ */
+class T1TimeSteps
+{
+public:
+    typedef boost::iterator_range<vector<T1>::const_iterator> ConstRange;
+    typedef boost::iterator_range<vector<T1>::iterator> Range;
+
+public:
+    T1TimeSteps ();
+    size_t GetTimeSteps () const
+    {
+	return m_offsets.size () - 1;
+    }
+    bool IsEmpty () const
+    {
+	return GetTimeSteps () == 0;
+    }
+    /**
+     * @return the number of T1s for all time steps
+     */
+    size_t GetCount () const
+    {
+	return m_t1s.size ();
+    }
+    /**
+     * @return the T1s for timeStep or an empty range if there are
+     *         no T1s for it.
+     */
+    ConstRange Get (size_t timeStep) const;
+    Range Get (size_t timeStep);
+    /**
+     * @return the T1s for all time steps
+     */
+    const vector<T1>& GetAll () const
+    {
+	return m_t1s;
+    }
+    /**
+     * Adds a time step at the end
+     */
+    void PushBack (const vector<T1>& t1s);
+    void Clear ();
+    /**
+     * Reads T1s from a text file. The file is memory mapped and
+     * converted without going through streams.
+     * @param path text file
+     * @param ticksForTimeStep time steps in the file for one DMP file
+     */
+    void Read (const string& path, size_t ticksForTimeStep);
+    /**
+     * Reads the binary index written by WriteIndex
+     * @return true if a valid index was read for the current version of
+     *         the text file, false otherwise
+     */
+    bool ReadIndex (const string& path, size_t ticksForTimeStep);
+    void WriteIndex (const string& path, size_t ticksForTimeStep) const;
+    size_t GetMemorySize () const
+    {
+	return m_t1s.capacity () * sizeof (T1) + 
+	    m_offsets.capacity () * sizeof (size_t);
+    }
+
+private:
+    /**
+     * Sorts T1s by time step (counting sort) and computes the offsets.
+     * t1s may be left empty.
+     */
+    void build (vector<T1>* t1s, const vector<size_t>& timeSteps);
+    static string getIndexPath (const string& path);
+
+private:
+    vector<T1> m_t1s;
+    /**
+     * GetTimeSteps () + 1 offsets into m_t1s
+     */
+    vector<size_t> m_offsets;
+};
+
+
+#endif //__T1_TIME_STEPS_H__
+
+// Local Variables:
+// mode: c++
+// End:
@@ -0,0 +1,139 @@
+/**
+ * @file   TaskGraph.cpp
+ * @author Dan R. Lipsa
+ *
+ * Definitions for the TaskGraph class.
+ */
+
+#include "Debug.h"
+#include "TaskGraph.h"
+
+
+// Private Classes
+// ======================================================================
+
+class TaskGraph::Runnable : public QRunnable
+{
+public:
+    Runnable (TaskGraph* graph, Task task) :
+	m_graph (graph),
+	m_task (task)
+    {
+    }
+
+    virtual void run ()
+    {
+	m_graph->run (m_task);
+    }
+
+private:
+    TaskGraph* m_graph;
+    Task m_task;
+};
+
+
+// Methods
+// ======================================================================
+
+const TaskGraph::Task TaskGraph::NONE = numeric_limits<TaskGraph::Task>::max ();
+
+TaskGraph::TaskGraph () :
+    m_running (0)
+{
+}
+
+TaskGraph::Task TaskGraph::Add (
+    const char* name, Benchmark::Type type, const Function& f)
+{
+    TaskInfo info;
+    info.m_name = name;
+    info.m_type = type;
+    info.m_function = f;
+    info.m_beforeCount = 0;
+    m_tasks.push_back (info);
+    return m_tasks.size () - 1;
+}
+
+void TaskGraph::AddDependency (Task before, Task after)
+{
+    if (before == NONE)
+	return;
+    RuntimeAssert (before < m_tasks.size () && after < m_tasks.size (),
+		   "Invalid task: ", max (before, after));
+    m_tasks[before].m_after.push_back (after);
+    ++m_tasks[after].m_beforeCount;
+}
+
+void TaskGraph::Run ()
+{
+    assertNoCycles ();
+    QMutexLocker locker (&m_mutex);
+    for (Task task = 0; task < m_tasks.size (); ++task)
+	if (m_tasks[task].m_beforeCount == 0)
+	    start (task);
+    while (m_running != 0)
+	m_finished.wait (&m_mutex);
+    if (! m_error.empty ())
+	ThrowException (m_error);
+}
+
+/**
+ * Runs a topological sort on the counts of the tasks not finished.
+ */
+void TaskGraph::assertNoCycles () const
+{
+    vector<size_t> beforeCount (m_tasks.size ());
+    vector<Task> ready;
+    for (Task task = 0; task < m_tasks.size (); ++task)
+    {
+	beforeCount[task] = m_tasks[task].m_beforeCount;
+	if (beforeCount[task] == 0)
+	    ready.push_back (task);
+    }
+    size_t sorted = 0;
+    while (! ready.empty ())
+    {
+	Task task = ready.back ();
+	ready.pop_back ();
+	++sorted;
+	BOOST_FOREACH (Task after, m_tasks[task].m_after)
+	    if (--beforeCount[after] == 0)
+		ready.push_back (after);
+    }
+    RuntimeAssert (sorted == m_tasks.size (), 
+		   "TaskGraph: tasks depend on each other: ", 
+		   m_tasks.size () - sorted);
+}
+
+/**
+ * @pre m_mutex is locked
+ */
+void TaskGraph::start (Task task)
+{
+    ++m_running;
+    QThreadPool::globalInstance ()->start (new Runnable (this, task));
+}
+
+void TaskGraph::run (Task task)
+{
+    TaskInfo& info = m_tasks[task];
+    string error;
+    try
+    {
+	BenchmarkPhase phase (info.m_name, info.m_type);
+	info.m_function ();
+    }
+    catch (const exception& e)
+    {
+	error = string (info.m_name) + ": " + e.what ();
+    }
+    QMutexLocker locker (&m_mutex);
+    if (! error.empty () && m_error.empty ())
+	m_error = error;
+    if (m_error.empty ())
+	BOOST_FOREACH (Task after, info.m_after)
+	    if (--m_tasks[after].m_beforeCount == 0)
+		start (after);
+    if (--m_running == 0)
+	m_finished.wakeAll ();
+}
@@ -0,0 +1,96 @@
+/**
+ * @file   TaskGraph.h
+ * @author Dan R. Lipsa
+ * @brief Runs tasks on the global thread pool in the order given by
+ *        their dependencies.
+ * @ingroup utils
+ */
+
+#ifndef __TASK_GRAPH_H__
+#define __TASK_GRAPH_H__
+
+#include "Benchmark.h"
+
+/**
+ * @brief Runs tasks on the global thread pool in the order given by
+ *        their dependencies.
+ *
+ * A task starts as soon as all tasks it depends on are finished, so
+ * independent chains of tasks, for instance the steps applied to
+ * different time steps, do not wait for each other. Each task is
+ * recorded as a Benchmark phase with the name of the task, so the
+ * time spent in each step is reported with the other phases of the
+ * loading.
+ */
+class TaskGraph
+{
+public:
+    typedef boost::function<void ()> Function;
+    typedef size_t Task;
+
+public:
+    static const Task NONE;
+
+public:
+    TaskGraph ();
+    /**
+     * @param name of the Benchmark phase for the task. It is not
+     *        copied, so it has to be a string literal.
+     * @param type PER_TIME_STEP for a task added for each time step
+     * @return the task to be used in AddDependency
+     */
+    Task Add (const char* name, Benchmark::Type type, const Function& f);
+    /**
+     * Task after starts only after task before is finished. Does
+     * nothing if before is NONE, which stands for a task that was not
+     * added.
+     */
+    void AddDependency (Task before, Task after);
+    /**
+     * Runs all tasks and returns when all are finished. If a task
+     * throws, no other task is started and an exception with the same
+     * message is thrown when the running tasks are finished. A graph
+     * can be run only once.
+     */
+    void Run ();
+    size_t size () const
+    {
+	return m_tasks.size ();
+    }
+
+private:
+    struct TaskInfo
+    {
+	const char* m_name;
+	Benchmark::Type m_type;
+	Function m_function;
+	vector<Task> m_after;
+	/**
+	 * Tasks this task depends on that are not finished
+	 */
+	size_t m_beforeCount;
+    };
+    class Runnable;
+
+private:
+    void assertNoCycles () const;
+    void start (Task task);
+    void run (Task task);
+
+private:
+    vector<TaskInfo> m_tasks;
+    QMutex m_mutex;
+    QWaitCondition m_finished;
+    /**
+     * Tasks started and not finished
+     */
+    size_t m_running;
+    string m_error;
+};
+
+
+#endif //__TASK_GRAPH_H__
+
+// Local Variables:
+// mode: c++
+// End:
@@ -25,6 +25,7 @@ void TransferFunctionHistogram::contextMenuEvent(QContextMenuEvent *event)
     menu.addAction (m_actionClampHigh.get ());
     menu.addAction (m_actionClampLow.get ());
     menu.addAction (m_actionClampClear.get ());
+    menu.addAction (m_actionClampPercentiles.get ());
     menu.addAction (m_actionHeightSettings.get ());
     menu.exec (event->globalPos());
 }
@@ -55,6 +56,19 @@ void TransferFunctionHistogram::createActions ()
     m_actionClampClear->setStatusTip(tr("Clamp Clear"));
     connect(m_actionClampClear.get (), SIGNAL(triggered()),
 	    this, SLOT(ClampClearSlot ()));
+
+    m_actionClampPercentiles.reset (
+	new QAction (tr("Clamp &5% - 95%"), this));
+    m_actionClampPercentiles->setStatusTip(
+	tr("Clamp to the 5th and 95th percentiles of the current time step"));
+    m_actionClampPercentiles->setEnabled (false);
+    connect(m_actionClampPercentiles.get (), SIGNAL(triggered()),
+	    this, SLOT(ClampPercentilesSlot ()));
+}
+
+void TransferFunctionHistogram::SetClampPercentilesEnabled (bool enabled)
+{
+    m_actionClampPercentiles->setEnabled (enabled);
 }
 
 
@@ -75,3 +89,9 @@ void TransferFunctionHistogram::ClampClearSlot ()
     SetAllItemsSelection (true);
     Q_EMIT ClampClear ();
 }
+
+void TransferFunctionHistogram::ClampPercentilesSlot ()
+{
+    SetAllItemsSelection (true);
+    Q_EMIT ClampPercentiles ();
+}
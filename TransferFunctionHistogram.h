@@ -19,16 +19,22 @@ class TransferFunctionHistogram : public Histogram
 {
 public:
     TransferFunctionHistogram (QWidget* parent = 0);
+    /**
+     * Clamping to percentiles needs the values of the current time step
+     */
+    void SetClampPercentilesEnabled (bool enabled);
 
 Q_SIGNALS:
     void SetClampMax (double value);
     void SetClampMin (double value);
     void ClampClear ();
+    void ClampPercentiles ();
 
 public Q_SLOTS:
     void SetClampMax ();
     void SetClampMin ();
     void ClampClearSlot ();
+    void ClampPercentilesSlot ();
 
 
 protected:
@@ -44,6 +50,7 @@ private:
     boost::scoped_ptr<QAction> m_actionClampHigh;
     boost::scoped_ptr<QAction> m_actionClampLow;
     boost::scoped_ptr<QAction> m_actionClampClear;
+    boost::scoped_ptr<QAction> m_actionClampPercentiles;
     QwtDoublePoint m_pos;
 };
 
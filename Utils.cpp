@@ -581,7 +581,20 @@ void LastDirFile (const char* p, string* dir, string* file)
 
 string ChangeExtension (const string& path, const char* ext)
 {
+    // a compressed file (x.dmp.gz, x.dmp.zst) has the extension of the
+    // file before compression
     string extPath (path);
+    const char* compressed[] = {".gz", ".zst"};
+    BOOST_FOREACH (const char* c, compressed)
+    {
+	size_t n = strlen (c);
+	if (extPath.size () > n && 
+	    extPath.compare (extPath.size () - n, n, c) == 0)
+	{
+	    extPath.erase (extPath.size () - n);
+	    break;
+	}
+    }
     extPath.replace (extPath.size () - 3, 3, ext);
     return extPath;
 }
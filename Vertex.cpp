@@ -9,6 +9,7 @@
 #include "AttributeCreator.h"
 #include "Body.h"
 #include "Edge.h"
+#include "ElementArena.h"
 #include "Foam.h"
 #include "DataProperties.h"
 #include "EvolverData_yacc.h"
@@ -134,8 +135,7 @@ boost::shared_ptr<Vertex> Vertex::createDuplicate (
     const OOBox& periods,
     const G3D::Vector3int16& translation) const
 {
-    boost::shared_ptr<Vertex> duplicate = boost::make_shared<Vertex> (
-	*this);
+    boost::shared_ptr<Vertex> duplicate = MakeElement<Vertex> (*this);
     duplicate->SetDuplicateStatus (ElementStatus::DUPLICATE);
     duplicate->torusTranslate (periods, translation);
     return duplicate;
@@ -144,16 +144,15 @@ boost::shared_ptr<Vertex> Vertex::createDuplicate (
 boost::shared_ptr<Vertex> Vertex::GetDuplicate (
     const OOBox& originalDomain,
     const G3D::Vector3int16& translation,
-    VertexSet* vertexSet) const
+    VertexHashSet* vertexSet) const
 {
-    boost::shared_ptr<Vertex> searchDummy = boost::make_shared<Vertex>(
-	originalDomain.TorusTranslate (GetVector (), translation), GetId ());
-    VertexSet::iterator it = vertexSet->find (searchDummy);
-    if (it != vertexSet->end ())
-	return *it;
-    boost::shared_ptr<Vertex> duplicate = this->createDuplicate (
-	originalDomain, translation);
-    vertexSet->insert (duplicate);
+    boost::shared_ptr<Vertex> duplicate = vertexSet->Find (
+	GetId (), GetId (),
+	originalDomain.TorusTranslate (GetVector (), translation));
+    if (duplicate)
+	return duplicate;
+    duplicate = this->createDuplicate (originalDomain, translation);
+    vertexSet->Insert (duplicate);
     return duplicate;
 }
 
@@ -11,6 +11,7 @@
 
 #include "Element.h"
 #include "Comparisons.h"
+#include "ElementHashSet.h"
 
 class Body;
 class AttributesInfo;
@@ -60,8 +61,16 @@ public:
     boost::shared_ptr<Vertex> GetDuplicate (
 	const OOBox& originalDomain,
 	const G3D::Vector3int16& translation,
-	VertexSet* vertexSet) const;
+	VertexHashSet* vertexSet) const;
     bool fuzzyEq (const Vertex& other) const;
+    /**
+     * @return bytes used by this vertex, without its attributes
+     */
+    size_t GetMemorySize () const
+    {
+	return sizeof (Vertex) + 
+	    m_adjacentEdges.capacity () * sizeof (boost::shared_ptr<Edge>);
+    }
 
 private:
     class storeByDomain
@@ -119,6 +128,7 @@ private:
     boost::shared_ptr<Vertex> createDuplicate (
 	const OOBox& periods, const G3D::Vector3int16& translation) const;
     bool adjacentQuadraticEdge () const;
+    friend class FoamSnapshot;
 
 private:
     /**
@@ -536,6 +536,14 @@ void ViewSettings::SetSimulation (int i, const Simulation& simulation,
     SetBubblePathsTimeEnd (simulation.GetTimeSteps ());
 }
 
+void ViewSettings::AppendTimeSteps (const Simulation& simulation)
+{
+    // bubble paths that went to the last time step keep doing so
+    if (GetBubblePathsTimeEnd () == GetTimeSteps ())
+	SetBubblePathsTimeEnd (simulation.GetTimeSteps ());
+    setTimeSteps (simulation.GetTimeSteps ());
+}
+
 bool ViewSettings::HasHistogramOption (HistogramType::Option option) const
 {
     return m_histogramOptions.testFlag (option);
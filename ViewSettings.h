@@ -906,6 +906,11 @@ public:
 
     void SetSimulation (int i, const Simulation& simulation,
 			G3D::Vector3 viewingVolumeCenter);
+    /**
+     * Called after time steps were appended to the simulation shown
+     * (@see Simulation::AppendDMPs)
+     */
+    void AppendTimeSteps (const Simulation& simulation);
     string GetTitle (ViewNumber::Enum viewNumber) const;
     bool IsTorusDomainClipped () const
     {
@@ -6,10 +6,14 @@
  * Definitions for the widget for displaying foam bubbles
  */
 
+#include "AverageCacheT1KDEVelocity.h"
 #include "BodySelector.h"
 #include "ColorBarModel.h"
 #include "Debug.h"
+#include "DerivedData.h"
 #include "Foam.h"
+#include "Info.h"
+#include "MemoryUsage.h"
 #include "Settings.h"
 #include "Simulation.h"
 #include "Utils.h"
@@ -68,6 +72,10 @@ WidgetBase::WidgetBase (QWidget* widget,
     m_actionInfoSimulation = 
         boost::make_shared<QAction> (tr("&Simulation"), m_widget);
     m_actionInfoSimulation->setStatusTip(tr("Info simulation"));
+
+    m_actionInfoMemory = 
+        boost::make_shared<QAction> (tr("&Memory"), m_widget);
+    m_actionInfoMemory->setStatusTip(tr("Info memory"));
 }
 
 
@@ -350,3 +358,26 @@ void WidgetBase::infoSimulation ()
 {
     ShowMessageBox (m_widget, GetSimulation ().GetInfo ().c_str ());
 }
+
+void WidgetBase::infoMemory ()
+{
+    MemoryUsage views;
+    getMemoryUsage (&views);
+    // views may share the cache
+    set<const AverageCacheT1KDEVelocity*> caches;
+    for (size_t i = 0; i < ViewNumber::COUNT; ++i)
+    {
+	boost::shared_ptr<DerivedData> dd = GetDerivedDataAllPtr ()[i];
+	if (! dd || ! dd->m_averageCache ||
+	    ! caches.insert (dd->m_averageCache.get ()).second)
+	    continue;
+	views.AddRegularGrid (dd->m_averageCache->GetT1KDE ());
+	views.AddRegularGrid (dd->m_averageCache->GetVelocity ());
+    }
+    ostringstream ostr;
+    ostr << GetSimulationGroup ().GetMemoryInfo () << endl
+	 << "Views" << endl;
+    views.Print (ostr);
+    Info info (m_widget, "Memory Info", ostr.str ().c_str ());
+    info.exec ();
+}
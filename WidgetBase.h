@@ -17,6 +17,7 @@
 #include "Base.h"
 class ColorBarModel;
 class Foam;
+class MemoryUsage;
 class Settings;
 class Simulation;
 class SimulationGroup;
@@ -139,9 +140,19 @@ protected:
 	boost::shared_ptr<QSignalMapper>& signalMapperCopyTransform);
     void infoFoam ();
     void infoSimulation ();
+    /**
+     * Shows the memory used by the simulations and by the views
+     */
+    void infoMemory ();
 
     virtual void contextMenuEventView (QMenu* menu) const
     {(void)menu;}
+    /**
+     * Adds the textures and the regular grids used by the averages
+     * computed in the views
+     */
+    virtual void getMemoryUsage (MemoryUsage* usage) const
+    {(void)usage;}
     virtual void contextMenuEventColorMapScalar (QMenu* menu) const;
     virtual void contextMenuEventColorMapVelocity (QMenu* menu) const;
 
@@ -178,6 +189,7 @@ protected:
 
     boost::shared_ptr<QAction> m_actionInfoFoam;
     boost::shared_ptr<QAction> m_actionInfoSimulation;
+    boost::shared_ptr<QAction> m_actionInfoMemory;
 
 private:
     QWidget* m_widget;
@@ -205,7 +217,9 @@ private:
     connect(m_actionInfoFoam.get (), SIGNAL(triggered()), this,\
 	    SLOT(InfoFoam ()));\
     connect(m_actionInfoSimulation.get (), SIGNAL(triggered()), this,   \
-	    SLOT(InfoSimulation ()));
+	    SLOT(InfoSimulation ()));\
+    connect(m_actionInfoMemory.get (), SIGNAL(triggered()), this,\
+	    SLOT(InfoMemory ()));
 
 
 
@@ -2518,6 +2518,12 @@ void WidgetGl::quadricErrorCallback (GLenum errorCode)
     cdbg << "Quadric error:" << message << endl;
 }
 
+void WidgetGl::getMemoryUsage (MemoryUsage* usage) const
+{
+    for (size_t i = 0; i < ViewNumber::COUNT; ++i)
+	CALL_IF_NOT_NULL(m_average[i],GetMemoryUsage) (usage);
+}
+
 void WidgetGl::contextMenuEventView (QMenu* menu) const
 {
     ViewSettings& vs = GetViewSettings ();
@@ -2553,6 +2559,7 @@ void WidgetGl::contextMenuEventView (QMenu* menu) const
 	menuInfo->addAction (m_actionInfoBody.get ());
 	menuInfo->addAction (m_actionInfoFoam.get ());
 	menuInfo->addAction (m_actionInfoSimulation.get ());
+	menuInfo->addAction (m_actionInfoMemory.get ());
 	menuInfo->addAction (m_actionInfoOpenGL.get ());
 	menuInfo->addAction (m_actionInfoSelectedBodies.get ());
     }
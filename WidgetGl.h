@@ -304,6 +304,7 @@ public Q_SLOTS:
     void InfoBody ();
     void InfoFoam () {infoFoam ();}
     void InfoSimulation () {infoSimulation ();}
+    void InfoMemory () {infoMemory ();}
     void InfoOpenGL ();
     void InfoSelectedBodies ();
     void ShowNeighbors ();
@@ -408,6 +409,7 @@ private:
     bool linkedTimesValid (size_t timeBegin, size_t timeEnd);
     bool linkedTimesValid ();
     void contextMenuEventView (QMenu* menu) const;
+    virtual void getMemoryUsage (MemoryUsage* usage) const;
     void activateViewShader (
 	ViewNumber::Enum viewNumber, 
 	ViewingVolumeOperation::Enum enclose, G3D::Rect2D& srcRect,
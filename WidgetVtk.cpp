@@ -424,12 +424,19 @@ void WidgetVtk::mousePressEvent (QMouseEvent *event)
     setView (p);
 }
 
+void WidgetVtk::getMemoryUsage (MemoryUsage* usage) const
+{
+    for (size_t i = 0; i < ViewNumber::COUNT; ++i)
+	CALL_IF_NOT_NULL(m_average[i],GetMemoryUsage) (usage);
+}
+
 void WidgetVtk::contextMenuEventView (QMenu* menu) const
 {
     {
 	QMenu* menuInfo = menu->addMenu ("Info");
 	menuInfo->addAction (m_actionInfoFoam.get ());
 	menuInfo->addAction (m_actionInfoSimulation.get ());
+	menuInfo->addAction (m_actionInfoMemory.get ());
     }
     {
         QMenu* menuCopy = menu->addMenu ("Copy");
@@ -107,6 +107,7 @@ public Q_SLOTS:
     void FromView (ViewNumber::Enum viewNumber);
     void InfoFoam () {infoFoam ();}
     void InfoSimulation () {infoSimulation ();}
+    void InfoMemory () {infoMemory ();}
 
 
 protected:
@@ -114,6 +115,7 @@ protected:
     virtual void mousePressEvent (QMouseEvent *event);
     virtual void contextMenuEvent (QContextMenuEvent *);
     virtual void contextMenuEventView (QMenu* menu) const;
+    virtual void getMemoryUsage (MemoryUsage* usage) const;
 
 private:
     void updateViewTitle (ViewNumber::Enum viewNumber);
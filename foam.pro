@@ -1,68 +1,68 @@
 HEADERS += Application.h ApproximationEdge.h AdjacentOrientedFace.h \
-        Attribute.h AttributeAverages.h AttributeCreator.h AttributeInfo.h \
+        Attribute.h AttributeAverages.h AttributeCreator.h AttributeInfo.h AttributeValues.h \
         AttributeAverages2D.h AttributeAverages3D.h \
         AttributeHistogram.h Average.h AverageInterface.h\
         AverageShaders.h AverageCacheT1KDEVelocity.h PipelineAverage3D.h \
-        Base.h Body.h BrowseSimulations.h\
+        Base.h Benchmark.h Body.h BrowseSimulations.h\
         BodyAlongTime.h AdjacentBody.h BodySelector.h \
         ConstraintEdge.h ColorBarModel.h Comparisons.h\
-        Debug.h DerivedData.h \
+        Debug.h DerivedData.h DmpDecompressor.h \
         Disk.h ImageBasedAverage.h ForceAverage.h\
         DisplayBodyFunctors.h DisplayElement.h\
         DisplayFaceFunctors.h \
         DisplayEdgeFunctors.h DisplayElement.h WidgetSave.h\
-        EditColorMap.h Edge.h Element.h ExpressionTree.h \
-        Enums.h Foam.h FoamvisInteractorStyle.h \
+        EditColorMap.h Edge.h Element.h ElementArena.h ElementHashSet.h ExpressionTree.h \
+        Enums.h Foam.h FoamArrays.h FoamSnapshot.h FoamvisInteractorStyle.h \
         DataProperties.h Face.h ForceOneObject.h\
         WidgetBase.h WidgetGl.h WidgetHistogram.h WidgetVtk.h \
         Hashes.h Histogram.h HistogramItem.h HistogramSettings.h\
         HistogramStatistics.h Labels.h ListViewSignal.h\
-        LineEditFocus.h MainWindow.h NameSemanticValue.h \
+        LineEditFocus.h MainWindow.h MemoryUsage.h NameSemanticValue.h \
         OOBox.h Info.h ObjectPosition.h OpenGLUtils.h OrientedElement.h\
         OrientedEdge.h OrientedFace.h Options.h \
         ParsingData.h ParsingDriver.h \
-        Settings.h SelectBodiesById.h ScalarAverage.h ShaderProgram.h\
+        Settings.h SectionParser.h SelectBodiesById.h ScalarAverage.h ShaderProgram.h\
         ParsingEnums.h PipelineBase.h \
         ProcessBodyTorus.h PropertySetter.h \
         QuadraticEdge.h RegularGridAverage.h\
         RestrictedRangeSlider.h Simulation.h\
         stable.h StripIterator.h SystemDifferences.h ScalarDisplay.h \
-        T1KDE2D.h T1.h TensorAverage.h TransferFunctionHistogram.h \
+        T1KDE2D.h T1.h T1TimeSteps.h TaskGraph.h TensorAverage.h TransferFunctionHistogram.h \
         TimeStepsSlider.h Utils.h VectorAverage.h \
         Vertex.h  VectorOperation.h ViewSettings.h
 SOURCES += Application.cpp ApproximationEdge.cpp\
-        Attribute.cpp AttributeCreator.cpp AttributeInfo.cpp \
+        Attribute.cpp AttributeCreator.cpp AttributeInfo.cpp AttributeValues.cpp \
         AttributeAverages.cpp AttributeAverages2D.cpp AttributeAverages3D.cpp \
         AttributeHistogram.cpp Average.cpp AverageShaders.cpp \
         AdjacentBody.cpp PipelineAverage3D.cpp \
-        Base.cpp Body.cpp BodyAlongTime.cpp \
+        Base.cpp Benchmark.cpp Body.cpp BodyAlongTime.cpp \
         BodySelector.cpp BrowseSimulations.cpp \
         ConstraintEdge.cpp ColorBarModel.cpp Comparisons.cpp \
         DataProperties.cpp \
-        Debug.cpp Disk.cpp DisplayBodyFunctors.cpp DisplayElement.cpp\
+        Debug.cpp Disk.cpp DmpDecompressor.cpp DisplayBodyFunctors.cpp DisplayElement.cpp\
         ImageBasedAverage.cpp DisplayFaceFunctors.cpp \
         DisplayEdgeFunctors.cpp Edge.cpp \
         HistogramStatistics.cpp\
-        EditColorMap.cpp Element.cpp ExpressionTree.cpp \
-        Enums.cpp Foam.cpp FoamvisInteractorStyle.cpp\
+        EditColorMap.cpp Element.cpp ElementArena.cpp ElementHashSet.cpp ExpressionTree.cpp \
+        Enums.cpp Foam.cpp FoamArrays.cpp FoamSnapshot.cpp FoamvisInteractorStyle.cpp\
         Face.cpp ForceOneObject.cpp\
         ForceAverage.cpp \
         WidgetBase.cpp WidgetGl.cpp WidgetHistogram.cpp \
         WidgetSave.cpp WidgetVtk.cpp \
         Histogram.cpp HistogramItem.cpp \
-        HistogramSettings.cpp main.cpp MainWindow.cpp  \
+        HistogramSettings.cpp main.cpp MainWindow.cpp MemoryUsage.cpp \
         NameSemanticValue.cpp \
         OOBox.cpp ObjectPosition.cpp OpenGLUtils.cpp \
         OrientedElement.cpp Options.cpp \
         OrientedEdge.cpp OrientedFace.cpp AdjacentOrientedFace.cpp\
-        ScalarAverage.cpp Settings.cpp SelectBodiesById.cpp \
+        ScalarAverage.cpp SectionParser.cpp Settings.cpp SelectBodiesById.cpp \
         ParsingData.cpp PipelineBase.cpp ParsingDriver.cpp \
         ParsingEnums.cpp ProcessBodyTorus.cpp \
         PropertySetter.cpp ShaderProgram.cpp\
         QuadraticEdge.cpp RegularGridAverage.cpp\
         RestrictedRangeSlider.cpp Simulation.cpp\
         StripIterator.cpp ScalarDisplay.cpp T1KDE2D.cpp TimeStepsSlider.cpp \
-        T1.cpp TransferFunctionHistogram.cpp TensorAverage.cpp \
+        T1.cpp T1TimeSteps.cpp TaskGraph.cpp TransferFunctionHistogram.cpp TensorAverage.cpp \
         Utils.cpp VectorAverage.cpp Vertex.cpp \
         ViewSettings.cpp VectorOperation.cpp
 FORMS += BrowseSimulations.ui SelectBodiesById.ui EditColorMap.ui \
@@ -126,6 +126,7 @@ LIBS += "-lG3D"
 
 LIBS += "-ljpeg"
 LIBS += "-lz"
+LIBS += "-lzstd"
 LIBS += "-lzip"
 LIBS += "-lavformat"
 LIBS += "-lavcodec"
@@ -192,6 +193,7 @@ LIBS += "-lavcodec"
 LIBS += "-lavutil"
 LIBS += "-ldl"
 LIBS += "-lz"
+LIBS += "-lzstd"
 LIBS += "-lpng12"
 LIBS += "-lX11"
 
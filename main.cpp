@@ -76,6 +76,7 @@
 
 
 #include "Application.h"
+#include "Benchmark.h"
 #include "BrowseSimulations.h"
 #include "Options.h"
 #include "Debug.h"
@@ -136,12 +137,19 @@ void readOptions (int argc, char *argv[],
 
 void parseOptions (
     int argc, char *argv[], 
-    boost::shared_ptr<SimulationGroup> simulationGroup, bool* outputText)
+    boost::shared_ptr<SimulationGroup> simulationGroup, bool* outputText,
+    bool* follow)
 {
     CommandLineOptions clo;
     vector< boost::shared_ptr<CommonOptions> > co;
     readOptions (argc, argv, &clo, &co);
     size_t simulationsCount = co.size ();
+    bool benchmark = clo.m_vm.count (Option::m_name[Option::BENCHMARK]);
+    bool benchmarkScanner = 
+	clo.m_vm.count (Option::m_name[Option::BENCHMARK_SCANNER]);
+    Benchmark::Get ().SetEnabled (benchmark || benchmarkScanner);
+    Benchmark::Get ().SetMemoryReported (
+	clo.m_vm.count (Option::m_name[Option::OUTPUT_TEXT]));
     simulationGroup->SetSize (simulationsCount);
     for (size_t i = 0; i < simulationsCount; ++i)
     {
@@ -149,6 +157,42 @@ void parseOptions (
         simulation.SetBoundingBoxAllTimeSteps (co[i]->m_simulationBoundingBoxAllTimeSteps);
 	if (co[i]->m_vm.count (Option::m_name[Option::RESOLUTION]))
 	    simulation.SetRegularGridResolution (co[i]->m_resolution);
+	simulation.SetSnapshotUsed (
+	    ! benchmark &&
+	    ! clo.m_vm.count (Option::m_name[Option::NO_SNAPSHOT]));
+	simulation.SetDmpMemoryMapped (
+	    ! clo.m_vm.count (Option::m_name[Option::NO_MMAP]));
+	simulation.SetDmpParallelSections (
+	    ! clo.m_vm.count (Option::m_name[Option::NO_PARALLEL_SECTIONS]));
+	simulation.SetElementArenaUsed (
+	    clo.m_vm.count (Option::m_name[Option::ELEMENT_ARENA]));
+	simulation.SetLoadAttributes (co[i]->m_loadAttributes);
+	simulation.SetTopologyShared (
+	    clo.m_vm.count (Option::m_name[Option::SHARE_TOPOLOGY]));
+	if (clo.m_vm.count (Option::m_name[Option::RESIDENT_TIME_STEPS]))
+	    simulation.SetResidentTimeSteps (
+		clo.m_vm[Option::m_name[Option::RESIDENT_TIME_STEPS]].
+		as<size_t> ());
+	else if (simulation.IsTopologyShared ())
+	    // time steps are rebuilt from memory, so a few are enough
+	    simulation.SetResidentTimeSteps (8);
+	if (clo.m_vm.count (Option::m_name[Option::IN_FLIGHT_TIME_STEPS]))
+	    simulation.SetInFlightTimeSteps (
+		clo.m_vm[Option::m_name[Option::IN_FLIGHT_TIME_STEPS]].
+		as<size_t> ());
+	string simulationName = clo.m_names.empty () ?
+	    LastDirFile (co[0]->m_fileNames[0].c_str ()) : 
+            clo.m_names[clo.m_simulationIndexes[i]];
+	if (benchmarkScanner)
+	{
+	    Simulation::ScanDMPs (
+		co[i]->m_fileNames,
+		co[i]->m_vm.count (Option::m_name[Option::USE_ORIGINAL]),
+		co[i]->m_dmpObjectInfo, co[i]->m_forceNames);
+	    Benchmark::Get ().AddSimulation (
+		simulationName, co[i]->m_fileNames.size ());
+	    continue;
+	}
 	if (co[i]->m_vm.count (Option::m_name[Option::T1S]))
 	    simulation.ParseT1s (
 		co[i]->m_t1sFile, co[i]->m_ticksForTimeStep,
@@ -159,9 +203,6 @@ void parseOptions (
 	    co[i]->m_dmpObjectInfo, co[i]->m_forceNames,
 	    clo.m_vm.count (Option::m_name[Option::DEBUG_PARSING]), 
 	    clo.m_vm.count (Option::m_name[Option::DEBUG_SCANNING]));
-	string simulationName = clo.m_names.empty () ?
-	    LastDirFile (co[0]->m_fileNames[0].c_str ()) : 
-            clo.m_names[clo.m_simulationIndexes[i]];
 	simulation.SetName (simulationName);
 	simulation.SetRotation2D (co[i]->m_rotation2D);
 	simulation.SetReflectionAxis (co[i]->m_reflectionAxis);
@@ -175,8 +216,11 @@ void parseOptions (
 	simulation.SetPressureAdjusted (
 	    ! co[i]->m_vm.count (Option::m_name[Option::ORIGINAL_PRESSURE]));
 	simulation.Preprocess ();
+	Benchmark::Get ().AddSimulation (
+	    simulationName, simulation.GetTimeSteps ());
     }
     *outputText = clo.m_vm.count (Option::m_name[Option::OUTPUT_TEXT]);
+    *follow = clo.m_vm.count (Option::m_name[Option::FOLLOW]);
 }
 
 
@@ -195,17 +239,22 @@ int main(int argc, char *argv[])
 
     boost::shared_ptr<Application> app = Application::Get (argc, argv);
     bool outputText;
+    bool follow;
     try
     {
         boost::shared_ptr<SimulationGroup> simulationGroup (
             new SimulationGroup ());
-	parseOptions (argc, argv, simulationGroup, &outputText);
-	if (outputText)
-	    cdbg << simulationGroup;
+	parseOptions (argc, argv, simulationGroup, &outputText, &follow);
+	if (Benchmark::Get ().IsEnabled ())
+	    cout << Benchmark::Get ().ToJson () << endl;
+	else if (outputText)
+	    cdbg << simulationGroup << simulationGroup->GetMemoryInfo ();
 	else
 	{
 	    int result;
 	    MainWindow window (simulationGroup);
+	    if (follow)
+		window.Follow (simulationGroup);
 	    window.show();
 	    result = app->exec();
 	    app->release ();
@@ -14,10 +14,25 @@
 #ifdef __cplusplus
 
 // standard C headers
+#include <cstdio>
 #include <cstring>
 #include <ctime>
 #include <cerrno>
 #include <unistd.h>
+#ifndef _MSC_VER
+#include <csignal>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#endif //_MSC_VER
+
+// compression headers
+#include <zlib.h>
+#ifndef _MSC_VER
+#include <zstd.h>
+#endif //_MSC_VER
 
 // GSL headers
 #include <gsl/gsl_vector.h>
@@ -31,6 +46,7 @@
 #include <numeric>
 #include <stdexcept>
 #include <functional>
+#include <fstream>
 #include <iostream>
 #include <map>
 #include <set>
@@ -38,6 +54,7 @@
 #include <string>
 #include <vector>
 #include <queue>
+#include <deque>
 #include <iomanip>
 #include <bitset>
 
@@ -68,6 +85,7 @@
 #include <boost/program_options/variables_map.hpp>
 #include <boost/program_options/parsers.hpp>
 #include <boost/tokenizer.hpp>
+#include <boost/range/iterator_range.hpp>
 #include <boost/math/special_functions/fpclassify.hpp>
 
 // required by GLG3D
@@ -77,6 +95,13 @@
 #include <QtGui/QApplication>
 #include <QtOpenGL/QtOpenGL>
 #include <QtCore/QtConcurrentMap>
+#include <QtCore/QAtomicInt>
+#include <QtCore/QMutex>
+#include <QtCore/QRunnable>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <QtCore/QThreadStorage>
+#include <QtCore/QWaitCondition>
 #include <QtCore/QtDebug>
 #include <qglfunctions.h>
 
@@ -53,6 +53,8 @@ my @tests =
 
 sub main ()
 {
+    # extra arguments are passed to foam, for instance --benchmark
+    my $extra = join (" ", @ARGV);
     my $foam;
     if ($ENV{'OSTYPE'} eq "darwin10.0")
     {
@@ -67,14 +69,15 @@ sub main ()
     foreach (@tests)
     {
 	my ($test,$params) = @{$_};
-	my $args = $foam . " " . $params . " " . $location . $test;
-	print "$args\n";
+	my $args = $foam . " " . $extra . " " . $params . " " .
+	    $location . $test;
+	print STDERR "$args\n";
 	if (system($args) != 0)
 	{
 	    warn "system $args failed: $?";
 	    last TESTS;
 	}
-	print "\n"
+	print STDERR "\n"
     }
 }
 